@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+#include "audio_mixer.h"
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using Format = AudioDecoderBase::Format;
+
+// Samples per buffer of a typical 44.1 kHz stereo output
+constexpr int frames = 4096;
+constexpr int num_se = 16;
+
+std::vector<int16_t> MakeS16(int count) {
+	std::vector<int16_t> samples(count);
+	for (int i = 0; i < count; ++i) {
+		samples[i] = static_cast<int16_t>((i * 7919) % 65536 - 32768);
+	}
+	return samples;
+}
+
+// Per sample loop of the previous GenericAudio::Decode implementation for comparison
+void MixS16Reference(float* dst, const int16_t* src, int frames, int channels, float vleft, float vright) {
+	for (int i = 0; i < frames; ++i) {
+		float vall = vleft * (src[i * channels] / 32768.0);
+		float valr = vright * (src[i * channels + 1] / 32768.0);
+		dst[i * 2] += vall;
+		if (channels > 1) {
+			dst[i * 2 + 1] += valr;
+		} else {
+			dst[i * 2 + 1] = dst[i * 2];
+		}
+	}
+}
+
+void ToS16Reference(int16_t* dst, const float* src, int count, float total_volume) {
+	if (total_volume > 1.0) {
+		float threshold = 0.8f;
+		for (int i = 0; i < count; i++) {
+			float sample = src[i];
+			float sign = (sample < 0) ? -1.0 : 1.0;
+			sample /= sign;
+			if (sample > threshold) {
+				dst[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
+			} else {
+				dst[i] = sign * sample * 32768.0;
+			}
+		}
+	} else {
+		for (int i = 0; i < count; i++) {
+			dst[i] = src[i] * 32768.0;
+		}
+	}
+}
+
+}
+
+static void BM_ToFloatS16(benchmark::State& state) {
+	auto src = MakeS16(frames * 2);
+	std::vector<float> dst(frames * 2);
+	for (auto _: state) {
+		AudioMixer::ToFloat(dst.data(), src.data(), Format::S16, frames * 2);
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+BENCHMARK(BM_ToFloatS16);
+
+static void BM_MixStereo(benchmark::State& state) {
+	std::vector<float> src(frames * 2, 0.25f);
+	std::vector<float> dst(frames * 2, 0.0f);
+	for (auto _: state) {
+		AudioMixer::MixStereo(dst.data(), src.data(), frames, 2, { 0.5f, 0.75f }, { 0.75f, 0.5f });
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+BENCHMARK(BM_MixStereo);
+
+static void BM_MixMono(benchmark::State& state) {
+	std::vector<float> src(frames, 0.25f);
+	std::vector<float> dst(frames * 2, 0.0f);
+	for (auto _: state) {
+		AudioMixer::MixStereo(dst.data(), src.data(), frames, 1, { 0.5f, 0.75f }, { 0.75f, 0.5f });
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+BENCHMARK(BM_MixMono);
+
+static void BM_ToS16(benchmark::State& state) {
+	std::vector<float> src(frames * 2);
+	for (int i = 0; i < frames * 2; ++i) {
+		src[i] = (i % 200 - 100) / 100.0f;
+	}
+	std::vector<int16_t> dst(frames * 2);
+	const float total_volume = state.range(0) ? 2.0f : 1.0f;
+	for (auto _: state) {
+		AudioMixer::ToS16(dst.data(), src.data(), frames * 2, total_volume);
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+BENCHMARK(BM_ToS16)->Arg(0)->Arg(1);
+
+static void BM_ToS16Reference(benchmark::State& state) {
+	std::vector<float> src(frames * 2);
+	for (int i = 0; i < frames * 2; ++i) {
+		src[i] = (i % 200 - 100) / 100.0f;
+	}
+	std::vector<int16_t> dst(frames * 2);
+	const float total_volume = state.range(0) ? 2.0f : 1.0f;
+	for (auto _: state) {
+		ToS16Reference(dst.data(), src.data(), frames * 2, total_volume);
+		benchmark::DoNotOptimize(dst.data());
+	}
+}
+
+BENCHMARK(BM_ToS16Reference)->Arg(0)->Arg(1);
+
+// Full buffer with one BGM and several SE channels
+static void BM_MixChannels(benchmark::State& state) {
+	auto src = MakeS16(frames * 2);
+	std::vector<float> convert(frames * 2);
+	std::vector<float> mixer(frames * 2);
+	std::vector<int16_t> out(frames * 2);
+	for (auto _: state) {
+		std::fill(mixer.begin(), mixer.end(), 0.0f);
+		for (int i = 0; i < num_se + 1; ++i) {
+			AudioMixer::ToFloat(convert.data(), src.data(), Format::S16, frames * 2);
+			AudioMixer::MixStereo(mixer.data(), convert.data(), frames, 2, { 0.1f, 0.1f }, { 0.1f, 0.1f });
+		}
+		AudioMixer::ToS16(out.data(), mixer.data(), frames * 2, 1.7f);
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_MixChannels);
+
+static void BM_MixChannelsReference(benchmark::State& state) {
+	auto src = MakeS16(frames * 2);
+	std::vector<float> mixer(frames * 2);
+	std::vector<int16_t> out(frames * 2);
+	for (auto _: state) {
+		std::fill(mixer.begin(), mixer.end(), 0.0f);
+		for (int i = 0; i < num_se + 1; ++i) {
+			MixS16Reference(mixer.data(), src.data(), frames, 2, 0.1f, 0.1f);
+		}
+		ToS16Reference(out.data(), mixer.data(), frames * 2, 1.7f);
+		benchmark::DoNotOptimize(out.data());
+	}
+}
+
+BENCHMARK(BM_MixChannelsReference);
+
+BENCHMARK_MAIN();
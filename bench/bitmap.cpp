@@ -4,6 +4,8 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <bitmap_kernels.h>
+#include <vector>
 
 constexpr auto opacity_100 = Opacity::Opaque();
 constexpr auto opacity_0 = Opacity(0);
@@ -277,6 +279,56 @@ static void BM_ToneBlit(benchmark::State& state) {
 
 BENCHMARK(BM_ToneBlit);
 
+// Source bitmap with the opacity class given by the benchmark argument
+// 0: Opaque, 1: 1 bit alpha, 2: 8 bit alpha
+static BitmapRef CreateToneSource(int opacity_class) {
+	auto src = Bitmap::Create(320, 240);
+	src->Fill(Color(200, 120, 40, opacity_class == 2 ? 160 : 255));
+	if (opacity_class == 1) {
+		src->ClearRect(Rect(0, 0, 160, 240));
+	}
+	src->CheckPixels(Bitmap::Flag_ReadOnly);
+	return src;
+}
+
+static void BM_ToneBlitFormat(benchmark::State& state) {
+	Bitmap::SetFormat(formats[state.range(0)]);
+	auto dest = Bitmap::Create(320, 240);
+	auto src = CreateToneSource(state.range(1));
+	auto rect = src->GetRect();
+	auto tone = Tone(state.range(2) ? 64 : 128, 96, 160, state.range(2) ? 64 : 128);
+	for (auto _: state) {
+		dest->ToneBlit(0, 0, *src, rect, tone, opacity);
+	}
+	state.SetBytesProcessed(state.iterations() * rect.width * rect.height * 4);
+}
+
+// format, opacity class, with saturation
+BENCHMARK(BM_ToneBlitFormat)->ArgsProduct({{0, 1, 2, 3}, {0, 1, 2}, {0, 1}});
+
+template <bool Scalar>
+static void BM_ToneKernel(benchmark::State& state) {
+	const BitmapKernels::ToneTable table(Tone(64, 96, 160, 64));
+	const BitmapKernels::ChannelShifts shifts = { 0, 8, 16, 24 };
+	const auto image_opacity = static_cast<ImageOpacity>(state.range(0));
+	std::vector<uint32_t> pixels(320 * 240);
+	for (size_t i = 0; i < pixels.size(); ++i) {
+		pixels[i] = static_cast<uint32_t>(i * 2654435761u);
+	}
+	for (auto _: state) {
+		if (Scalar) {
+			BitmapKernels::ApplyToneScalar(pixels.data(), 320, 320, 240, table, image_opacity, shifts);
+		} else {
+			BitmapKernels::ApplyTone(pixels.data(), 320, 320, 240, table, image_opacity, shifts);
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetBytesProcessed(state.iterations() * pixels.size() * 4);
+}
+
+BENCHMARK_TEMPLATE(BM_ToneKernel, true)->Arg(static_cast<int>(ImageOpacity::Alpha_8Bit))->Arg(static_cast<int>(ImageOpacity::Opaque));
+BENCHMARK_TEMPLATE(BM_ToneKernel, false)->Arg(static_cast<int>(ImageOpacity::Alpha_8Bit))->Arg(static_cast<int>(ImageOpacity::Opaque));
+
 static void BM_BlendBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -4,6 +4,10 @@
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <filefinder.h>
+#include <text.h>
+#include <utils.h>
+#include <cstdlib>
 
 const std::string text = "Alex landed a critical hit on Slime!";
 char32_t symbol = '\\';
@@ -53,4 +57,143 @@ static void BM_Render(benchmark::State& state) {
 
 BENCHMARK(BM_Render);
 
+// FreeType benchmarks: The font is loaded from the path in the EP_BENCH_FONT environment variable
+// The "Uncached" variants disable the glyph cache and the shaping cache
+static FontRef LoadFtFont(benchmark::State& state) {
+	static FontRef font;
+	if (!font) {
+		const char* path = std::getenv("EP_BENCH_FONT");
+		if (path) {
+			font = Font::CreateFtFont(FileFinder::Root().OpenInputStream(path), 12, false, false);
+		}
+	}
+	if (!font) {
+		state.SkipWithError("EP_BENCH_FONT does not point to a font");
+	}
+	return font;
+}
+
+class FontCacheScope {
+public:
+	explicit FontCacheScope(bool enabled) {
+		if (!enabled) {
+			Font::SetGlyphCacheLimit(0);
+			Font::SetShapeCacheLimit(0);
+		}
+	}
+
+	~FontCacheScope() {
+		Font::SetGlyphCacheLimit(glyph_limit);
+		Font::SetShapeCacheLimit(shape_limit);
+	}
+
+private:
+	size_t glyph_limit = Font::GetGlyphCacheLimit();
+	size_t shape_limit = Font::GetShapeCacheLimit();
+};
+
+static void FtSizeStrWrap(benchmark::State& state, bool cached) {
+	FontCacheScope scope(cached);
+	auto font = LoadFtFont(state);
+	if (!font) {
+		return;
+	}
+	for (auto _: state) {
+		auto rect = Text::GetSize(*font, text);
+		(void)rect;
+	}
+}
+
+static void BM_FtSizeStr(benchmark::State& state) {
+	FtSizeStrWrap(state, true);
+}
+
+BENCHMARK(BM_FtSizeStr);
+
+static void BM_FtSizeStrUncached(benchmark::State& state) {
+	FtSizeStrWrap(state, false);
+}
+
+BENCHMARK(BM_FtSizeStrUncached);
+
+static void FtvRenderWrap(benchmark::State& state, bool cached) {
+	FontCacheScope scope(cached);
+	auto font = LoadFtFont(state);
+	if (!font) {
+		return;
+	}
+	for (auto _: state) {
+		auto bm = font->vRender(symbol);
+		(void)bm;
+	}
+}
+
+static void BM_FtvRender(benchmark::State& state) {
+	FtvRenderWrap(state, true);
+}
+
+BENCHMARK(BM_FtvRender);
+
+static void BM_FtvRenderUncached(benchmark::State& state) {
+	FtvRenderWrap(state, false);
+}
+
+BENCHMARK(BM_FtvRenderUncached);
+
+static void FtRenderWrap(benchmark::State& state, bool cached) {
+	FontCacheScope scope(cached);
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	auto font = LoadFtFont(state);
+	if (!font) {
+		return;
+	}
+	for (auto _: state) {
+		font->Render(*surface, 0, 0, *system, 0, symbol);
+	}
+}
+
+static void BM_FtRender(benchmark::State& state) {
+	FtRenderWrap(state, true);
+}
+
+BENCHMARK(BM_FtRender);
+
+static void BM_FtRenderUncached(benchmark::State& state) {
+	FtRenderWrap(state, false);
+}
+
+BENCHMARK(BM_FtRenderUncached);
+
+static void FtShapeWrap(benchmark::State& state, bool cached) {
+	FontCacheScope scope(cached);
+	auto font = LoadFtFont(state);
+	if (!font) {
+		return;
+	}
+	if (!font->CanShape()) {
+		state.SkipWithError("Font does not support shaping");
+		return;
+	}
+	auto text32 = Utils::DecodeUTF32(text);
+	for (auto _: state) {
+		auto shape = font->Shape(text32);
+		(void)shape;
+	}
+}
+
+static void BM_FtShape(benchmark::State& state) {
+	FtShapeWrap(state, true);
+}
+
+BENCHMARK(BM_FtShape);
+
+static void BM_FtShapeUncached(benchmark::State& state) {
+	FtShapeWrap(state, false);
+}
+
+BENCHMARK(BM_FtShapeUncached);
+
 BENCHMARK_MAIN();
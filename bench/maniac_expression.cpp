@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include "game_interpreter_shared.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "maniac_expression.h"
+#include <lcf/data.h>
+#include <lcf/rpg/saveeventexecstate.h>
+#include <memory>
+#include <vector>
+
+namespace {
+
+enum : uint8_t {
+	U8 = 1,
+	U16 = 2,
+	Var = 8,
+	Switch = 9,
+	VarIndirect = 13,
+	Add = 48,
+	Sub = 49,
+	Mul = 50,
+	Div = 51,
+	Mod = 52,
+	BitAnd = 54,
+	GreaterEqual = 59,
+	Less = 62,
+	And = 65,
+	Ternary = 72,
+	Function = 78
+};
+
+constexpr uint8_t FnMin = 12;
+constexpr uint8_t FnMax = 13;
+constexpr uint8_t FnClamp = 15;
+constexpr uint8_t FnMuldiv = 16;
+
+class Context : public Game_BaseInterpreterContext {
+public:
+	int GetThisEventId() const override { return 0; }
+	Game_Character* GetCharacter(int, std::string_view) const override { return nullptr; }
+	const lcf::rpg::SaveEventExecState& GetState() const override { return state; }
+	const lcf::rpg::SaveEventExecFrame& GetFrame() const override { return frame; }
+
+private:
+	lcf::rpg::SaveEventExecState state;
+	lcf::rpg::SaveEventExecFrame frame;
+};
+
+std::vector<int32_t> Encode(const std::vector<uint8_t>& bytes) {
+	std::vector<int32_t> op_codes((bytes.size() + 3) / 4);
+	for (size_t i = 0; i < bytes.size(); ++i) {
+		op_codes[i / 4] = static_cast<int32_t>(static_cast<uint32_t>(op_codes[i / 4]) | (static_cast<uint32_t>(bytes[i]) << ((i % 4) * 8)));
+	}
+	return op_codes;
+}
+
+// Expressions as found in Maniac Patch games
+std::vector<std::vector<int32_t>> MakeCorpus() {
+	return {
+		// Damage formula: v[10] * 4 - v[11] * 2
+		Encode({Sub, Mul, Var, U8, 10, U8, 4, Mul, Var, U8, 11, U8, 2}),
+		// HUD bar width: muldiv(v[20], 96, v[21]), args stored last to first
+		Encode({Function, FnMuldiv, 3, Var, U8, 21, U8, 96, Var, U8, 20}),
+		// Tile position: (v[30] / 16) + (v[31] / 16) * 20
+		Encode({Add, Div, Var, U8, 30, U8, 16, Mul, Div, Var, U8, 31, U8, 16, U8, 20}),
+		// State check: s[5] && v[40] >= 3 ? v[41] : v[42]
+		Encode({Ternary, And, Switch, U8, 5, GreaterEqual, Var, U8, 40, U8, 3, Var, U8, 41, Var, U8, 42}),
+		// Clamped stat: clamp(v[50] + v[51], 0, 999)
+		Encode({Function, FnClamp, 3, U16, 0xE7, 0x03, U8, 0, Add, Var, U8, 50, Var, U8, 51}),
+		// Animation frame: (v[v[61]] / 4) % 3 & 0xFF
+		Encode({BitAnd, Mod, Div, VarIndirect, U8, 61, U8, 4, U8, 3, U16, 0xFF, 0}),
+		// Distance: max(v[70] - v[72], v[72] - v[70]) + min(v[71] - v[73], v[73] - v[71]) < 5
+		Encode({Less, Add,
+			Function, FnMax, 2, Sub, Var, U8, 72, Var, U8, 70, Sub, Var, U8, 70, Var, U8, 72,
+			Function, FnMin, 2, Sub, Var, U8, 73, Var, U8, 71, Sub, Var, U8, 71, Var, U8, 73,
+			U8, 5}),
+		// Constant lookup: 60 * 60 * 24
+		Encode({Mul, Mul, U8, 60, U8, 60, U8, 24}),
+	};
+}
+
+void Setup() {
+	lcf::Data::variables.resize(128);
+	lcf::Data::switches.resize(128);
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	for (int i = 1; i <= 128; ++i) {
+		Main_Data::game_variables->Set(i, i * 7 % 100);
+	}
+	Main_Data::game_switches->Set(5, true);
+}
+
+}
+
+static void BM_ManiacExpressionInterpret(benchmark::State& state) {
+	Setup();
+	const Context ctx;
+	const auto corpus = MakeCorpus();
+	for (auto _: state) {
+		for (const auto& op_codes: corpus) {
+			benchmark::DoNotOptimize(ManiacExpression::Interpret(op_codes, ctx));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK(BM_ManiacExpressionInterpret);
+
+static void BM_ManiacExpressionCompiled(benchmark::State& state) {
+	Setup();
+	const Context ctx;
+	const auto corpus = MakeCorpus();
+	for (auto _: state) {
+		for (const auto& op_codes: corpus) {
+			benchmark::DoNotOptimize(ManiacExpression::Get(op_codes).Evaluate(ctx));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * corpus.size());
+	ManiacExpression::ClearCache();
+}
+
+BENCHMARK(BM_ManiacExpressionCompiled);
+
+static void BM_ManiacExpressionCompile(benchmark::State& state) {
+	const auto corpus = MakeCorpus();
+	for (auto _: state) {
+		for (const auto& op_codes: corpus) {
+			ManiacExpression expr(op_codes);
+			benchmark::DoNotOptimize(expr.GetNumInstructions());
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * corpus.size());
+}
+
+BENCHMARK(BM_ManiacExpressionCompile);
+
+BENCHMARK_MAIN();
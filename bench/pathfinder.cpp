@@ -0,0 +1,126 @@
+#include <benchmark/benchmark.h>
+#include "pathfinder.h"
+#include <vector>
+
+namespace {
+
+struct BenchMap {
+	int width = 0;
+	int height = 0;
+	bool loop = false;
+	std::vector<char> walls;
+
+	bool IsFree(int x, int y) const {
+		if (loop) {
+			x = (x + width) % width;
+			y = (y + height) % height;
+		}
+		if (x < 0 || x >= width || y < 0 || y >= height) {
+			return false;
+		}
+		return !walls[y * width + x];
+	}
+};
+
+BenchMap MakeOpen(int size) {
+	BenchMap map;
+	map.width = size;
+	map.height = size;
+	map.walls.resize(size * size, 0);
+	return map;
+}
+
+// Serpentine corridors: every second column is a wall with a gap alternating at the top and bottom
+BenchMap MakeMaze(int size) {
+	BenchMap map = MakeOpen(size);
+	for (int x = 1; x < size; x += 2) {
+		const int gap = (x / 2) % 2 == 0 ? size - 1 : 0;
+		for (int y = 0; y < size; ++y) {
+			if (y != gap) {
+				map.walls[y * size + x] = 1;
+			}
+		}
+	}
+	return map;
+}
+
+// Wall in the middle of the map, the way around goes over the map border
+BenchMap MakeLooping(int size) {
+	BenchMap map = MakeOpen(size);
+	map.loop = true;
+	for (int y = 0; y < size; ++y) {
+		map.walls[y * size + size / 2] = 1;
+	}
+	return map;
+}
+
+void RunSearch(benchmark::State& state, const BenchMap& map, int start_x, int start_y, int dest_x, int dest_y, bool diagonal) {
+	Pathfinder pf;
+	Pathfinder::Grid grid;
+	grid.width = map.width;
+	grid.height = map.height;
+	grid.loop_horizontal = map.loop;
+	grid.loop_vertical = map.loop;
+
+	Pathfinder::Query q;
+	q.start_x = start_x;
+	q.start_y = start_y;
+	q.dest_x = dest_x;
+	q.dest_y = dest_y;
+	q.allow_diagonal = diagonal;
+
+	auto can_move = [&](int, int, int to_x, int to_y) { return map.IsFree(to_x, to_y); };
+	auto can_enter_dest = [](int, int, int, int) { return false; };
+
+	std::vector<Pathfinder::Step> route;
+	for (auto _: state) {
+		pf.Search(grid, q, can_move, can_enter_dest);
+		pf.BuildRoute(map.width * map.height, route);
+		benchmark::DoNotOptimize(route.data());
+	}
+	state.counters["expanded"] = pf.GetExpandedNodes();
+	state.counters["route"] = static_cast<double>(route.size());
+}
+
+}
+
+static void BM_PathOpen(benchmark::State& state) {
+	const int size = state.range(0);
+	RunSearch(state, MakeOpen(size), 0, 0, size - 1, size - 1, false);
+}
+
+BENCHMARK(BM_PathOpen)->Arg(20)->Arg(100)->Arg(500);
+
+static void BM_PathOpenDiagonal(benchmark::State& state) {
+	const int size = state.range(0);
+	RunSearch(state, MakeOpen(size), 0, 0, size - 1, size - 1, true);
+}
+
+BENCHMARK(BM_PathOpenDiagonal)->Arg(20)->Arg(100)->Arg(500);
+
+static void BM_PathMaze(benchmark::State& state) {
+	const int size = state.range(0);
+	RunSearch(state, MakeMaze(size), 0, 0, size - 1, 0, false);
+}
+
+BENCHMARK(BM_PathMaze)->Arg(20)->Arg(100)->Arg(500);
+
+static void BM_PathLooping(benchmark::State& state) {
+	const int size = state.range(0);
+	RunSearch(state, MakeLooping(size), size / 2 - 1, size / 2, size / 2 + 1, size / 2, false);
+}
+
+BENCHMARK(BM_PathLooping)->Arg(20)->Arg(100)->Arg(500);
+
+static void BM_PathUnreachable(benchmark::State& state) {
+	const int size = state.range(0);
+	auto map = MakeOpen(size);
+	// Wall off the destination
+	map.walls[(size - 2) * size + (size - 1)] = 1;
+	map.walls[(size - 1) * size + (size - 2)] = 1;
+	RunSearch(state, map, 0, 0, size - 1, size - 1, false);
+}
+
+BENCHMARK(BM_PathUnreachable)->Arg(20)->Arg(100)->Arg(500);
+
+BENCHMARK_MAIN();
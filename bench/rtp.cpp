@@ -2,6 +2,7 @@
 #include "filefinder_rtp.h"
 #include "output.h"
 #include "player.h"
+#include "rtp.h"
 
 static void BM_InitRtp2k(benchmark::State& state) {
 	Output::SetLogLevel(LogLevel::Error);
@@ -35,4 +36,67 @@ static void BM_InitRtp2k3(benchmark::State& state) {
 
 BENCHMARK(BM_InitRtp2k3);
 
+// Linear scan over the table, how the lookup worked before the index
+static std::vector<RTP::Type> LinearLookupAnyToRtp2k3(std::string_view src_category, std::string_view src_name) {
+	std::vector<RTP::Type> type_hits;
+
+	for (int i = 0; RTP::rtp_table_2k3_categories[i] != nullptr; ++i) {
+		if (src_category != RTP::rtp_table_2k3_categories[i]) {
+			continue;
+		}
+		for (int row = RTP::rtp_table_2k3_categories_idx[i]; row < RTP::rtp_table_2k3_categories_idx[i + 1]; ++row) {
+			for (int j = 1; j <= RTP::num_2k3_rtps; ++j) {
+				const char* name = RTP::rtp_table_2k3[row][j];
+				if (name != nullptr && src_name == name) {
+					type_hits.push_back((RTP::Type)(j - 1 + RTP::num_2k_rtps));
+				}
+			}
+		}
+	}
+
+	return type_hits;
+}
+
+// The last entries of a category are the worst case for a linear scan
+static constexpr std::string_view lookup_category = "sound";
+static constexpr std::string_view lookup_name = "magic2";
+
+static void BM_LookupAnyToRtpLinear(benchmark::State& state) {
+	for (auto _: state) {
+		auto hits = LinearLookupAnyToRtp2k3(lookup_category, lookup_name);
+		benchmark::DoNotOptimize(hits);
+	}
+}
+
+BENCHMARK(BM_LookupAnyToRtpLinear);
+
+static void BM_LookupAnyToRtp(benchmark::State& state) {
+	for (auto _: state) {
+		auto hits = RTP::LookupAnyToRtp(lookup_category, lookup_name, 2003);
+		benchmark::DoNotOptimize(hits);
+	}
+}
+
+BENCHMARK(BM_LookupAnyToRtp);
+
+static void BM_LookupRtpToRtp(benchmark::State& state) {
+	bool is_rtp_asset = false;
+	for (auto _: state) {
+		auto name = RTP::LookupRtpToRtp(lookup_category, lookup_name,
+			RTP::Type::RPG2003_OfficialEnglish, RTP::Type::RPG2003_OfficialJapanese, &is_rtp_asset);
+		benchmark::DoNotOptimize(name);
+	}
+}
+
+BENCHMARK(BM_LookupRtpToRtp);
+
+static void BM_LookupAnyToRtpMiss(benchmark::State& state) {
+	for (auto _: state) {
+		auto hits = RTP::LookupAnyToRtp(lookup_category, "not_an_rtp_asset", 2003);
+		benchmark::DoNotOptimize(hits);
+	}
+}
+
+BENCHMARK(BM_LookupAnyToRtpMiss);
+
 BENCHMARK_MAIN();
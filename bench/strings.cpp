@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include "game_strings.h"
+#include "utils.h"
+#include <regex>
+#include <string>
+#include <vector>
+
+static constexpr const char* ascii_line = "Alex: Level 12, HP 348/420, MP 36/80";
+static constexpr const char* unicode_line = "アレックス: レベル 12, HP 348/420, MP 36/80";
+static constexpr const char* number_pattern = "[0-9]+";
+
+// Constructs the regex on every call like Game_Strings did before the cache
+static void BM_RegExReplaceUncached(benchmark::State& state) {
+	for (auto _: state) {
+		auto wstr = Utils::ToWideString(ascii_line);
+		std::wregex rexp(Utils::ToWideString(number_pattern));
+		auto result = Utils::FromWideString(std::regex_replace(wstr, rexp, Utils::ToWideString("#")));
+		benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK(BM_RegExReplaceUncached);
+
+static void BM_RegExReplace(benchmark::State& state) {
+	for (auto _: state) {
+		auto result = Game_Strings::RegExReplace(ascii_line, number_pattern, "#");
+		benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK(BM_RegExReplace);
+
+static void BM_RegExReplaceUnicode(benchmark::State& state) {
+	for (auto _: state) {
+		auto result = Game_Strings::RegExReplace(unicode_line, number_pattern, "#");
+		benchmark::DoNotOptimize(result);
+	}
+}
+
+BENCHMARK(BM_RegExReplaceUnicode);
+
+// Tokenizes the line like a game splitting a dialogue file
+static void BM_RegExMatchTokenize(benchmark::State& state) {
+	const std::string line = ascii_line;
+	std::string match;
+	for (auto _: state) {
+		size_t pos = 0;
+		while (pos < line.size()) {
+			int found = Game_Strings::RegExMatch(std::string_view(line).substr(pos), number_pattern, match);
+			if (match.empty()) {
+				break;
+			}
+			pos += found + match.size();
+		}
+		benchmark::DoNotOptimize(pos);
+	}
+}
+
+BENCHMARK(BM_RegExMatchTokenize);
+
+// Cycles through more patterns than the cache can hold
+static void BM_RegExMatchManyPatterns(benchmark::State& state) {
+	std::vector<std::string> patterns;
+	for (int i = 0; i < 64; ++i) {
+		patterns.push_back("[0-9]{" + std::to_string(i % 3 + 1) + "}" + std::string(i / 3, 'x') + "?");
+	}
+	std::string match;
+	size_t i = 0;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(Game_Strings::RegExMatch(ascii_line, patterns[i], match));
+		i = (i + 1) % patterns.size();
+	}
+}
+
+BENCHMARK(BM_RegExMatchManyPatterns);
+
+BENCHMARK_MAIN();
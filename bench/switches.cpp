@@ -64,5 +64,29 @@ static void BM_SwitchFlipRange(benchmark::State& state) {
 
 BENCHMARK(BM_SwitchFlipRange);
 
+static void BM_SwitchSetRangeUnaligned(benchmark::State& state) {
+	BM_SwitchOp(state, [](auto& s, auto, bool val) { s.SetRange(3, max_sws - 5, val); });
+}
+
+BENCHMARK(BM_SwitchSetRangeUnaligned);
+
+// Baseline: The same work as SetRange with single switch operations
+static void BM_SwitchSetRangeScalar(benchmark::State& state) {
+	BM_SwitchOp(state, [](auto& s, auto, bool val) {
+		for (int i = 1; i <= max_sws; ++i) {
+			s.Set(i, val);
+		}
+	});
+}
+
+BENCHMARK(BM_SwitchSetRangeScalar);
+
+static void BM_SwitchCountRange(benchmark::State& state) {
+	volatile int x = 0;
+	BM_SwitchOp(state, [&x](auto& s, auto id, bool) { s.Flip(id); x = s.CountRange(1, max_sws); });
+}
+
+BENCHMARK(BM_SwitchCountRange);
+
 
 BENCHMARK_MAIN();
@@ -5,6 +5,8 @@
 #include <text.h>
 #include <pixel_format.h>
 #include <cache.h>
+#include <filefinder.h>
+#include <cstdlib>
 
 const std::string text = "Alex $A landed a critical hit on Slime $B!";
 char32_t symbol = '\\';
@@ -81,4 +83,55 @@ static void BM_TextDrawCharColorEx(benchmark::State& state) {
 
 BENCHMARK(BM_TextDrawCharColorEx);
 
+// FreeType benchmarks: The font is loaded from the path in the EP_BENCH_FONT environment variable
+// The "Uncached" variants disable the glyph cache and the shaping cache
+static FontRef LoadFtFont(benchmark::State& state) {
+	static FontRef font;
+	if (!font) {
+		const char* path = std::getenv("EP_BENCH_FONT");
+		if (path) {
+			font = Font::CreateFtFont(FileFinder::Root().OpenInputStream(path), 12, false, false);
+		}
+	}
+	if (!font) {
+		state.SkipWithError("EP_BENCH_FONT does not point to a font");
+	}
+	return font;
+}
+
+void DrawStrFtWrap(benchmark::State& state, bool cached) {
+	const size_t glyph_limit = Font::GetGlyphCacheLimit();
+	const size_t shape_limit = Font::GetShapeCacheLimit();
+	if (!cached) {
+		Font::SetGlyphCacheLimit(0);
+		Font::SetShapeCacheLimit(0);
+	}
+
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SysBlack();
+
+	auto font = LoadFtFont(state);
+	if (font) {
+		for (auto _: state) {
+			Text::Draw(*surface, 0, 0, *font, *system, 0, text, Text::AlignLeft);
+		}
+	}
+
+	Font::SetGlyphCacheLimit(glyph_limit);
+	Font::SetShapeCacheLimit(shape_limit);
+}
+
+static void BM_TextDrawStrFt(benchmark::State& state) {
+	DrawStrFtWrap(state, true);
+}
+
+BENCHMARK(BM_TextDrawStrFt);
+
+static void BM_TextDrawStrFtUncached(benchmark::State& state) {
+	DrawStrFtWrap(state, false);
+}
+
+BENCHMARK(BM_TextDrawStrFtUncached);
+
 BENCHMARK_MAIN();
@@ -106,12 +106,47 @@ static void BM_VariableModRange(benchmark::State& state) {
 
 BENCHMARK(BM_VariableModRange);
 
+static void BM_VariableBitOrRange(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) { v.BitOrRange(1, max_vars, val); });
+}
+
+BENCHMARK(BM_VariableBitOrRange);
+
+static void BM_VariableBitShiftLeftRange(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) { v.BitShiftLeftRange(1, max_vars, val % 4); });
+}
+
+BENCHMARK(BM_VariableBitShiftLeftRange);
+
+static void BM_VariableAddRangeUnaligned(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) { v.AddRange(2, max_vars - 2, val); });
+}
+
+BENCHMARK(BM_VariableAddRangeUnaligned);
+
+// Baseline: The same work as AddRange with single variable operations
+static void BM_VariableAddRangeScalar(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) {
+		for (int i = 1; i <= max_vars; ++i) {
+			v.Add(i, val);
+		}
+	});
+}
+
+BENCHMARK(BM_VariableAddRangeScalar);
+
 static void BM_VariableSetRangeVariable(benchmark::State& state) {
 	BM_VariableOp(state, [](auto& v, auto, auto val) { v.SetRangeVariable(1, max_vars, val); });
 }
 
 BENCHMARK(BM_VariableSetRangeVariable);
 
+static void BM_VariableAddRangeVariable(benchmark::State& state) {
+	BM_VariableOp(state, [](auto& v, auto, auto val) { v.AddRangeVariable(1, max_vars, val); });
+}
+
+BENCHMARK(BM_VariableAddRangeVariable);
+
 static void BM_VariableSetRangeVariableIndirect(benchmark::State& state) {
 	BM_VariableOp(state, [](auto& v, auto, auto val) { v.SetRangeVariableIndirect(1, max_vars, val); });
 }
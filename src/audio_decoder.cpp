@@ -22,6 +22,7 @@
 #include <cstring>
 #include "audio_decoder.h"
 #include "audio_decoder_base.h"
+#include "audio_decoder_prefetch.h"
 #include "audio_midi.h"
 #include "audio_resampler.h"
 #include "output.h"
@@ -53,17 +54,24 @@ private:
 };
 const char wma_magic[] = { (char)0x30, (char)0x26, (char)0xB2, (char)0x75 };
 
-std::unique_ptr<AudioDecoderBase> AudioDecoder::Create(Filesystem_Stream::InputStream& stream, bool resample) {
+std::unique_ptr<AudioDecoderBase> AudioDecoder::Create(Filesystem_Stream::InputStream& stream, bool resample, AudioPrefetchThread* prefetch) {
 	char magic[4] = { 0 };
 	if (!stream.ReadIntoObj(magic)) {
 		return nullptr;
 	}
 	stream.seekg(0, std::ios::beg);
 
-	auto add_resampler = [resample](std::unique_ptr<AudioDecoder> dec) -> std::unique_ptr<AudioDecoderBase> {
+	auto add_resampler = [resample, prefetch](std::unique_ptr<AudioDecoder> dec) -> std::unique_ptr<AudioDecoderBase> {
 #ifdef USE_AUDIO_RESAMPLER
-		if (resample)
+		if (resample) {
+			// Prefetching below the resampler keeps pitch changes sample accurate
+			if (prefetch) {
+				dec = std::make_unique<AudioDecoderPrefetch>(std::move(dec), *prefetch);
+			}
 			return std::make_unique<AudioResampler>(std::move(dec));
+		}
+#else
+		(void)prefetch;
 #endif
 		return dec;
 	};
@@ -21,6 +21,8 @@
 // Headers
 #include "audio_decoder_base.h"
 
+class AudioPrefetchThread;
+
 /**
  * The AudioDecoder class provides an abstraction over the decoding of
  * common audio formats.
@@ -40,9 +42,10 @@ public:
 	 *
 	 * @param stream handle to parse
 	 * @param resample Whether the decoder shall be wrapped into a resampler (if supported)
+	 * @param prefetch When set, sample based decoders that are resampled decode ahead on this thread
 	 * @return An audio decoder instance when the format was detected, otherwise null
 	 */
-	static std::unique_ptr<AudioDecoderBase> Create(Filesystem_Stream::InputStream& stream, bool resample = true);
+	static std::unique_ptr<AudioDecoderBase> Create(Filesystem_Stream::InputStream& stream, bool resample = true, AudioPrefetchThread* prefetch = nullptr);
 
 	/**
 	 * Returns the amount of bytes per sample.
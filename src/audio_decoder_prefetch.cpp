@@ -0,0 +1,355 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "audio_decoder_prefetch.h"
+#include "output.h"
+#include <algorithm>
+#include <cstring>
+
+using namespace std::chrono_literals;
+
+namespace {
+	struct Block {
+		std::vector<uint8_t> data = std::vector<uint8_t>(AudioDecoderPrefetch::block_size);
+		/** Bytes in data or -1 on error */
+		int size = 0;
+		/** Position of the wrapped decoder at the start and the end of the block */
+		int ticks = 0;
+		int end_ticks = 0;
+		std::streamoff position = -1;
+		std::streamoff end_position = -1;
+		/** Loop count at the end of the block */
+		int loop_count = 0;
+		/** Last block of the stream */
+		bool end = false;
+	};
+}
+
+/**
+ * State shared between the decoder and the prefetch thread.
+ * The thread keeps it alive until the wrapped decoder is destroyed.
+ */
+struct AudioDecoderPrefetch::Stream {
+	/** Protects decoder and the producer side of the ring */
+	std::mutex mutex;
+	std::unique_ptr<AudioDecoder> decoder;
+	std::string error;
+
+	Block blocks[num_blocks];
+	/** Ever increasing block counters, the ring is empty when they are equal */
+	std::atomic<unsigned> read_index = 0;
+	std::atomic<unsigned> write_index = 0;
+	/** Set when the end block was written, the producer stops */
+	bool end_written = false;
+
+	/** Set by the first FillBuffer, decoding ahead starts afterwards */
+	std::atomic<bool> started = false;
+	std::atomic<bool> released = false;
+	std::atomic<int> underruns = 0;
+
+	/** @return whether a block was decoded */
+	bool Produce();
+	void DecodeBlock();
+	void Flush();
+};
+
+bool AudioDecoderPrefetch::Stream::Produce() {
+	std::lock_guard<std::mutex> lock(mutex);
+
+	if (end_written || write_index.load(std::memory_order_relaxed) - read_index.load(std::memory_order_acquire) >= num_blocks) {
+		return false;
+	}
+
+	DecodeBlock();
+	return true;
+}
+
+void AudioDecoderPrefetch::Stream::DecodeBlock() {
+	unsigned w = write_index.load(std::memory_order_relaxed);
+	Block& block = blocks[w % num_blocks];
+
+	int frequency, channels;
+	Format format;
+	decoder->GetFormat(frequency, format, channels);
+	int frame_size = GetSamplesizeForFormat(format) * channels;
+
+	block.ticks = decoder->GetTicks();
+	block.position = decoder->Tell();
+	block.size = decoder->Decode(block.data.data(), block_size - block_size % frame_size);
+	block.end_ticks = decoder->GetTicks();
+	block.end_position = decoder->Tell();
+	block.loop_count = decoder->GetLoopCount();
+	block.end = decoder->IsFinished();
+
+	if (block.size <= 0 && !block.end) {
+		// Matches the mixer which discards a channel that returns no data
+		block.size = -1;
+		error = decoder->GetError();
+	}
+	end_written = block.end || block.size < 0;
+
+	write_index.store(w + 1, std::memory_order_release);
+}
+
+void AudioDecoderPrefetch::Stream::Flush() {
+	read_index.store(0, std::memory_order_relaxed);
+	write_index.store(0, std::memory_order_relaxed);
+	end_written = false;
+}
+
+AudioDecoderPrefetch::AudioDecoderPrefetch(std::unique_ptr<AudioDecoder> decoder, AudioPrefetchThread& thread)
+	: stream(std::make_shared<Stream>()), thread(thread) {
+	music_type = decoder->GetType();
+	stream->decoder = std::move(decoder);
+	thread.Add(stream);
+}
+
+AudioDecoderPrefetch::~AudioDecoderPrefetch() {
+	// Usually called by the audio callback, the thread frees the memory
+	stream->released.store(true);
+	thread.Wake();
+}
+
+bool AudioDecoderPrefetch::Open(Filesystem_Stream::InputStream filestream) {
+	std::lock_guard<std::mutex> lock(stream->mutex);
+
+	if (!stream->decoder->Open(std::move(filestream))) {
+		error_message = stream->decoder->GetError();
+		return false;
+	}
+
+	ticks = stream->decoder->GetTicks();
+	position = stream->decoder->Tell();
+	return true;
+}
+
+bool AudioDecoderPrefetch::Seek(std::streamoff offset, std::ios_base::seekdir origin) {
+	std::lock_guard<std::mutex> lock(stream->mutex);
+
+	// The wrapped decoder is ahead of the playback position
+	if (origin == std::ios_base::cur) {
+		if (position < 0) {
+			return false;
+		}
+		offset += position;
+		origin = std::ios_base::beg;
+	}
+
+	if (!stream->decoder->Seek(offset, origin)) {
+		return false;
+	}
+
+	stream->Flush();
+	read_offset = 0;
+	finished = false;
+	primed = false;
+	ticks = stream->decoder->GetTicks();
+	position = stream->decoder->Tell();
+	return true;
+}
+
+bool AudioDecoderPrefetch::IsFinished() const {
+	return finished;
+}
+
+void AudioDecoderPrefetch::GetFormat(int& frequency, Format& format, int& channels) const {
+	// The format is only changed by SetFormat while the thread is locked out
+	stream->decoder->GetFormat(frequency, format, channels);
+}
+
+bool AudioDecoderPrefetch::SetFormat(int frequency, Format format, int channels) {
+	std::lock_guard<std::mutex> lock(stream->mutex);
+
+	bool result = stream->decoder->SetFormat(frequency, format, channels);
+	stream->Flush();
+	read_offset = 0;
+	primed = false;
+	return result;
+}
+
+bool AudioDecoderPrefetch::GetLooping() const {
+	return stream->decoder->GetLooping();
+}
+
+void AudioDecoderPrefetch::SetLooping(bool enable) {
+	// Looping is done by the wrapped decoder, the looping flag of this decoder stays false
+	std::lock_guard<std::mutex> lock(stream->mutex);
+	stream->decoder->SetLooping(enable);
+}
+
+int AudioDecoderPrefetch::GetLoopCount() const {
+	return loop_count;
+}
+
+std::streampos AudioDecoderPrefetch::Tell() const {
+	return position;
+}
+
+int AudioDecoderPrefetch::GetTicks() const {
+	return ticks;
+}
+
+bool AudioDecoderPrefetch::WasInited() const {
+	return stream->decoder->WasInited();
+}
+
+std::string AudioDecoderPrefetch::GetError() const {
+	return error_message;
+}
+
+std::string AudioDecoderPrefetch::GetType() const {
+	return music_type;
+}
+
+int AudioDecoderPrefetch::GetUnderruns() const {
+	return stream->underruns.load(std::memory_order_relaxed);
+}
+
+int AudioDecoderPrefetch::FillBuffer(uint8_t* buffer, int size) {
+	auto& s = *stream;
+
+	s.started.store(true, std::memory_order_relaxed);
+
+	int filled = 0;
+	while (filled < size && !finished) {
+		unsigned r = s.read_index.load(std::memory_order_relaxed);
+
+		if (r == s.write_index.load(std::memory_order_acquire)) {
+			// The first block is always decoded here, this is not an underrun
+			if (primed) {
+				s.underruns.fetch_add(1, std::memory_order_relaxed);
+				thread.underruns.fetch_add(1, std::memory_order_relaxed);
+			}
+
+			// The thread holds the lock for at most one block
+			std::lock_guard<std::mutex> lock(s.mutex);
+			if (r == s.write_index.load(std::memory_order_relaxed)) {
+				s.DecodeBlock();
+			}
+			continue;
+		}
+
+		const Block& block = s.blocks[r % num_blocks];
+		if (block.size < 0) {
+			error_message = s.error;
+			return -1;
+		}
+
+		int amount = std::min(block.size - read_offset, size - filled);
+		memcpy(buffer + filled, block.data.data() + read_offset, amount);
+		read_offset += amount;
+		filled += amount;
+
+		// The decoder advances linearly inside a block, except when it loops
+		if (read_offset == block.size) {
+			ticks = block.end_ticks;
+			position = block.end_position;
+		} else if (block.end_position >= block.position && block.end_ticks >= block.ticks) {
+			ticks = block.ticks + static_cast<int>(static_cast<int64_t>(block.end_ticks - block.ticks) * read_offset / block.size);
+			position = block.position + (block.end_position - block.position) * read_offset / block.size;
+		} else {
+			ticks = block.ticks;
+			position = block.position;
+		}
+
+		if (read_offset == block.size) {
+			loop_count = block.loop_count;
+			finished = block.end;
+			primed = true;
+			read_offset = 0;
+			s.read_index.store(r + 1, std::memory_order_release);
+			thread.Wake();
+		}
+	}
+
+	return filled;
+}
+
+AudioPrefetchThread::AudioPrefetchThread() {
+	thread = std::thread(&AudioPrefetchThread::ThreadFunction, this);
+}
+
+AudioPrefetchThread::~AudioPrefetchThread() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	cv.notify_all();
+	thread.join();
+}
+
+void AudioPrefetchThread::Wake() {
+	wake.store(true, std::memory_order_release);
+	cv.notify_one();
+}
+
+int AudioPrefetchThread::GetUnderruns() const {
+	return underruns.load(std::memory_order_relaxed);
+}
+
+void AudioPrefetchThread::Add(std::shared_ptr<AudioDecoderPrefetch::Stream> stream) {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		streams.push_back(std::move(stream));
+	}
+	cv.notify_one();
+}
+
+void AudioPrefetchThread::ThreadFunction() {
+	Output::DeferThreadMessages();
+
+	std::vector<std::shared_ptr<AudioDecoderPrefetch::Stream>> work;
+
+	std::unique_lock<std::mutex> lock(mutex);
+	while (!quit) {
+		// Released streams are destroyed when work is cleared, outside of the lock
+		work = streams;
+		auto it = std::remove_if(streams.begin(), streams.end(), [](auto& stream) {
+			if (!stream->released.load()) {
+				return false;
+			}
+			int count = stream->underruns.load(std::memory_order_relaxed);
+			if (count > 0) {
+				Output::Debug("Audio: {} underruns while playing {}", count, stream->decoder->GetType());
+			}
+			return true;
+		});
+		streams.erase(it, streams.end());
+		lock.unlock();
+
+		// One block per stream and round, the stream that is furthest behind
+		// does not have to wait for the others to fill their ring
+		bool decoded = false;
+		for (auto& stream: work) {
+			if (stream->started.load() && !stream->released.load()) {
+				decoded |= stream->Produce();
+			}
+		}
+		work.clear();
+
+		lock.lock();
+		if (!decoded) {
+			// Woken when a block was consumed. The consumer notifies without
+			// the lock, a wakeup missed in between is caught by the timeout,
+			// which is much shorter than the playback time of the ring.
+			cv.wait_for(lock, 100ms, [this]() {
+				return quit || wake.exchange(false, std::memory_order_acquire);
+			});
+		}
+	}
+}
@@ -0,0 +1,133 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_DECODER_PREFETCH_H
+#define EP_AUDIO_DECODER_PREFETCH_H
+
+// Headers
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "audio_decoder.h"
+
+class AudioPrefetchThread;
+
+/**
+ * Wraps a sample based audio decoder and decodes it ahead of playback on a
+ * AudioPrefetchThread.
+ * The decoded blocks are passed to the audio callback through a single
+ * producer, single consumer ring, FillBuffer only copies from it.
+ * When the ring is empty FillBuffer decodes the block itself and has to take
+ * the lock of the stream, which the thread holds while decoding a block.
+ *
+ * Everything that is applied per output sample stays in the consumer:
+ * Volume and fades are handled by AudioDecoder and pitch is not supported,
+ * the AudioResampler on top of this decoder handles it instead.
+ * Seek and SetFormat discard the prefetched blocks, they must be called while
+ * the audio callback is not running (the GenericAudio mutex is held).
+ */
+class AudioDecoderPrefetch final : public AudioDecoder {
+public:
+	/**
+	 * @param decoder decoder to prefetch
+	 * @param thread thread doing the decoding, must outlive this decoder
+	 */
+	AudioDecoderPrefetch(std::unique_ptr<AudioDecoder> decoder, AudioPrefetchThread& thread);
+
+	/** The wrapped decoder is destroyed by the prefetch thread */
+	~AudioDecoderPrefetch() override;
+
+	bool Open(Filesystem_Stream::InputStream stream) override;
+	bool Seek(std::streamoff offset, std::ios_base::seekdir origin) override;
+	bool IsFinished() const override;
+	void GetFormat(int& frequency, Format& format, int& channels) const override;
+	bool SetFormat(int frequency, Format format, int channels) override;
+	bool GetLooping() const override;
+	void SetLooping(bool enable) override;
+	int GetLoopCount() const override;
+	std::streampos Tell() const override;
+	int GetTicks() const override;
+	bool WasInited() const override;
+	std::string GetError() const override;
+	std::string GetType() const override;
+
+	/** @return how often the audio callback had to decode because no block was ready */
+	int GetUnderruns() const;
+
+	/** Amount of blocks in the ring */
+	static constexpr int num_blocks = 8;
+
+	/** Size of a block in bytes, 2048 frames of stereo float */
+	static constexpr int block_size = 2048 * 2 * 4;
+
+	struct Stream;
+
+private:
+	int FillBuffer(uint8_t* buffer, int size) override;
+
+	std::shared_ptr<Stream> stream;
+	AudioPrefetchThread& thread;
+
+	/** Read position inside the current block */
+	int read_offset = 0;
+	/** Playback position of the consumed data, interpolated inside a block */
+	int ticks = 0;
+	std::streamoff position = -1;
+	bool finished = false;
+	bool primed = false;
+};
+
+/**
+ * Thread filling the rings of all AudioDecoderPrefetch instances.
+ * Owned by the audio backend, the decoders must be destroyed first.
+ */
+class AudioPrefetchThread {
+public:
+	AudioPrefetchThread();
+
+	/** Stops the thread and destroys the remaining decoders */
+	~AudioPrefetchThread();
+
+	AudioPrefetchThread(const AudioPrefetchThread&) = delete;
+	AudioPrefetchThread& operator=(const AudioPrefetchThread&) = delete;
+
+	/** @return total amount of underruns of all decoders */
+	int GetUnderruns() const;
+
+private:
+	friend class AudioDecoderPrefetch;
+
+	void Add(std::shared_ptr<AudioDecoderPrefetch::Stream> stream);
+
+	/** Wakes the thread when a ring has space, does not lock */
+	void Wake();
+
+	void ThreadFunction();
+
+	std::vector<std::shared_ptr<AudioDecoderPrefetch::Stream>> streams;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool quit = false;
+	std::atomic<bool> wake = false;
+	std::atomic<int> underruns = 0;
+	std::thread thread;
+};
+
+#endif
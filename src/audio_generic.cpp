@@ -22,6 +22,8 @@
 #include <memory>
 #include "audio_generic.h"
 #include "output.h"
+#include "instrumentation.h"
+#include "worker_pool.h"
 
 GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	int i = 0;
@@ -39,6 +41,10 @@ GenericAudio::GenericAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 	BGM_PlayedOnceIndicator = false;
 	midi_thread.reset();
 
+	if (WorkerPool::GetDefaultNumThreads() > 0) {
+		prefetch_thread = std::make_unique<AudioPrefetchThread>();
+	}
+
 	// Initialize to some arbitrary (low-quality) format to prevent crashes
 	// when the inheriting class doesn't call SetFormat
 	SetFormat(12345, AudioDecoder::Format::S8, 1);
@@ -206,6 +212,10 @@ void GenericAudio::Update() {
 	// no-op, handled by the Decode function called through a thread
 }
 
+int GenericAudio::GetBgmUnderruns() const {
+	return prefetch_thread ? prefetch_thread->GetUnderruns() : 0;
+}
+
 GenericAudioMidiOut* GenericAudio::CreateAndGetMidiOut() {
 	if (!midi_thread) {
 		midi_thread = std::make_unique<GenericAudioMidiOut>();
@@ -269,8 +279,9 @@ bool GenericAudio::PlayOnChannel(BgmChannel& chan, Filesystem_Stream::InputStrea
 		midi_thread->GetMidiOut().Reset();
 	}
 
-	chan.decoder = AudioDecoder::Create(filestream);
+	chan.decoder = AudioDecoder::Create(filestream, true, prefetch_thread.get());
 	chan.midi_out_used = false;
+	chan.has_last_gain = false;
 	if (chan.decoder && chan.decoder->Open(std::move(filestream))) {
 		chan.decoder->SetPitch(pitch);
 		chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
@@ -293,6 +304,7 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache>
 	chan.stopped = false; // Unstop channel so the audio thread doesn't delete it
 
 	chan.decoder = se->CreateSeDecoder();
+	chan.has_last_gain = false;
 	chan.decoder->SetPitch(pitch);
 	chan.decoder->SetFormat(output_format.frequency, output_format.format, output_format.channels);
 	chan.decoder->SetVolume(volume);
@@ -302,6 +314,8 @@ bool GenericAudio::PlayOnChannel(SeChannel& chan, std::unique_ptr<AudioSeCache>
 }
 
 void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
+	EP_INSTRUMENT_ZONE("GenericAudio::Decode");
+
 	bool channel_active = false;
 	float total_volume = 0;
 	int samples_per_frame = buffer_length / output_format.channels / 2;
@@ -317,6 +331,7 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 	scrap_buffer_size = samples_per_frame * output_format.channels * sizeof(uint32_t);
 	if (scrap_buffer.size() != scrap_buffer_size) {
 		scrap_buffer.resize(scrap_buffer_size);
+		convert_buffer.resize(samples_per_frame * output_format.channels);
 	}
 	std::fill(mixer_buffer.begin(), mixer_buffer.end(), '\0');
 
@@ -327,6 +342,7 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		int frequency = 0;
 		AudioDecoder::Format sampleformat;
 		float vleft, vright;
+		AudioMixer::Gain gain_from, gain_to;
 
 		// Mix BGM and SE together;
 		bool is_bgm_channel = i < nr_of_bgm_channels;
@@ -343,6 +359,11 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 					StereoVolume volume = currently_mixed_channel.decoder->GetVolume();
 					vleft = volume.left_volume / 100.0f * current_master_volume;
 					vright = volume.right_volume / 100.0f * current_master_volume;
+					// Ramp from the volume of the last buffer to avoid clicks on volume changes
+					gain_to = { vleft, vright };
+					gain_from = currently_mixed_channel.has_last_gain ? currently_mixed_channel.last_gain : gain_to;
+					currently_mixed_channel.last_gain = gain_to;
+					currently_mixed_channel.has_last_gain = true;
 					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
 					currently_mixed_channel.decoder->Update(std::chrono::milliseconds(samples_per_frame * 1000 / frequency));
 					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
@@ -379,6 +400,11 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 					StereoVolume volume = currently_mixed_channel.decoder->GetVolume();
 					vleft = volume.left_volume / 100.0f * current_master_volume;
 					vright = volume.right_volume / 100.0f * current_master_volume;
+					// Ramp from the volume of the last buffer to avoid clicks on volume changes
+					gain_to = { vleft, vright };
+					gain_from = currently_mixed_channel.has_last_gain ? currently_mixed_channel.last_gain : gain_to;
+					currently_mixed_channel.last_gain = gain_to;
+					currently_mixed_channel.has_last_gain = true;
 					currently_mixed_channel.decoder->GetFormat(frequency, sampleformat, channels);
 					samplesize = AudioDecoder::GetSamplesizeForFormat(sampleformat);
 
@@ -412,86 +438,17 @@ void GenericAudio::Decode(uint8_t* output_buffer, int buffer_length) {
 		//--------------------------------------------------------------------------------------------------------------------//
 
 		if (channel_used) {
-			for (unsigned ii = 0; ii < (unsigned)(read_bytes / (samplesize * channels)); ii++) {
-
-				float vall = vleft;
-				float valr = vright;
-
-				// Convert to floating point
-				switch (sampleformat) {
-					case AudioDecoder::Format::S8:
-						vall *= (((int8_t *) scrap_buffer.data())[ii * channels] / 128.0);
-						valr *= (((int8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0);
-						break;
-					case AudioDecoder::Format::U8:
-						vall *= (((uint8_t *) scrap_buffer.data())[ii * channels] / 128.0 - 1.0);
-						valr *= (((uint8_t *) scrap_buffer.data())[ii * channels + 1] / 128.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S16:
-						vall *= (((int16_t *) scrap_buffer.data())[ii * channels] / 32768.0);
-						valr *= (((int16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0);
-						break;
-					case AudioDecoder::Format::U16:
-						vall *= (((uint16_t *) scrap_buffer.data())[ii * channels] / 32768.0 - 1.0);
-						valr *= (((uint16_t *) scrap_buffer.data())[ii * channels + 1] / 32768.0 - 1.0);
-						break;
-					case AudioDecoder::Format::S32:
-						vall *= (((int32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0);
-						valr *= (((int32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0);
-						break;
-					case AudioDecoder::Format::U32:
-						vall *= (((uint32_t *) scrap_buffer.data())[ii * channels] / 2147483648.0 - 1.0);
-						valr *= (((uint32_t *) scrap_buffer.data())[ii * channels + 1] / 2147483648.0 - 1.0);
-						break;
-					case AudioDecoder::Format::F32:
-						vall *= (((float *) scrap_buffer.data())[ii * channels]);
-						valr *= (((float *) scrap_buffer.data())[ii * channels + 1]);
-						break;
-				}
-
-				if (!channel_active) {
-					// first channel
-					mixer_buffer[ii * output_format.channels] = vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] = valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				} else {
-					mixer_buffer[ii * output_format.channels] += vall;
-					if (channels > 1) {
-						mixer_buffer[ii * output_format.channels + 1] += valr;
-					} else {
-						mixer_buffer[ii * output_format.channels + 1] = mixer_buffer[ii * output_format.channels];
-					}
-				}
-
-			}
+			// The mixer buffer is zero filled, every channel is added onto it
+			int frames = read_bytes / (samplesize * channels);
+			AudioMixer::ToFloat(convert_buffer.data(), scrap_buffer.data(), sampleformat, frames * channels);
+			AudioMixer::MixStereo(mixer_buffer.data(), convert_buffer.data(), frames, channels, gain_from, gain_to);
 			channel_active = true;
 		}
 	}
 
 	if (channel_active) {
-		if (total_volume > 1.0) {
-			float threshold = 0.8f;
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				float sample = mixer_buffer[i];
-				float sign = (sample < 0) ? -1.0 : 1.0;
-				sample /= sign;
-				//dynamic range compression
-				if (sample > threshold) {
-					sample_buffer[i] = sign * 32768.0 * (threshold + (1.0 - threshold) * (sample - threshold) / (total_volume - threshold));
-				} else {
-					sample_buffer[i] = sign * sample * 32768.0;
-				}
-			}
-		} else {
-			//No dynamic range compression necessary
-			for (unsigned i = 0; i < (unsigned)(samples_per_frame * 2); i++) {
-				sample_buffer[i] = mixer_buffer[i] * 32768.0;
-			}
-		}
-
+		// Dynamic range compression is applied when the total volume is above 1.0
+		AudioMixer::ToS16(sample_buffer.data(), mixer_buffer.data(), samples_per_frame * 2, total_volume);
 		memcpy(output_buffer, sample_buffer.data(), buffer_length);
 	} else {
 		memset(output_buffer, '\0', buffer_length);
@@ -21,7 +21,9 @@
 #include "audio.h"
 #include "audio_secache.h"
 #include "audio_decoder_base.h"
+#include "audio_decoder_prefetch.h"
 #include "audio_generic_midiout.h"
+#include "audio_mixer.h"
 #include <memory>
 
 /**
@@ -71,6 +73,12 @@ public:
 
 	void Decode(uint8_t* output_buffer, int buffer_length);
 
+	/**
+	 * @return how often the BGM decoders did not decode ahead fast enough and
+	 * the audio thread had to decode itself
+	 */
+	int GetBgmUnderruns() const;
+
 private:
 	struct BgmChannel {
 		int id;
@@ -79,6 +87,9 @@ private:
 		bool paused;
 		bool stopped;
 		bool midi_out_used = false;
+		/** Volume at the end of the last Decode, start of the volume ramp */
+		AudioMixer::Gain last_gain = {};
+		bool has_last_gain = false;
 		void Stop();
 		void SetPaused(bool newPaused);
 		int GetTicks() const;
@@ -94,6 +105,8 @@ private:
 		GenericAudio* instance = nullptr;
 		bool paused;
 		bool stopped;
+		AudioMixer::Gain last_gain = {};
+		bool has_last_gain = false;
 	};
 	struct Format {
 		int frequency;
@@ -108,6 +121,9 @@ private:
 	static constexpr unsigned nr_of_se_channels = 31;
 	static constexpr unsigned nr_of_bgm_channels = 2;
 
+	/** Decodes the BGM ahead, declared before the channels to outlive their decoders */
+	std::unique_ptr<AudioPrefetchThread> prefetch_thread;
+
 	BgmChannel BGM_Channels[nr_of_bgm_channels];
 	SeChannel SE_Channels[nr_of_se_channels];
 	mutable bool BGM_PlayedOnceIndicator;
@@ -116,6 +132,7 @@ private:
 	std::vector<uint8_t> scrap_buffer = {};
 	unsigned scrap_buffer_size = 0;
 	std::vector<float> mixer_buffer = {};
+	std::vector<float> convert_buffer = {};
 
 	std::unique_ptr<GenericAudioMidiOut> midi_thread;
 };
@@ -0,0 +1,307 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "audio_mixer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_AUDIO_MIXER_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_AUDIO_MIXER_NEON
+#  include <arm_neon.h>
+#endif
+
+namespace {
+	constexpr float scale8 = 1.0f / 128.0f;
+	constexpr float scale16 = 1.0f / 32768.0f;
+	constexpr float scale32 = 1.0f / 2147483648.0f;
+
+	/** Dynamic range compression starts at this amplitude */
+	constexpr float compression_threshold = 0.8f;
+
+	template <typename T>
+	void ToFloatScalar(float* dst, const T* src, int count, float scale, float offset) {
+		for (int i = 0; i < count; ++i) {
+			dst[i] = src[i] * scale + offset;
+		}
+	}
+
+	void ToFloat8(float* dst, const uint8_t* src, int count, bool is_unsigned) {
+		int i = 0;
+#if defined(EP_AUDIO_MIXER_SSE2)
+		const __m128i flip = _mm_set1_epi8(is_unsigned ? static_cast<char>(0x80) : 0);
+		const __m128 scale = _mm_set1_ps(scale8);
+		for (; i + 16 <= count; i += 16) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), flip);
+			// Sign extend by moving the byte into the upper half and shifting back
+			__m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(v, v), 8);
+			__m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(v, v), 8);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16)), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16)), scale));
+			_mm_storeu_ps(dst + i + 8, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16)), scale));
+			_mm_storeu_ps(dst + i + 12, _mm_mul_ps(_mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16)), scale));
+		}
+#elif defined(EP_AUDIO_MIXER_NEON)
+		const int8x16_t flip = vdupq_n_s8(is_unsigned ? -128 : 0);
+		for (; i + 16 <= count; i += 16) {
+			int8x16_t v = veorq_s8(vld1q_s8(reinterpret_cast<const int8_t*>(src + i)), flip);
+			int16x8_t lo = vmovl_s8(vget_low_s8(v));
+			int16x8_t hi = vmovl_s8(vget_high_s8(v));
+			vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(lo))), scale8));
+			vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(lo))), scale8));
+			vst1q_f32(dst + i + 8, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(hi))), scale8));
+			vst1q_f32(dst + i + 12, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(hi))), scale8));
+		}
+#endif
+		if (is_unsigned) {
+			ToFloatScalar(dst + i, src + i, count - i, scale8, -1.0f);
+		} else {
+			ToFloatScalar(dst + i, reinterpret_cast<const int8_t*>(src + i), count - i, scale8, 0.0f);
+		}
+	}
+
+	void ToFloat16(float* dst, const uint16_t* src, int count, bool is_unsigned) {
+		int i = 0;
+#if defined(EP_AUDIO_MIXER_SSE2)
+		const __m128i flip = _mm_set1_epi16(is_unsigned ? static_cast<short>(0x8000) : 0);
+		const __m128 scale = _mm_set1_ps(scale16);
+		for (; i + 8 <= count; i += 8) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), flip);
+			__m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+			__m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+			_mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
+		}
+#elif defined(EP_AUDIO_MIXER_NEON)
+		const int16x8_t flip = vdupq_n_s16(is_unsigned ? -32768 : 0);
+		for (; i + 8 <= count; i += 8) {
+			int16x8_t v = veorq_s16(vld1q_s16(reinterpret_cast<const int16_t*>(src + i)), flip);
+			vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale16));
+			vst1q_f32(dst + i + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale16));
+		}
+#endif
+		if (is_unsigned) {
+			ToFloatScalar(dst + i, src + i, count - i, scale16, -1.0f);
+		} else {
+			ToFloatScalar(dst + i, reinterpret_cast<const int16_t*>(src + i), count - i, scale16, 0.0f);
+		}
+	}
+
+	void ToFloat32(float* dst, const uint32_t* src, int count, bool is_unsigned) {
+		int i = 0;
+#if defined(EP_AUDIO_MIXER_SSE2)
+		const __m128i flip = _mm_set1_epi32(is_unsigned ? static_cast<int>(0x80000000) : 0);
+		const __m128 scale = _mm_set1_ps(scale32);
+		for (; i + 4 <= count; i += 4) {
+			__m128i v = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), flip);
+			_mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+		}
+#elif defined(EP_AUDIO_MIXER_NEON)
+		const int32x4_t flip = vdupq_n_s32(is_unsigned ? INT32_MIN : 0);
+		for (; i + 4 <= count; i += 4) {
+			int32x4_t v = veorq_s32(vld1q_s32(reinterpret_cast<const int32_t*>(src + i)), flip);
+			vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(v), scale32));
+		}
+#endif
+		if (is_unsigned) {
+			ToFloatScalar(dst + i, src + i, count - i, scale32, -1.0f);
+		} else {
+			ToFloatScalar(dst + i, reinterpret_cast<const int32_t*>(src + i), count - i, scale32, 0.0f);
+		}
+	}
+
+	float CompressScalar(float sample, float ratio) {
+		float magnitude = std::fabs(sample);
+		if (magnitude > compression_threshold) {
+			magnitude = compression_threshold + ratio * (magnitude - compression_threshold);
+		}
+		return std::copysign(magnitude, sample);
+	}
+
+#if defined(EP_AUDIO_MIXER_SSE2)
+	__m128 Compress(__m128 sample, __m128 threshold, __m128 ratio) {
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		__m128 sign = _mm_and_ps(sample, sign_mask);
+		__m128 magnitude = _mm_andnot_ps(sign_mask, sample);
+		__m128 compressed = _mm_add_ps(threshold, _mm_mul_ps(ratio, _mm_sub_ps(magnitude, threshold)));
+		__m128 above = _mm_cmpgt_ps(magnitude, threshold);
+		magnitude = _mm_or_ps(_mm_and_ps(above, compressed), _mm_andnot_ps(above, magnitude));
+		return _mm_or_ps(magnitude, sign);
+	}
+
+	__m128i ToInt(__m128 sample) {
+		sample = _mm_mul_ps(sample, _mm_set1_ps(32768.0f));
+		sample = _mm_min_ps(_mm_max_ps(sample, _mm_set1_ps(-32768.0f)), _mm_set1_ps(32767.0f));
+		return _mm_cvttps_epi32(sample);
+	}
+#elif defined(EP_AUDIO_MIXER_NEON)
+	float32x4_t Compress(float32x4_t sample, float32x4_t threshold, float32x4_t ratio) {
+		float32x4_t magnitude = vabsq_f32(sample);
+		float32x4_t compressed = vmlaq_f32(threshold, ratio, vsubq_f32(magnitude, threshold));
+		magnitude = vbslq_f32(vcgtq_f32(magnitude, threshold), compressed, magnitude);
+		// Copy the sign bit of the sample
+		const uint32x4_t sign_mask = vdupq_n_u32(0x80000000);
+		return vbslq_f32(sign_mask, sample, magnitude);
+	}
+
+	int32x4_t ToInt(float32x4_t sample) {
+		sample = vmulq_n_f32(sample, 32768.0f);
+		sample = vminq_f32(vmaxq_f32(sample, vdupq_n_f32(-32768.0f)), vdupq_n_f32(32767.0f));
+		return vcvtq_s32_f32(sample);
+	}
+#endif
+}
+
+void AudioMixer::ToFloat(float* dst, const void* src, AudioDecoderBase::Format format, int count) {
+	using Format = AudioDecoderBase::Format;
+
+	switch (format) {
+		case Format::S8:
+		case Format::U8:
+			ToFloat8(dst, static_cast<const uint8_t*>(src), count, format == Format::U8);
+			break;
+		case Format::S16:
+		case Format::U16:
+			ToFloat16(dst, static_cast<const uint16_t*>(src), count, format == Format::U16);
+			break;
+		case Format::S32:
+		case Format::U32:
+			ToFloat32(dst, static_cast<const uint32_t*>(src), count, format == Format::U32);
+			break;
+		case Format::F32:
+			memcpy(dst, src, count * sizeof(float));
+			break;
+	}
+}
+
+void AudioMixer::MixStereo(float* dst, const float* src, int frames, int channels, Gain from, Gain to) {
+	if (frames <= 0) {
+		return;
+	}
+
+	const float step_l = (to.left - from.left) / frames;
+	const float step_r = (to.right - from.right) / frames;
+	int i = 0;
+
+	if (channels == 2) {
+		// Two frames per iteration
+#if defined(EP_AUDIO_MIXER_SSE2)
+		__m128 gain = _mm_setr_ps(from.left, from.right, from.left + step_l, from.right + step_r);
+		const __m128 step = _mm_setr_ps(2 * step_l, 2 * step_r, 2 * step_l, 2 * step_r);
+		for (; i + 2 <= frames; i += 2) {
+			__m128 mixed = _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_mul_ps(_mm_loadu_ps(src + i * 2), gain));
+			_mm_storeu_ps(dst + i * 2, mixed);
+			gain = _mm_add_ps(gain, step);
+		}
+#elif defined(EP_AUDIO_MIXER_NEON)
+		const float gain_init[] = { from.left, from.right, from.left + step_l, from.right + step_r };
+		const float step_init[] = { 2 * step_l, 2 * step_r, 2 * step_l, 2 * step_r };
+		float32x4_t gain = vld1q_f32(gain_init);
+		const float32x4_t step = vld1q_f32(step_init);
+		for (; i + 2 <= frames; i += 2) {
+			vst1q_f32(dst + i * 2, vmlaq_f32(vld1q_f32(dst + i * 2), vld1q_f32(src + i * 2), gain));
+			gain = vaddq_f32(gain, step);
+		}
+#endif
+		for (; i < frames; ++i) {
+			dst[i * 2] += src[i * 2] * (from.left + step_l * i);
+			dst[i * 2 + 1] += src[i * 2 + 1] * (from.right + step_r * i);
+		}
+	} else if (channels == 1) {
+		// Four frames per iteration, every sample is duplicated for left and right
+#if defined(EP_AUDIO_MIXER_SSE2)
+		__m128 gain_lo = _mm_setr_ps(from.left, from.right, from.left + step_l, from.right + step_r);
+		__m128 gain_hi = _mm_setr_ps(from.left + 2 * step_l, from.right + 2 * step_r, from.left + 3 * step_l, from.right + 3 * step_r);
+		const __m128 step = _mm_setr_ps(4 * step_l, 4 * step_r, 4 * step_l, 4 * step_r);
+		for (; i + 4 <= frames; i += 4) {
+			__m128 samples = _mm_loadu_ps(src + i);
+			__m128 lo = _mm_unpacklo_ps(samples, samples);
+			__m128 hi = _mm_unpackhi_ps(samples, samples);
+			_mm_storeu_ps(dst + i * 2, _mm_add_ps(_mm_loadu_ps(dst + i * 2), _mm_mul_ps(lo, gain_lo)));
+			_mm_storeu_ps(dst + i * 2 + 4, _mm_add_ps(_mm_loadu_ps(dst + i * 2 + 4), _mm_mul_ps(hi, gain_hi)));
+			gain_lo = _mm_add_ps(gain_lo, step);
+			gain_hi = _mm_add_ps(gain_hi, step);
+		}
+#elif defined(EP_AUDIO_MIXER_NEON)
+		const float gain_lo_init[] = { from.left, from.right, from.left + step_l, from.right + step_r };
+		const float gain_hi_init[] = { from.left + 2 * step_l, from.right + 2 * step_r, from.left + 3 * step_l, from.right + 3 * step_r };
+		const float step_init[] = { 4 * step_l, 4 * step_r, 4 * step_l, 4 * step_r };
+		float32x4_t gain_lo = vld1q_f32(gain_lo_init);
+		float32x4_t gain_hi = vld1q_f32(gain_hi_init);
+		const float32x4_t step = vld1q_f32(step_init);
+		for (; i + 4 <= frames; i += 4) {
+			float32x4_t samples = vld1q_f32(src + i);
+			float32x4x2_t zipped = vzipq_f32(samples, samples);
+			vst1q_f32(dst + i * 2, vmlaq_f32(vld1q_f32(dst + i * 2), zipped.val[0], gain_lo));
+			vst1q_f32(dst + i * 2 + 4, vmlaq_f32(vld1q_f32(dst + i * 2 + 4), zipped.val[1], gain_hi));
+			gain_lo = vaddq_f32(gain_lo, step);
+			gain_hi = vaddq_f32(gain_hi, step);
+		}
+#endif
+		for (; i < frames; ++i) {
+			dst[i * 2] += src[i] * (from.left + step_l * i);
+			dst[i * 2 + 1] += src[i] * (from.right + step_r * i);
+		}
+	} else {
+		for (; i < frames; ++i) {
+			dst[i * 2] += src[i * channels] * (from.left + step_l * i);
+			dst[i * 2 + 1] += src[i * channels + 1] * (from.right + step_r * i);
+		}
+	}
+}
+
+void AudioMixer::ToS16(int16_t* dst, const float* src, int count, float total_volume) {
+	const bool compress = total_volume > 1.0f;
+	const float ratio = compress ? (1.0f - compression_threshold) / (total_volume - compression_threshold) : 1.0f;
+	int i = 0;
+
+#if defined(EP_AUDIO_MIXER_SSE2)
+	const __m128 threshold_v = _mm_set1_ps(compression_threshold);
+	const __m128 ratio_v = _mm_set1_ps(ratio);
+	for (; i + 8 <= count; i += 8) {
+		__m128 lo = _mm_loadu_ps(src + i);
+		__m128 hi = _mm_loadu_ps(src + i + 4);
+		if (compress) {
+			lo = Compress(lo, threshold_v, ratio_v);
+			hi = Compress(hi, threshold_v, ratio_v);
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(ToInt(lo), ToInt(hi)));
+	}
+#elif defined(EP_AUDIO_MIXER_NEON)
+	const float32x4_t threshold_v = vdupq_n_f32(compression_threshold);
+	const float32x4_t ratio_v = vdupq_n_f32(ratio);
+	for (; i + 8 <= count; i += 8) {
+		float32x4_t lo = vld1q_f32(src + i);
+		float32x4_t hi = vld1q_f32(src + i + 4);
+		if (compress) {
+			lo = Compress(lo, threshold_v, ratio_v);
+			hi = Compress(hi, threshold_v, ratio_v);
+		}
+		vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(ToInt(lo)), vqmovn_s32(ToInt(hi))));
+	}
+#endif
+
+	for (; i < count; ++i) {
+		float sample = compress ? CompressScalar(src[i], ratio) : src[i];
+		sample = std::min(std::max(sample * 32768.0f, -32768.0f), 32767.0f);
+		dst[i] = static_cast<int16_t>(sample);
+	}
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_MIXER_H
+#define EP_AUDIO_MIXER_H
+
+// Headers
+#include <cstdint>
+#include "audio_decoder_base.h"
+
+/**
+ * Sample conversion and mixing kernels used by GenericAudio.
+ *
+ * The kernels process whole buffers with SSE2 or NEON when the target
+ * supports it and fall back to scalar code otherwise.
+ */
+namespace AudioMixer {
+	/** Volume of the left and right channel, 1.0 is full volume */
+	struct Gain {
+		float left;
+		float right;
+	};
+
+	/**
+	 * Converts samples to floating point in the range -1.0 to 1.0.
+	 *
+	 * @param dst output buffer, must hold count values
+	 * @param src samples to convert
+	 * @param format sample format of src
+	 * @param count amount of samples (frames * channels)
+	 */
+	void ToFloat(float* dst, const void* src, AudioDecoderBase::Format format, int count);
+
+	/**
+	 * Adds samples onto an interleaved stereo buffer.
+	 * The volume is ramped linearly from "from" to "to" over the frames.
+	 * Mono samples are mixed into both channels. For more than two channels
+	 * only the first two are used.
+	 *
+	 * @param dst stereo buffer, must hold frames * 2 values
+	 * @param src converted samples (see ToFloat)
+	 * @param frames amount of frames in src
+	 * @param channels amount of channels in src
+	 * @param from volume at the first frame
+	 * @param to volume after the last frame
+	 */
+	void MixStereo(float* dst, const float* src, int frames, int channels, Gain from, Gain to);
+
+	/**
+	 * Converts the mixed buffer to signed 16 bit samples.
+	 * When the total volume is above 1.0 a dynamic range compression is applied.
+	 *
+	 * @param dst output buffer, must hold count values
+	 * @param src mixed samples
+	 * @param count amount of samples
+	 * @param total_volume sum of the volumes of all mixed channels
+	 */
+	void ToS16(int16_t* dst, const float* src, int count, float total_volume);
+}
+
+#endif
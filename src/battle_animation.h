@@ -34,6 +34,9 @@ struct FileRequestResult;
 
 class BattleAnimation : public Sprite {
 public:
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
+
 	/** Update the animation to the next animation **/
 	void Update();
 
@@ -610,6 +610,25 @@ public:
 	FontRef GetFont() const;
 	void SetFont(FontRef font);
 
+	/**
+	 * Returns a value that changes whenever the pixels of the bitmap are
+	 * modified. The values are unique across all bitmaps.
+	 *
+	 * @return revision of the pixel data
+	 */
+	uint64_t GetRevision() const;
+
+	/**
+	 * Restricts all following drawing operations on this bitmap to a rect.
+	 * Used by Graphics to only redraw the damaged parts of the screen.
+	 *
+	 * @param rect clip rect, an empty rect disables clipping
+	 */
+	void SetClipRect(Rect const& rect);
+
+	/** @return clip rect, empty when clipping is disabled */
+	Rect GetClipRect() const;
+
 	ImageOpacity ComputeImageOpacity() const;
 	ImageOpacity ComputeImageOpacity(Rect rect) const;
 
@@ -651,6 +670,14 @@ protected:
 
 	static pixman_format_code_t find_format(const DynamicFormat& format);
 
+	static uint64_t NextRevision();
+
+	/** Marks the pixels as modified, see GetRevision */
+	void MarkChanged();
+
+	uint64_t revision = NextRevision();
+	Rect clip_rect;
+
 	/*
 	 * Determines the fastest operator for the operation.
 	 * When a blend_mode is specified the blend mode is used.
@@ -719,6 +746,18 @@ inline void Bitmap::SetFont(FontRef font) {
 	this->font = font;
 }
 
+inline uint64_t Bitmap::GetRevision() const {
+	return revision;
+}
+
+inline void Bitmap::MarkChanged() {
+	revision = NextRevision();
+}
+
+inline Rect Bitmap::GetClipRect() const {
+	return clip_rect;
+}
+
 inline int Bitmap::GetOriginalBpp() const {
 	return original_bpp;
 }
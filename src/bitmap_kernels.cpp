@@ -0,0 +1,341 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "bitmap_kernels.h"
+#include "bitmap_hslrgb.h"
+#include <array>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_BITMAP_KERNELS_SSE2
+#  include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_BITMAP_KERNELS_NEON
+#  include <arm_neon.h>
+#  include <type_traits>
+#endif
+
+namespace {
+	// Hard light of a tone channel (0-255) and a pixel channel
+	int HardLight(int tone, int value) {
+		int res;
+		if (tone <= 128) {
+			res = (2 * tone * value) / 255;
+		} else {
+			res = 255 - 2 * (255 - tone) * (255 - value) / 255;
+		}
+		return res > 255 ? 255 : res < 0 ? 0 : res;
+	}
+
+	// Changes the saturation of a pixel
+	// Algorithm from OpenPDN (MIT license)
+	// Transformation in Y'CbCr color space
+	inline void Saturation(int& r, int& g, int& b, int saturation) {
+		// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+		int lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+
+		// Scale Cb/Cr by scale factor "sat"
+		r = (lum * 1024 + (r - lum) * saturation) >> 10;
+		r = r > 255 ? 255 : r < 0 ? 0 : r;
+		g = (lum * 1024 + (g - lum) * saturation) >> 10;
+		g = g > 255 ? 255 : g < 0 ? 0 : g;
+		b = (lum * 1024 + (b - lum) * saturation) >> 10;
+		b = b > 255 ? 255 : b < 0 ? 0 : b;
+	}
+
+	inline uint32_t TonePixel(uint32_t pixel, const BitmapKernels::ToneTable& table, ImageOpacity opacity, int rs, int gs, int bs, int as) {
+		const int a = (pixel >> as) & 0xFF;
+		if (opacity != ImageOpacity::Opaque && a == 0) {
+			return pixel;
+		}
+
+		int r = (pixel >> rs) & 0xFF;
+		int g = (pixel >> gs) & 0xFF;
+		int b = (pixel >> bs) & 0xFF;
+
+		if (table.apply_sat) {
+			Saturation(r, g, b, table.saturation);
+		}
+
+		if (table.apply_color) {
+			r = table.hard_light[0][r];
+			g = table.hard_light[1][g];
+			b = table.hard_light[2][b];
+
+			if (opacity == ImageOpacity::Alpha_8Bit) {
+				r = r * a / 255;
+				g = g * a / 255;
+				b = b * a / 255;
+			}
+		}
+
+		return ((uint32_t)r << rs) | ((uint32_t)g << gs) | ((uint32_t)b << bs) | ((uint32_t)a << as);
+	}
+
+	template <int RS, int GS, int BS, int AS>
+	void ToneRow(uint32_t* row, int width, const BitmapKernels::ToneTable& table, ImageOpacity opacity) {
+		int i = 0;
+		const bool skip_transparent = opacity != ImageOpacity::Opaque;
+		const bool premultiply = table.apply_color && opacity == ImageOpacity::Alpha_8Bit;
+
+#if defined(EP_BITMAP_KERNELS_SSE2)
+		const __m128i ff = _mm_set1_epi32(0xFF);
+		const __m128i ffff = _mm_set1_epi32(0xFFFF);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one = _mm_set1_epi32(1);
+		const __m128i alpha_mask = _mm_set1_epi32(static_cast<int>(0xFFu << AS));
+		// Pairs of 16 bit factors for _mm_madd_epi16
+		const __m128i lum_coef = _mm_set1_epi32(7471 | (19595 << 16));
+		const __m128i sat_coef = _mm_set1_epi32(table.saturation | (1024 << 16));
+		const __m128i factor[3] = { _mm_set1_epi32(table.factor[0]), _mm_set1_epi32(table.factor[1]), _mm_set1_epi32(table.factor[2]) };
+		const __m128i invert[3] = { _mm_set1_epi32(table.invert[0]), _mm_set1_epi32(table.invert[1]), _mm_set1_epi32(table.invert[2]) };
+
+		auto clamp = [&](__m128i v) {
+			v = _mm_andnot_si128(_mm_srai_epi32(v, 31), v);
+			__m128i over = _mm_cmpgt_epi32(v, ff);
+			return _mm_or_si128(_mm_andnot_si128(over, v), _mm_and_si128(over, ff));
+		};
+		auto div255 = [&](__m128i v) {
+			// Exact for 0 <= v <= 65280
+			return _mm_srli_epi32(_mm_add_epi32(_mm_add_epi32(v, one), _mm_srli_epi32(v, 8)), 8);
+		};
+		auto saturate = [&](__m128i c, __m128i lum) {
+			// (lum * 1024 + (c - lum) * saturation) >> 10
+			__m128i pair = _mm_or_si128(_mm_and_si128(_mm_sub_epi32(c, lum), ffff), _mm_slli_epi32(lum, 16));
+			return clamp(_mm_srai_epi32(_mm_madd_epi16(pair, sat_coef), 10));
+		};
+		auto hard_light = [&](__m128i c, int channel) {
+			__m128i q = div255(_mm_madd_epi16(_mm_xor_si128(c, invert[channel]), factor[channel]));
+			q = _mm_xor_si128(q, invert[channel]);
+			// 256 -> 255
+			return _mm_sub_epi32(q, _mm_srli_epi32(q, 8));
+		};
+
+		for (; i + 4 <= width; i += 4) {
+			const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			__m128i r = _mm_and_si128(_mm_srli_epi32(px, RS), ff);
+			__m128i g = _mm_and_si128(_mm_srli_epi32(px, GS), ff);
+			__m128i b = _mm_and_si128(_mm_srli_epi32(px, BS), ff);
+			const __m128i a = _mm_and_si128(_mm_srli_epi32(px, AS), ff);
+
+			if (table.apply_sat) {
+				// lum = g + ((7471 * (b - g) + 19595 * (r - g)) >> 16), the coefficients sum up to 65536
+				__m128i pair = _mm_or_si128(_mm_and_si128(_mm_sub_epi32(b, g), ffff), _mm_slli_epi32(_mm_sub_epi32(r, g), 16));
+				__m128i lum = _mm_add_epi32(g, _mm_srai_epi32(_mm_madd_epi16(pair, lum_coef), 16));
+				r = saturate(r, lum);
+				g = saturate(g, lum);
+				b = saturate(b, lum);
+			}
+
+			if (table.apply_color) {
+				r = hard_light(r, 0);
+				g = hard_light(g, 1);
+				b = hard_light(b, 2);
+
+				if (premultiply) {
+					r = div255(_mm_madd_epi16(r, a));
+					g = div255(_mm_madd_epi16(g, a));
+					b = div255(_mm_madd_epi16(b, a));
+				}
+			}
+
+			__m128i res = _mm_or_si128(_mm_and_si128(px, alpha_mask), _mm_slli_epi32(r, RS));
+			res = _mm_or_si128(res, _mm_slli_epi32(g, GS));
+			res = _mm_or_si128(res, _mm_slli_epi32(b, BS));
+
+			if (skip_transparent) {
+				const __m128i transparent = _mm_cmpeq_epi32(a, zero);
+				res = _mm_or_si128(_mm_and_si128(transparent, px), _mm_andnot_si128(transparent, res));
+			}
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), res);
+		}
+#elif defined(EP_BITMAP_KERNELS_NEON)
+		const uint32x4_t ff = vdupq_n_u32(0xFF);
+		const int32x4_t ff_s = vdupq_n_s32(0xFF);
+		const int32x4_t zero_s = vdupq_n_s32(0);
+		const int32x4_t one = vdupq_n_s32(1);
+		const uint32x4_t alpha_mask = vdupq_n_u32(0xFFu << AS);
+
+		auto extract = [&](uint32x4_t px, auto shift) {
+			constexpr int s = decltype(shift)::value;
+			if constexpr (s == 0) {
+				return vreinterpretq_s32_u32(vandq_u32(px, ff));
+			} else {
+				return vreinterpretq_s32_u32(vandq_u32(vshrq_n_u32(px, s), ff));
+			}
+		};
+		auto div255 = [&](int32x4_t v) {
+			return vshrq_n_s32(vaddq_s32(vaddq_s32(v, one), vshrq_n_s32(v, 8)), 8);
+		};
+		auto saturate = [&](int32x4_t c, int32x4_t lum) {
+			int32x4_t v = vshrq_n_s32(vmlaq_n_s32(vshlq_n_s32(lum, 10), vsubq_s32(c, lum), table.saturation), 10);
+			return vminq_s32(vmaxq_s32(v, zero_s), ff_s);
+		};
+		auto hard_light = [&](int32x4_t c, int channel) {
+			const int32x4_t inv = vdupq_n_s32(table.invert[channel]);
+			int32x4_t q = div255(vmulq_n_s32(veorq_s32(c, inv), table.factor[channel]));
+			return vminq_s32(veorq_s32(q, inv), ff_s);
+		};
+
+		for (; i + 4 <= width; i += 4) {
+			const uint32x4_t px = vld1q_u32(row + i);
+			int32x4_t r = extract(px, std::integral_constant<int, RS>());
+			int32x4_t g = extract(px, std::integral_constant<int, GS>());
+			int32x4_t b = extract(px, std::integral_constant<int, BS>());
+			const int32x4_t a = extract(px, std::integral_constant<int, AS>());
+
+			if (table.apply_sat) {
+				// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+				int32x4_t lum = vmulq_n_s32(b, 7471);
+				lum = vmlaq_n_s32(lum, g, 38470);
+				lum = vmlaq_n_s32(lum, r, 19595);
+				lum = vshrq_n_s32(lum, 16);
+				r = saturate(r, lum);
+				g = saturate(g, lum);
+				b = saturate(b, lum);
+			}
+
+			if (table.apply_color) {
+				r = hard_light(r, 0);
+				g = hard_light(g, 1);
+				b = hard_light(b, 2);
+
+				if (premultiply) {
+					r = div255(vmulq_s32(r, a));
+					g = div255(vmulq_s32(g, a));
+					b = div255(vmulq_s32(b, a));
+				}
+			}
+
+			uint32x4_t res = vandq_u32(px, alpha_mask);
+			res = vorrq_u32(res, vshlq_n_u32(vreinterpretq_u32_s32(r), RS));
+			res = vorrq_u32(res, vshlq_n_u32(vreinterpretq_u32_s32(g), GS));
+			res = vorrq_u32(res, vshlq_n_u32(vreinterpretq_u32_s32(b), BS));
+
+			if (skip_transparent) {
+				const uint32x4_t transparent = vceqq_s32(a, zero_s);
+				res = vbslq_u32(transparent, px, res);
+			}
+
+			vst1q_u32(row + i, res);
+		}
+#endif
+		for (; i < width; ++i) {
+			row[i] = TonePixel(row[i], table, opacity, RS, GS, BS, AS);
+		}
+	}
+
+	template <int RS, int GS, int BS, int AS>
+	void ToneRect(uint32_t* pixels, int stride, int width, int height, const BitmapKernels::ToneTable& table, ImageOpacity opacity) {
+		for (int y = 0; y < height; ++y) {
+			ToneRow<RS, GS, BS, AS>(pixels + y * stride, width, table, opacity);
+		}
+	}
+
+	bool ShiftsEqual(const BitmapKernels::ChannelShifts& s, int r, int g, int b, int a) {
+		return s.r == r && s.g == g && s.b == b && s.a == a;
+	}
+
+	struct HueCacheEntry {
+		/** RGB of the source pixel, bit 24 marks the entry as used */
+		uint32_t key = 0;
+		uint32_t value = 0;
+	};
+}
+
+BitmapKernels::ToneTable::ToneTable(const Tone& tone) {
+	apply_sat = tone.gray != 128;
+	apply_color = tone.red != 128 || tone.green != 128 || tone.blue != 128;
+	saturation = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+
+	const int channels[3] = { tone.red, tone.green, tone.blue };
+	for (int c = 0; c < 3; ++c) {
+		for (int v = 0; v < 256; ++v) {
+			hard_light[c][v] = static_cast<uint8_t>(HardLight(channels[c], v));
+		}
+
+		if (channels[c] <= 128) {
+			factor[c] = 2 * channels[c];
+			invert[c] = 0;
+		} else {
+			factor[c] = 2 * (255 - channels[c]);
+			invert[c] = 0xFF;
+		}
+	}
+}
+
+void BitmapKernels::ApplyTone(uint32_t* pixels, int stride, int width, int height, const ToneTable& table, ImageOpacity opacity, const ChannelShifts& shifts) {
+	if (!table.apply_sat && !table.apply_color) {
+		return;
+	}
+
+	// The channel layouts of the 32 bit formats in pixel_format.h
+	if (ShiftsEqual(shifts, 16, 8, 0, 24)) {
+		ToneRect<16, 8, 0, 24>(pixels, stride, width, height, table, opacity);
+	} else if (ShiftsEqual(shifts, 0, 8, 16, 24)) {
+		ToneRect<0, 8, 16, 24>(pixels, stride, width, height, table, opacity);
+	} else if (ShiftsEqual(shifts, 24, 16, 8, 0)) {
+		ToneRect<24, 16, 8, 0>(pixels, stride, width, height, table, opacity);
+	} else if (ShiftsEqual(shifts, 8, 16, 24, 0)) {
+		ToneRect<8, 16, 24, 0>(pixels, stride, width, height, table, opacity);
+	} else {
+		ApplyToneScalar(pixels, stride, width, height, table, opacity, shifts);
+	}
+}
+
+void BitmapKernels::ApplyToneScalar(uint32_t* pixels, int stride, int width, int height, const ToneTable& table, ImageOpacity opacity, const ChannelShifts& shifts) {
+	if (!table.apply_sat && !table.apply_color) {
+		return;
+	}
+
+	for (int y = 0; y < height; ++y) {
+		uint32_t* row = pixels + y * stride;
+		for (int x = 0; x < width; ++x) {
+			row[x] = TonePixel(row[x], table, opacity, shifts.r, shifts.g, shifts.b, shifts.a);
+		}
+	}
+}
+
+void BitmapKernels::ApplyHue(uint32_t* pixels, int count, int hue) {
+	// Sprites and pictures use few distinct colors, the HSL conversion
+	// is only done once per color.
+	constexpr int cache_bits = 8;
+	std::array<HueCacheEntry, 1 << cache_bits> cache;
+
+	for (int i = 0; i < count; ++i) {
+		const uint32_t pixel = pixels[i];
+		const uint32_t a = pixel & 0xFF;
+		if (a == 0) {
+			continue;
+		}
+
+		const uint32_t rgb = pixel >> 8;
+		const uint32_t key = rgb | 0x1000000;
+		auto& entry = cache[(rgb * 2654435761u) >> (32 - cache_bits)];
+		if (entry.key != key) {
+			uint8_t r = (rgb >> 16) & 0xFF;
+			uint8_t g = (rgb >> 8) & 0xFF;
+			uint8_t b = rgb & 0xFF;
+			RGB_adjust_HSL(r, g, b, hue);
+			entry.key = key;
+			entry.value = ((uint32_t)r << 24) | ((uint32_t)g << 16) | ((uint32_t)b << 8);
+		}
+
+		pixels[i] = entry.value | a;
+	}
+}
@@ -0,0 +1,98 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_BITMAP_KERNELS_H
+#define EP_BITMAP_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "opacity.h"
+#include "tone.h"
+
+/**
+ * Per-pixel color effects used by Bitmap.
+ *
+ * The kernels work in place on 32 bit pixels with 8 bit channels.
+ * They are specialized for the channel layouts of the four 32 bit formats
+ * in pixel_format.h and use SSE2 or NEON when the target supports it.
+ * Other layouts are processed by the scalar reference implementation.
+ */
+namespace BitmapKernels {
+	/** Bit position of each 8 bit channel in a pixel */
+	struct ChannelShifts {
+		int r;
+		int g;
+		int b;
+		int a;
+	};
+
+	/** Values derived from a Tone, computed once per blit instead of per pixel */
+	struct ToneTable {
+		explicit ToneTable(const Tone& tone);
+
+		/** Whether the gray (saturation) component is applied */
+		bool apply_sat = false;
+		/** Whether the color components are applied */
+		bool apply_color = false;
+		/** Saturation factor, 1024 keeps the saturation */
+		int saturation = 1024;
+
+		/** Hard light result per channel (r, g, b) and source value */
+		uint8_t hard_light[3][256] = {};
+
+		/**
+		 * Hard light as arithmetic for the vector kernels:
+		 * (((value ^ invert) * factor) / 255) ^ invert
+		 */
+		int factor[3] = {};
+		int invert[3] = {};
+	};
+
+	/**
+	 * Applies a tone to a rectangle of pixels.
+	 *
+	 * Pixels with an alpha of 0 are not changed unless the opacity is Opaque.
+	 * With 8 bit alpha the color tone result is premultiplied by the alpha.
+	 *
+	 * @param pixels first pixel of the rectangle
+	 * @param stride distance between two rows in pixels
+	 * @param width width of the rectangle
+	 * @param height height of the rectangle
+	 * @param table tone to apply
+	 * @param opacity opacity of the source image
+	 * @param shifts channel layout of the pixels
+	 */
+	void ApplyTone(uint32_t* pixels, int stride, int width, int height, const ToneTable& table, ImageOpacity opacity, const ChannelShifts& shifts);
+
+	/**
+	 * Scalar reference implementation of ApplyTone.
+	 * Supports any channel layout, used for verification and benchmarking.
+	 */
+	void ApplyToneScalar(uint32_t* pixels, int stride, int width, int height, const ToneTable& table, ImageOpacity opacity, const ChannelShifts& shifts);
+
+	/**
+	 * Rotates the hue of pixels in R8G8B8A8 (red in the highest byte) layout.
+	 * Pixels with an alpha of 0 are not changed.
+	 *
+	 * @param pixels pixels to change
+	 * @param count amount of pixels
+	 * @param hue hue rotation, 0x600 is a full rotation
+	 */
+	void ApplyHue(uint32_t* pixels, int count, int hue);
+}
+
+#endif
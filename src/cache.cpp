@@ -20,10 +20,13 @@
 #  pragma warning(disable: 4003)
 #endif
 
-#include <map>
-#include <tuple>
+#include <atomic>
 #include <chrono>
 #include <cassert>
+#include <cstring>
+#include <future>
+#include <type_traits>
+#include <unordered_map>
 
 #include "async_handler.h"
 #include "cache.h"
@@ -31,17 +34,54 @@
 #include "exfont.h"
 #include "default_graphics.h"
 #include "bitmap.h"
+#include "instrumentation.h"
 #include "output.h"
 #include "player.h"
 #include <lcf/data.h>
 #include "game_clock.h"
 #include "translation.h"
+#include "utils.h"
+#include "worker_pool.h"
 
 using namespace std::chrono_literals;
 
 namespace {
-	std::string MakeHashKey(std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
-		return fmt::format("{}:{}:{}:{}", folder_name, filename, transparent, extra_flags);
+	/** Incremental 64 bit FNV-1a hash for the cache keys */
+	class KeyHash {
+	public:
+		KeyHash& Add(std::string_view str) {
+			for (unsigned char c: str) {
+				Byte(c);
+			}
+			// Separator, "ab" + "c" and "a" + "bc" must differ
+			Byte(0);
+			return *this;
+		}
+
+		template <typename T>
+		KeyHash& Add(T value) {
+			static_assert(std::is_integral<T>::value, "Only integers can be hashed");
+			for (size_t i = 0; i < sizeof(T); ++i) {
+				Byte(static_cast<unsigned char>(static_cast<uint64_t>(value) >> (i * 8)));
+			}
+			return *this;
+		}
+
+		uint64_t Get() const {
+			return state;
+		}
+
+	private:
+		void Byte(unsigned char b) {
+			state ^= b;
+			state *= 1099511628211ULL;
+		}
+
+		uint64_t state = 14695981039346656037ULL;
+	};
+
+	uint64_t MakeHashKey(std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
+		return KeyHash().Add(folder_name).Add(filename).Add(transparent).Add(extra_flags).Get();
 	}
 
 	std::string MakeTileHashKey(std::string_view chipset_name, int id) {
@@ -71,57 +111,138 @@ namespace {
 	}
 
 	struct CacheItem {
+		uint64_t key = 0;
+		/** Points to the static directory names of the material spec */
+		std::string_view folder_name;
+		std::string filename;
+		bool transparent = false;
+		uint32_t extra_flags = 0;
+
 		BitmapRef bitmap;
 		Game_Clock::time_point last_access;
+
+		/** Intrusive LRU list, ordered by last_access, newest first */
+		CacheItem* prev = nullptr;
+		CacheItem* next = nullptr;
+
+		bool Matches(std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags) const {
+			return this->folder_name == folder_name && this->filename == filename
+				&& this->transparent == transparent && this->extra_flags == extra_flags;
+		}
 	};
 
-	using key_type = std::string;
+	// The nodes of unordered_map are stable, which is required for the intrusive list
+	using key_type = uint64_t;
 	std::unordered_map<key_type, CacheItem> cache;
+	CacheItem* lru_head = nullptr;
+	CacheItem* lru_tail = nullptr;
 
 	using tile_key_type = std::string;
 	std::unordered_map<tile_key_type, std::weak_ptr<Bitmap>> cache_tiles;
 
-	// rect, flip_x, flip_y, tone, blend
-	using effect_key_type = std::tuple<std::string, bool, Rect, bool, bool, Tone, Color>;
-	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
+	struct EffectItem {
+		std::string id;
+		bool transparent = false;
+		Rect rect;
+		bool flip_x = false;
+		bool flip_y = false;
+		Tone tone;
+		Color blend;
+
+		std::weak_ptr<Bitmap> bitmap;
+
+		bool Matches(std::string_view id, bool transparent, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) const {
+			return this->id == id && this->transparent == transparent && this->rect == rect
+				&& this->flip_x == flip_x && this->flip_y == flip_y && this->tone == tone && this->blend == blend;
+		}
+	};
+
+	using effect_key_type = uint64_t;
+	std::unordered_map<effect_key_type, EffectItem> cache_effects;
 
 	std::string system_name;
 
 	std::string system2_name;
 
-	constexpr int cache_limit = 10 * 1024 * 1024;
+	constexpr size_t default_cache_limit = 10 * 1024 * 1024;
+	size_t cache_limit = default_cache_limit;
 	size_t cache_size = 0;
 
+	Cache::Stats stats;
+
+	void Unlink(CacheItem& item) {
+		(item.prev ? item.prev->next : lru_head) = item.next;
+		(item.next ? item.next->prev : lru_tail) = item.prev;
+		item.prev = nullptr;
+		item.next = nullptr;
+	}
+
+	void PushFront(CacheItem& item) {
+		item.next = lru_head;
+		(lru_head ? lru_head->prev : lru_tail) = &item;
+		lru_head = &item;
+	}
+
+	void Touch(CacheItem& item, Game_Clock::time_point now) {
+		item.last_access = now;
+		if (lru_head != &item) {
+			Unlink(item);
+			PushFront(item);
+		}
+	}
+
+	void Erase(CacheItem& item) {
+		if (item.bitmap) {
+			cache_size -= item.bitmap->GetSize();
+		}
+		Unlink(item);
+		cache.erase(item.key);
+	}
+
+	/** @return cached item or nullptr, updates the hit and miss counters */
+	CacheItem* FindInCache(uint64_t key, std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags) {
+		auto it = cache.find(key);
+		if (it == cache.end() || !it->second.Matches(folder_name, filename, transparent, extra_flags)) {
+			++stats.misses;
+			return nullptr;
+		}
+		++stats.hits;
+		Touch(it->second, Game_Clock::GetFrameTime());
+		return &it->second;
+	}
+
 	void FreeBitmapMemory() {
 		auto cur_ticks = Game_Clock::GetFrameTime();
 
-		for (auto it = cache.begin(); it != cache.end();) {
-			if (it->second.bitmap.use_count() != 1) {
-				// Bitmap is referenced
-				++it;
-				continue;
-			}
-
-			auto last_access = cur_ticks - it->second.last_access;
+		// The list is ordered by the access time, stop at the first item that is too new
+		for (CacheItem* item = lru_tail; item != nullptr;) {
+			auto last_access = cur_ticks - item->last_access;
 			bool cache_exhausted = cache_size > cache_limit;
 			if (cache_exhausted) {
 				if (last_access <= 50ms) {
 					// Used during the last 3 frames, must be important, keep it.
-					++it;
-					continue;
+					break;
 				}
 			} else if (last_access <= 3s) {
-				++it;
+				break;
+			}
+
+			CacheItem* prev = item->prev;
+
+			if (item->bitmap.use_count() != 1) {
+				// Bitmap is referenced, so it is in use right now.
+				// Keeps its place, it is evicted first once it is released.
+				item = prev;
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("Freeing memory of {}/{}", std::get<0>(i.first), std::get<1>(i.first));
+			Output::Debug("Freeing memory of {}/{}", item->folder_name, item->filename);
 #endif
 
-			cache_size -= it->second.bitmap->GetSize();
-
-			it = cache.erase(it);
+			++stats.evictions;
+			Erase(*item);
+			item = prev;
 		}
 
 #ifdef CACHE_DEBUG
@@ -129,7 +250,13 @@ namespace {
 #endif
 	}
 
-	BitmapRef AddToCache(const std::string& key, BitmapRef bmp) {
+	BitmapRef AddToCache(uint64_t key, std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags, BitmapRef bmp) {
+		auto it = cache.find(key);
+		if (it != cache.end()) {
+			// Hash collision, the old bitmap stays valid for its users
+			Erase(it->second);
+		}
+
 		if (bmp) {
 			cache_size += bmp->GetSize();
 #ifdef CACHE_DEBUG
@@ -137,7 +264,139 @@ namespace {
 #endif
 		}
 
-		return (cache[key] = {bmp, Game_Clock::GetFrameTime()}).bitmap;
+		auto& item = cache[key];
+		item.key = key;
+		item.folder_name = folder_name;
+		item.filename = std::string(filename);
+		item.transparent = transparent;
+		item.extra_flags = extra_flags;
+		item.bitmap = std::move(bmp);
+		item.last_access = Game_Clock::GetFrameTime();
+		PushFront(item);
+
+		return item.bitmap;
+	}
+
+	/** Decoding job shared between the worker pool and the main thread */
+	struct PrefetchTask {
+		std::packaged_task<BitmapRef()> decode;
+		std::atomic<bool> claimed = { false };
+
+		/** @return whether the caller is the first to claim the task and must run it */
+		bool Claim() {
+			return !claimed.exchange(true);
+		}
+	};
+
+	/** Image that is decoded by the worker pool */
+	struct PrefetchItem {
+		std::string_view folder_name;
+		std::string filename;
+		bool transparent = false;
+		uint32_t extra_flags = 0;
+		/** Path of the image file, becomes the id of the bitmap */
+		std::string path;
+		/** Upper bound of the decoded size, reserved in the cache budget */
+		size_t estimated_size = 0;
+		std::shared_ptr<PrefetchTask> task;
+		std::future<BitmapRef> result;
+
+		bool Matches(std::string_view folder_name, std::string_view filename, bool transparent, uint32_t extra_flags) const {
+			return this->folder_name == folder_name && this->filename == filename
+				&& this->transparent == transparent && this->extra_flags == extra_flags;
+		}
+
+		bool IsReady() const {
+			return result.wait_for(0s) == std::future_status::ready;
+		}
+	};
+
+	/** Limits the amount of images that are decoded ahead of time */
+	constexpr size_t max_prefetch_items = 32;
+
+	std::unordered_map<key_type, PrefetchItem> prefetch_items;
+	size_t prefetch_size = 0;
+
+	WorkerPool& GetDecodePool() {
+		static WorkerPool pool(WorkerPool::GetDefaultNumThreads());
+		return pool;
+	}
+
+	/**
+	 * Returns the decoded bitmap and removes the item.
+	 * A task that no worker started yet is decoded by the caller,
+	 * only a running task is waited for.
+	 */
+	BitmapRef TakePrefetched(std::unordered_map<key_type, PrefetchItem>::iterator it) {
+		auto& item = it->second;
+		if (item.task->Claim()) {
+			item.task->decode();
+		} else if (!item.IsReady()) {
+			++stats.prefetch_waits;
+		}
+
+		BitmapRef bmp = item.result.get();
+		if (bmp) {
+			bmp->SetId(std::move(item.path));
+		}
+		prefetch_size -= item.estimated_size;
+		prefetch_items.erase(it);
+
+		// Decoder warnings of the worker
+		Output::FlushThreadMessages();
+
+		return bmp;
+	}
+
+	/** Discards all prefetches, tasks that did not start yet are skipped by the workers */
+	void CancelPrefetches() {
+		for (auto& kv: prefetch_items) {
+			kv.second.task->Claim();
+		}
+		prefetch_items.clear();
+		prefetch_size = 0;
+	}
+
+	/** @return the bitmap or nullptr when it cannot be used, warns about the reason */
+	BitmapRef CheckLoadedBitmap(std::string_view folder_name, std::string_view filename, BitmapRef bmp) {
+		if (!bmp) {
+			Output::Warning("Invalid image: {}/{}", folder_name, filename);
+		} else {
+			if (bmp->GetOriginalBpp() > 8) {
+				// FIXME: This HasActiveTranslation check will also load 32 bit images in the game directory when
+				// a translation is active and our API does not expose whether the asset was redirected or not.
+				if (!Player::HasEasyRpgExtensions() && !Player::IsPatchManiac() && !Tr::HasActiveTranslation()) {
+					Output::Warning("Image {}/{} has a bit depth of {} that is not supported by RPG_RT. Enable EasyRPG Extensions or Maniac Patch to load such images.", folder_name, filename, bmp->GetOriginalBpp());
+					bmp.reset();
+				}
+			}
+		}
+		return bmp;
+	}
+
+	/** Moves finished prefetches that were not requested yet into the cache */
+	void CollectPrefetched() {
+		for (auto it = prefetch_items.begin(); it != prefetch_items.end();) {
+			if (!it->second.IsReady()) {
+				++it;
+				continue;
+			}
+
+			auto& item = it->second;
+			const auto key = it->first;
+			const auto folder_name = item.folder_name;
+			const auto filename = std::move(item.filename);
+			const bool transparent = item.transparent;
+			const uint32_t extra_flags = item.extra_flags;
+
+			auto next = std::next(it);
+			auto bmp = CheckLoadedBitmap(folder_name, filename, TakePrefetched(it));
+			if (bmp && cache_size + bmp->GetSize() <= cache_limit) {
+				AddToCache(key, folder_name, filename, transparent, extra_flags, std::move(bmp));
+			}
+			// Otherwise the image is loaded again when it is requested
+			it = next;
+		}
 	}
 
 	struct Material {
@@ -235,11 +494,73 @@ namespace {
 		return s.dummy_renderer();
 	}
 
+	template<Material::Type T>
+	uint32_t GetBitmapFlags(uint32_t extra_flags) {
+		return Bitmap::Flag_ReadOnly | extra_flags | (
+				T == Material::Chipset ? Bitmap::Flag_Chipset :
+				T == Material::System ? Bitmap::Flag_System : 0);
+	}
+
+	template<Material::Type T>
+	void PrefetchBitmap(std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
+		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
+		const Spec& s = spec[T];
+
+		auto& pool = GetDecodePool();
+		if (pool.GetNumThreads() == 0 || filename.empty() || filename == CACHE_DEFAULT_BITMAP) {
+			return;
+		}
+
+		const auto key = MakeHashKey(s.directory, filename, transparent, extra_flags);
+		if (cache.find(key) != cache.end() || prefetch_items.find(key) != prefetch_items.end()) {
+			return;
+		}
+
+		// The decoded images must fit into the cache budget next to the cached ones
+		const size_t estimated_size = static_cast<size_t>(s.max_width) * s.max_height * 4;
+		if (prefetch_items.size() >= max_prefetch_items || cache_size + prefetch_size + estimated_size > cache_limit) {
+			return;
+		}
+
+		// The filesystem is not thread-safe, only the decoding is done by the workers
+		auto is = FileFinder::OpenImage(s.directory, filename);
+		if (!is) {
+			// Reported when the image is requested
+			return;
+		}
+
+		auto data = std::make_shared<std::vector<uint8_t>>(Utils::ReadStream(is));
+		auto task = std::make_shared<PrefetchTask>();
+		task->decode = std::packaged_task<BitmapRef()>([data, transparent, flags = GetBitmapFlags<T>(extra_flags)]() {
+			return Bitmap::Create(data->data(), data->size(), transparent, flags);
+		});
+
+		auto& item = prefetch_items[key];
+		item.folder_name = s.directory;
+		item.filename = std::string(filename);
+		item.transparent = transparent;
+		item.extra_flags = extra_flags;
+		item.path = ToString(is.GetName());
+		item.estimated_size = estimated_size;
+		item.task = task;
+		item.result = task->decode.get_future();
+		prefetch_size += estimated_size;
+
+		++stats.prefetches;
+		pool.Submit([task]() {
+			if (task->Claim()) {
+				task->decode();
+			}
+		});
+	}
+
 	template<Material::Type T>
 	BitmapRef LoadBitmap(std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
 		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
 		const Spec& s = spec[T];
 
+		EP_INSTRUMENT_ZONE("Cache::LoadBitmap", T);
+
 		// This assert is triggered by the request cache clear when switching languages
 		// Remove comment to test if all assets are requested correctly
 		//auto* req = AsyncHandler::RequestFile(s.directory, filename);
@@ -247,14 +568,23 @@ namespace {
 
 		BitmapRef bmp;
 
+		if (!prefetch_items.empty()) {
+			CollectPrefetched();
+		}
+
 		const auto key = MakeHashKey(s.directory, filename, transparent, extra_flags);
-		auto it = cache.find(key);
-		if (it == cache.end()) {
+		auto* item = FindInCache(key, s.directory, filename, transparent, extra_flags);
+		if (!item) {
 			if (filename == CACHE_DEFAULT_BITMAP) {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, true);
 			}
 
-			if (!bmp) {
+			auto prefetch_it = prefetch_items.find(key);
+			if (!bmp && prefetch_it != prefetch_items.end() && prefetch_it->second.Matches(s.directory, filename, transparent, extra_flags)) {
+				// Not collected yet, decoded here when no worker started it
+				bmp = CheckLoadedBitmap(s.directory, filename, TakePrefetched(prefetch_it));
+				FreeBitmapMemory();
+			} else if (!bmp) {
 				auto is = FileFinder::OpenImage(s.directory, filename);
 
 				FreeBitmapMemory();
@@ -267,24 +597,7 @@ namespace {
 						bmp = CreateEmpty<T>();
 					}
 				} else {
-					auto flags = Bitmap::Flag_ReadOnly | (
-							T == Material::Chipset ? Bitmap::Flag_Chipset :
-							T == Material::System ? Bitmap::Flag_System : 0);
-					flags |= extra_flags;
-
-					bmp = Bitmap::Create(std::move(is), transparent, flags);
-					if (!bmp) {
-						Output::Warning("Invalid image: {}/{}", s.directory, filename);
-					} else {
-						if (bmp->GetOriginalBpp() > 8) {
-							// FIXME: This HasActiveTranslation check will also load 32 bit images in the game directory when
-							// a translation is active and our API does not expose whether the asset was redirected or not.
-							if (!Player::HasEasyRpgExtensions() && !Player::IsPatchManiac() && !Tr::HasActiveTranslation()) {
-								Output::Warning("Image {}/{} has a bit depth of {} that is not supported by RPG_RT. Enable EasyRPG Extensions or Maniac Patch to load such images.", s.directory, filename, bmp->GetOriginalBpp());
-								bmp.reset();
-							}
-						}
-					}
+					bmp = CheckLoadedBitmap(s.directory, filename, Bitmap::Create(std::move(is), transparent, GetBitmapFlags<T>(extra_flags)));
 				}
 			}
 
@@ -293,10 +606,9 @@ namespace {
 				bmp = LoadDummyBitmap<T>(s.directory, filename, transparent);
 			}
 
-			bmp = AddToCache(key, bmp);
+			bmp = AddToCache(key, s.directory, filename, transparent, extra_flags, bmp);
 		} else {
-			it->second.last_access = Game_Clock::GetFrameTime();
-			bmp = it->second.bitmap;
+			bmp = item->bitmap;
 		}
 
 		assert(bmp);
@@ -339,6 +651,22 @@ namespace {
 
 std::vector<uint8_t> Cache::exfont_custom;
 
+void Cache::PrefetchCharset(std::string_view file) {
+	PrefetchBitmap<Material::Charset>(file, spec[Material::Charset].transparent);
+}
+
+void Cache::PrefetchChipset(std::string_view file) {
+	PrefetchBitmap<Material::Chipset>(file, spec[Material::Chipset].transparent);
+}
+
+void Cache::PrefetchPanorama(std::string_view file) {
+	PrefetchBitmap<Material::Panorama>(file, spec[Material::Panorama].transparent);
+}
+
+void Cache::PrefetchPicture(std::string_view file, bool transparent) {
+	PrefetchBitmap<Material::Picture>(file, transparent);
+}
+
 BitmapRef Cache::Backdrop(std::string_view file) {
 	return LoadBitmap<Material::Backdrop>(file);
 }
@@ -411,9 +739,9 @@ BitmapRef Cache::System(std::string_view file, bool bg_preserve_transparent_colo
 BitmapRef Cache::Exfont() {
 	const auto key = MakeHashKey("ExFont", "ExFont", false);
 
-	auto it = cache.find(key);
+	auto* item = FindInCache(key, "ExFont", "ExFont", false, 0);
 
-	if (it == cache.end()) {
+	if (!item) {
 		// Allow overwriting of built-in exfont with a custom ExFont image file
 		// exfont_custom is filled by Player::CreateGameObjects
 		BitmapRef exfont_img;
@@ -425,10 +753,9 @@ BitmapRef Cache::Exfont() {
 			exfont_img = Bitmap::Create(exfont_h, sizeof(exfont_h), true);
 		}
 
-		return AddToCache(key, exfont_img);
+		return AddToCache(key, "ExFont", "ExFont", false, 0, exfont_img);
 	} else {
-		it->second.last_access = Game_Clock::GetFrameTime();
-		return it->second.bitmap;
+		return item->bitmap;
 	}
 }
 
@@ -470,28 +797,33 @@ BitmapRef Cache::Tile(std::string_view filename, int tile_id) {
 }
 
 BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
-	std::string id = ToString(src_bitmap->GetId());
+	std::string_view id = src_bitmap->GetId();
+	std::string fallback_id;
 
 	if (id.empty()) {
 		// Log causes false positives when empty bitmaps or placeholder (checkerboard)
 		// bitmaps are used.
 		//Output::Debug("Bitmap has no ID. Please report a bug!");
-		id = fmt::format("{}", (void*)(src_bitmap.get()));
+		fallback_id = fmt::format("{}", (void*)(src_bitmap.get()));
+		id = fallback_id;
 	}
 
-	const effect_key_type key {
-		id,
-		src_bitmap->GetTransparent(),
-		rect,
-		flip_x,
-		flip_y,
-		tone,
-		blend
-	};
+	const bool transparent = src_bitmap->GetTransparent();
+
+	const effect_key_type key = KeyHash().Add(id).Add(transparent)
+		.Add(rect.x).Add(rect.y).Add(rect.width).Add(rect.height)
+		.Add(flip_x).Add(flip_y)
+		.Add(tone.red).Add(tone.green).Add(tone.blue).Add(tone.gray)
+		.Add(blend.red).Add(blend.green).Add(blend.blue).Add(blend.alpha)
+		.Get();
 
-	const auto it = cache_effects.find(key);
+	auto it = cache_effects.find(key);
+	if (it != cache_effects.end() && !it->second.Matches(id, transparent, rect, flip_x, flip_y, tone, blend)) {
+		// Hash collision, replaced below
+		it = cache_effects.end();
+	}
 
-	if (it == cache_effects.end() || it->second.expired()) {
+	if (it == cache_effects.end() || it->second.bitmap.expired()) {
 		BitmapRef bitmap_effects;
 
 		auto create = [&rect] () -> BitmapRef {
@@ -525,13 +857,18 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 
 		assert(bitmap_effects && "Effect cache used but no effect applied!");
 
-		return(cache_effects[key] = bitmap_effects).lock();
-	} else { return it->second.lock(); }
+		cache_effects[key] = { std::string(id), transparent, rect, flip_x, flip_y, tone, blend, bitmap_effects };
+		return bitmap_effects;
+	} else { return it->second.bitmap.lock(); }
 }
 
 void Cache::Clear() {
+	// Running decodes finish in the background, their results are discarded
+	CancelPrefetches();
 	cache_effects.clear();
 	cache.clear();
+	lru_head = nullptr;
+	lru_tail = nullptr;
 	cache_size = 0;
 
 	for (auto& kv : cache_tiles) {
@@ -553,6 +890,26 @@ void Cache::ClearAll() {
 	system2_name.clear();
 }
 
+void Cache::SetMemoryBudget(size_t bytes) {
+	cache_limit = bytes;
+}
+
+size_t Cache::GetMemoryBudget() {
+	return cache_limit;
+}
+
+Cache::Stats Cache::GetStats() {
+	Stats result = stats;
+	result.size = cache_size;
+	result.entries = cache.size();
+	result.budget = cache_limit;
+	return result;
+}
+
+void Cache::ResetStats() {
+	stats = {};
+}
+
 void Cache::SetSystemName(std::string filename) {
 	system_name = std::move(filename);
 }
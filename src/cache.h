@@ -19,6 +19,7 @@
 #define EP_CACHE_H
 
 // Headers
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -55,12 +56,62 @@ namespace Cache {
 	BitmapRef System(std::string_view filename, bool bg_preserve_transparent_color = false);
 	BitmapRef System2(std::string_view filename);
 
+	/**
+	 * Starts decoding an image on a worker thread.
+	 * A later request of the image decodes it directly when no worker started
+	 * yet and only blocks while a worker is decoding it. Images that do not fit
+	 * into the memory budget or exceed the limit of pending prefetches are
+	 * skipped. Does nothing on platforms without threads.
+	 */
+	void PrefetchCharset(std::string_view filename);
+	void PrefetchChipset(std::string_view filename);
+	void PrefetchPanorama(std::string_view filename);
+	void PrefetchPicture(std::string_view filename, bool transparent);
+
 	BitmapRef Tile(std::string_view filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
 	void Clear();
 	void ClearAll();
 
+	/** Usage statistics of the bitmap cache */
+	struct Stats {
+		/** Bitmap requests served from the cache */
+		uint64_t hits = 0;
+		/** Bitmap requests that loaded the image */
+		uint64_t misses = 0;
+		/** Unused bitmaps removed from the cache */
+		uint64_t evictions = 0;
+		/** Images queued for decoding on a worker thread */
+		uint64_t prefetches = 0;
+		/** Requests that waited for a worker to finish decoding */
+		uint64_t prefetch_waits = 0;
+		/** Memory used by the cached bitmaps in bytes */
+		size_t size = 0;
+		/** Amount of cached bitmaps */
+		size_t entries = 0;
+		/** Memory budget in bytes */
+		size_t budget = 0;
+	};
+
+	/**
+	 * Sets the memory budget of the bitmap cache.
+	 * When exceeded unused bitmaps are freed more aggressively.
+	 * Bitmaps that are in use are never freed.
+	 *
+	 * @param bytes budget in bytes (default 10 MiB)
+	 */
+	void SetMemoryBudget(size_t bytes);
+
+	/** @return memory budget of the bitmap cache in bytes */
+	size_t GetMemoryBudget();
+
+	/** @return usage statistics of the bitmap cache */
+	Stats GetStats();
+
+	/** Resets the request, eviction and prefetch counters */
+	void ResetStats();
+
 	/** @return the configured system bitmap, or nullptr if there is no system */
 	BitmapRef System(bool bg_preserve_transparent_color = false);
 
@@ -0,0 +1,74 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "damage_region.h"
+
+void DamageRegion::Reset(const Rect& new_bounds) {
+	bounds = new_bounds;
+	rects.clear();
+	full = false;
+}
+
+void DamageRegion::Add(Rect rect) {
+	if (full) {
+		return;
+	}
+
+	rect.Adjust(bounds);
+	if (rect.IsEmpty()) {
+		return;
+	}
+
+	// Merge with all overlapping rects, the merged rect can overlap further rects
+	for (size_t i = 0; i < rects.size();) {
+		if (!rect.IsOutOfBounds(rects[i])) {
+			rect.Merge(rects[i]);
+			rects.erase(rects.begin() + i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+	rects.push_back(rect);
+
+	if (static_cast<int>(rects.size()) > max_rects) {
+		Rect merged;
+		for (const auto& r: rects) {
+			merged.Merge(r);
+		}
+		rects.clear();
+		rects.push_back(merged);
+	}
+
+	// Drawing more than half of the screen in pieces is not worth it
+	long long area = 0;
+	for (const auto& r: rects) {
+		area += static_cast<long long>(r.width) * r.height;
+	}
+	if (area * 2 > static_cast<long long>(bounds.width) * bounds.height) {
+		AddAll();
+	}
+}
+
+void DamageRegion::AddAll() {
+	full = true;
+	rects.clear();
+	if (!bounds.IsEmpty()) {
+		rects.push_back(bounds);
+	}
+}
@@ -0,0 +1,81 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_DAMAGE_REGION_H
+#define EP_DAMAGE_REGION_H
+
+// Headers
+#include <vector>
+#include "rect.h"
+
+/**
+ * Collects the parts of the screen that must be redrawn.
+ *
+ * Overlapping rects are merged. When the rects cover a large part of the
+ * screen or there are too many of them the whole screen is damaged instead
+ * because drawing everything once is then cheaper.
+ */
+class DamageRegion {
+public:
+	/** Maximum amount of separate rects before they are merged into one */
+	static constexpr int max_rects = 8;
+
+	/**
+	 * Removes all damage.
+	 *
+	 * @param bounds screen area, added rects are clipped to it
+	 */
+	void Reset(const Rect& bounds);
+
+	/**
+	 * Marks an area as damaged.
+	 *
+	 * @param rect damaged area
+	 */
+	void Add(Rect rect);
+
+	/** Marks the whole screen as damaged */
+	void AddAll();
+
+	/** @return true when nothing is damaged */
+	bool IsEmpty() const;
+
+	/** @return true when the whole screen is damaged */
+	bool IsFull() const;
+
+	/** @return damaged rects, they do not overlap */
+	const std::vector<Rect>& GetRects() const;
+
+private:
+	Rect bounds;
+	std::vector<Rect> rects;
+	bool full = false;
+};
+
+inline bool DamageRegion::IsEmpty() const {
+	return rects.empty();
+}
+
+inline bool DamageRegion::IsFull() const {
+	return full;
+}
+
+inline const std::vector<Rect>& DamageRegion::GetRects() const {
+	return rects;
+}
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "database_snapshot.h"
+#include "filesystem_stream.h"
+#include "game_config.h"
+#include "filefinder.h"
+#include "output.h"
+#include "platform.h"
+#include "string_view.h"
+#include "utils.h"
+#include "version.h"
+#include <cstring>
+#include <sstream>
+#include <string_view>
+#include <zlib.h>
+#include <lcf/data.h>
+#include <lcf/ldb/reader.h>
+#include <lcf/lmt/reader.h>
+
+namespace {
+	constexpr char magic[8] = { 'E', 'P', 'D', 'B', 'S', 'N', 'A', 'P' };
+
+	/** Increment when the layout changes */
+	constexpr uint32_t format_version = 1;
+
+	/** magic, format version, ldb crc, lmt crc, id size, ldb size, lmt size */
+	constexpr size_t header_size = sizeof(magic) + 6 * sizeof(uint32_t);
+
+	/** Snapshots of the same game share this prefix */
+	std::string GetGamePrefix(const DatabaseSnapshot::Key& key) {
+		auto game_crc = crc32(0L, reinterpret_cast<const Bytef*>(key.game.data()), key.game.size());
+		return fmt::format("database_{:08x}_", game_crc);
+	}
+
+	std::string GetFilename(const DatabaseSnapshot::Key& key) {
+		return fmt::format("{}{:08x}_{:08x}.snap", GetGamePrefix(key), key.ldb_crc, key.lmt_crc);
+	}
+
+	/** Everything besides the CRCs that affects the parsed data */
+	std::string GetId(const DatabaseSnapshot::Key& key) {
+		return Version::GetVersionString() + "\n" + key.encoding;
+	}
+
+	void WriteU32(std::vector<uint8_t>& data, uint32_t value) {
+		for (int i = 0; i < 4; ++i) {
+			data.push_back(static_cast<uint8_t>(value >> (i * 8)));
+		}
+	}
+
+	uint32_t ReadU32(const uint8_t* data) {
+		return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+	}
+
+	FilesystemView GetSnapshotFilesystem() {
+#ifdef EMSCRIPTEN
+		// The config directory is synced to the browser storage, not worth it
+		return {};
+#else
+		return Game_Config::GetCacheFilesystem();
+#endif
+	}
+}
+
+std::vector<uint8_t> DatabaseSnapshot::Create(const Key& key, const lcf::rpg::Database& db, const lcf::rpg::TreeMap& treemap) {
+	// No encoding: The strings are already UTF-8 and stored unconverted
+	std::stringstream ldb_out;
+	lcf::LDB_Reader::Save(ldb_out, db, "");
+	std::stringstream lmt_out;
+	auto engine = db.system.ldb_id == 2003 ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+	lcf::LMT_Reader::Save(lmt_out, treemap, engine, "");
+
+	const std::string id = GetId(key);
+	const std::string ldb = ldb_out.str();
+	const std::string lmt = lmt_out.str();
+
+	std::vector<uint8_t> data;
+	data.reserve(header_size + id.size() + ldb.size() + lmt.size());
+	data.insert(data.end(), std::begin(magic), std::end(magic));
+	WriteU32(data, format_version);
+	WriteU32(data, key.ldb_crc);
+	WriteU32(data, key.lmt_crc);
+	WriteU32(data, static_cast<uint32_t>(id.size()));
+	WriteU32(data, static_cast<uint32_t>(ldb.size()));
+	WriteU32(data, static_cast<uint32_t>(lmt.size()));
+	data.insert(data.end(), id.begin(), id.end());
+	data.insert(data.end(), ldb.begin(), ldb.end());
+	data.insert(data.end(), lmt.begin(), lmt.end());
+
+	return data;
+}
+
+bool DatabaseSnapshot::Parse(const std::vector<uint8_t>& data, const Key& key, lcf::rpg::Database& db, lcf::rpg::TreeMap& treemap) {
+	if (data.size() < header_size || memcmp(data.data(), magic, sizeof(magic)) != 0) {
+		return false;
+	}
+
+	const uint8_t* header = data.data() + sizeof(magic);
+	if (ReadU32(header) != format_version || ReadU32(header + 4) != key.ldb_crc || ReadU32(header + 8) != key.lmt_crc) {
+		return false;
+	}
+
+	size_t id_size = ReadU32(header + 12);
+	size_t ldb_size = ReadU32(header + 16);
+	size_t lmt_size = ReadU32(header + 20);
+	if (data.size() != header_size + id_size + ldb_size + lmt_size) {
+		// Truncated, e.g. the Player was closed while writing it
+		return false;
+	}
+
+	auto* id = data.data() + header_size;
+	if (std::string_view(reinterpret_cast<const char*>(id), id_size) != GetId(key)) {
+		return false;
+	}
+
+	// The readers do not modify the buffer
+	auto* ldb = const_cast<uint8_t*>(id + id_size);
+	auto* lmt = ldb + ldb_size;
+
+	Filesystem_Stream::InputMemoryStreamBufView ldb_buf(Span<uint8_t>(ldb, ldb_size));
+	std::istream ldb_stream(&ldb_buf);
+	auto new_db = lcf::LDB_Reader::Load(ldb_stream);
+
+	Filesystem_Stream::InputMemoryStreamBufView lmt_buf(Span<uint8_t>(lmt, lmt_size));
+	std::istream lmt_stream(&lmt_buf);
+	auto new_treemap = lcf::LMT_Reader::Load(lmt_stream);
+
+	if (!new_db || !new_treemap) {
+		return false;
+	}
+
+	db = std::move(*new_db);
+	treemap = std::move(*new_treemap);
+	return true;
+}
+
+bool DatabaseSnapshot::IsEnabled() {
+	return static_cast<bool>(GetSnapshotFilesystem());
+}
+
+bool DatabaseSnapshot::Load(const Key& key) {
+	auto fs = GetSnapshotFilesystem();
+	if (!fs) {
+		return false;
+	}
+
+	std::string filename = GetFilename(key);
+	auto is = fs.OpenInputStream(filename);
+	if (!is) {
+		return false;
+	}
+
+	// One read, parsing happens in memory
+	auto data = Utils::ReadStream(is);
+	if (!Parse(data, key, lcf::Data::data, lcf::Data::treemap)) {
+		Output::Debug("Database snapshot {} is outdated", filename);
+		return false;
+	}
+
+	Output::Debug("Loaded database snapshot {}", filename);
+	return true;
+}
+
+void DatabaseSnapshot::Save(const Key& key) {
+	auto fs = GetSnapshotFilesystem();
+	if (!fs) {
+		return;
+	}
+
+	std::string filename = GetFilename(key);
+	auto data = Create(key, lcf::Data::data, lcf::Data::treemap);
+
+	{
+		auto os = fs.OpenOutputStream(filename);
+		if (!os || !os.write(reinterpret_cast<const char*>(data.data()), data.size())) {
+			Output::Debug("Could not write database snapshot {}", filename);
+			return;
+		}
+	}
+
+	// Snapshots of older versions of the game are never used again
+	const std::string prefix = GetGamePrefix(key);
+	auto* entries = fs.ListDirectory();
+	if (!entries) {
+		return;
+	}
+
+	for (const auto& entry : *entries) {
+		const auto& name = entry.second.name;
+		if (entry.second.type != DirectoryTree::FileType::Regular || name == filename
+				|| !StartsWith(name, prefix) || !EndsWith(name, ".snap")) {
+			continue;
+		}
+
+		if (Platform::File(FileFinder::MakePath(fs.GetFullPath(), name)).Remove()) {
+			Output::Debug("Removed database snapshot {}", name);
+		}
+	}
+}
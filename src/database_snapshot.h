@@ -0,0 +1,90 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_DATABASE_SNAPSHOT_H
+#define EP_DATABASE_SNAPSHOT_H
+
+// Headers
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <lcf/rpg/database.h>
+#include <lcf/rpg/treemap.h>
+
+/**
+ * Snapshots of the parsed database and treemap in the cache directory.
+ *
+ * The snapshot stores the data already converted to UTF-8. Loading it skips
+ * the codepage conversion of every string, which is most of the parsing time
+ * of RPG_RT.ldb and RPG_RT.lmt on slow devices.
+ * A snapshot is only used when the CRC32 of both source files, the encoding
+ * and the Player version match, otherwise the files are parsed again.
+ */
+namespace DatabaseSnapshot {
+	/** Identifies the source files a snapshot was created from */
+	struct Key {
+		/** Game directory, only the newest snapshot of a game is kept */
+		std::string game;
+		uint32_t ldb_crc = 0;
+		uint32_t lmt_crc = 0;
+		std::string encoding;
+	};
+
+	/**
+	 * @return whether snapshots can be loaded and saved on this system
+	 */
+	bool IsEnabled();
+
+	/**
+	 * Replaces lcf::Data with the content of the snapshot matching the key.
+	 *
+	 * @param key source files
+	 * @return whether a valid snapshot was found, lcf::Data is unchanged otherwise
+	 */
+	bool Load(const Key& key);
+
+	/**
+	 * Writes a snapshot of lcf::Data and removes older snapshots of the game.
+	 * Failures are only logged, the snapshot is an optimization.
+	 *
+	 * @param key source files the data was parsed from
+	 */
+	void Save(const Key& key);
+
+	/**
+	 * Serializes a database and treemap into the snapshot format.
+	 *
+	 * @param key source files
+	 * @param db database
+	 * @param treemap treemap
+	 * @return snapshot data
+	 */
+	std::vector<uint8_t> Create(const Key& key, const lcf::rpg::Database& db, const lcf::rpg::TreeMap& treemap);
+
+	/**
+	 * Deserializes a snapshot.
+	 *
+	 * @param data snapshot data
+	 * @param key expected source files
+	 * @param db filled with the database
+	 * @param treemap filled with the treemap
+	 * @return whether the snapshot matches the key and is valid
+	 */
+	bool Parse(const std::vector<uint8_t>& data, const Key& key, lcf::rpg::Database& db, lcf::rpg::TreeMap& treemap);
+}
+
+#endif
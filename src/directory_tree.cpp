@@ -18,6 +18,7 @@
 #include "directory_tree.h"
 #include "filefinder.h"
 #include "filesystem.h"
+#include "instrumentation.h"
 #include "output.h"
 #include "platform.h"
 #include "player.h"
@@ -86,6 +87,8 @@ bool DirectoryTree::WildcardMatch(const std::string_view& pattern, const std::st
 }
 
 DirectoryTree::DirectoryListType* DirectoryTree::ListDirectory(std::string_view path) const {
+	EP_INSTRUMENT_ZONE("DirectoryTree::ListDirectory");
+
 	std::vector<Entry> entries;
 	std::string fs_path = ToString(path);
 
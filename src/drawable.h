@@ -19,7 +19,10 @@
 #define EP_DRAWABLE_H
 
 #include <cstdint>
+#include <cstring>
 #include <memory>
+#include <type_traits>
+#include "rect.h"
 
 class Bitmap;
 class Drawable;
@@ -57,6 +60,35 @@ public:
 
 	virtual void Draw(Bitmap& dst) = 0;
 
+	/** Screen area and render state of a drawable, used for damage tracking */
+	struct DamageInfo {
+		/** Area of the screen the drawable draws into */
+		Rect rect;
+		/** Hash of everything that affects the output of the drawable */
+		uint64_t state = 14695981039346656037ULL;
+
+		/**
+		 * Adds a value to the state hash.
+		 *
+		 * @param value value to add, must be trivially copyable without padding
+		 */
+		template <typename T>
+		void Hash(const T& value);
+	};
+
+	/**
+	 * Reports which part of the screen the drawable covers and a hash of its
+	 * state. Graphics compares the state between frames and only redraws the
+	 * areas of drawables that changed.
+	 * The information must describe the output of the next Draw call, so
+	 * drawables that update their state in Draw cannot be tracked.
+	 *
+	 * @param info output, the rect is empty when nothing is drawn
+	 * @return false when the drawable is not tracked. The whole screen is
+	 *   then redrawn every frame the drawable is visible.
+	 */
+	virtual bool GetDamage(DamageInfo& info) const;
+
 	Z_t GetZ() const;
 
 	void SetZ(Z_t z);
@@ -136,6 +168,23 @@ inline Drawable::Flags operator~(Drawable::Flags f) {
 	return static_cast<Drawable::Flags>(~static_cast<unsigned>(f));
 }
 
+template <typename T>
+inline void Drawable::DamageInfo::Hash(const T& value) {
+	static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be hashed");
+
+	// FNV-1a
+	unsigned char bytes[sizeof(T)];
+	memcpy(bytes, &value, sizeof(T));
+	for (auto b: bytes) {
+		state ^= b;
+		state *= 1099511628211ULL;
+	}
+}
+
+inline bool Drawable::GetDamage(DamageInfo&) const {
+	return false;
+}
+
 inline Drawable::Drawable(Z_t z, Flags flags)
 	: _z(z),
 	_flags(flags)
@@ -20,6 +20,7 @@
 #include "filesystem_lzh.h"
 #include "filesystem_zip.h"
 #include "filesystem_stream.h"
+#include "instrumentation.h"
 #include "filefinder.h"
 #include "utils.h"
 #include "output.h"
@@ -35,6 +36,8 @@ Filesystem::Filesystem(std::string base_path, FilesystemView parent_fs) : base_p
 };
 
 Filesystem_Stream::InputStream Filesystem::OpenInputStream(std::string_view name, std::ios_base::openmode m) const {
+	EP_INSTRUMENT_ZONE("Filesystem::OpenInputStream");
+
 	if (name.empty()) {
 		return Filesystem_Stream::InputStream();
 	}
@@ -63,6 +66,8 @@ Filesystem_Stream::InputStream Filesystem::OpenOrCreateInputStream(std::string_v
 }
 
 Filesystem_Stream::OutputStream Filesystem::OpenOutputStream(std::string_view name, std::ios_base::openmode m) const {
+	EP_INSTRUMENT_ZONE("Filesystem::OpenOutputStream");
+
 	if (name.empty()) {
 		return Filesystem_Stream::OutputStream();
 	}
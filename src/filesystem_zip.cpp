@@ -28,15 +28,25 @@
 #include <sstream>
 #include <cassert>
 #include <algorithm>
+#include <memory>
+#include <streambuf>
 #include <fmt/format.h>
 
 constexpr char end_of_central_directory[] = "\x50\x4b\x05\x06";
 constexpr int32_t end_of_central_directory_size = 18;
 
+constexpr uint32_t zip64_end_of_central_directory = 0x06064b50;
+constexpr uint32_t zip64_end_of_central_directory_locator = 0x07064b50;
+constexpr int32_t zip64_end_of_central_directory_locator_size = 20;
+constexpr uint16_t zip64_extra_field = 0x0001;
+
 constexpr uint32_t central_directory_entry = 0x02014b50;
 constexpr uint32_t local_header = 0x04034b50;
 constexpr uint32_t local_header_size = 30;
 
+// Deflated entries up to this size are inflated into memory at once, larger ones are streamed
+constexpr uint64_t max_inflate_in_memory = 256 * 1024;
+
 static std::string normalize_path(std::string_view path) {
 	if (path == "." || path == "/" || path.empty()) {
 		return "";
@@ -52,6 +62,336 @@ static std::string normalize_path(std::string_view path) {
 	return inner_path;
 }
 
+static uint64_t read_u64(std::istream& zipfile) {
+	uint32_t low = 0;
+	uint32_t high = 0;
+	zipfile.read(reinterpret_cast<char*>(&low), sizeof(uint32_t));
+	Utils::SwapByteOrder(low);
+	zipfile.read(reinterpret_cast<char*>(&high), sizeof(uint32_t));
+	Utils::SwapByteOrder(high);
+	return (static_cast<uint64_t>(high) << 32) | low;
+}
+
+/**
+ * Reads the Zip64 extended information of an extra field.
+ * Only the values whose 32 bit field contains 0xFFFFFFFF are stored, in the order
+ * uncompressed size, compressed size, local header offset. Pass only those.
+ */
+static void read_zip64_extra_field(std::istream& zipfile, uint16_t extra_field_length, const std::vector<uint64_t*>& values) {
+	const std::streamoff end = static_cast<std::streamoff>(zipfile.tellg()) + extra_field_length;
+
+	while (!values.empty() && static_cast<std::streamoff>(zipfile.tellg()) + 4 <= end) {
+		uint16_t tag = 0;
+		uint16_t size = 0;
+		zipfile.read(reinterpret_cast<char*>(&tag), sizeof(uint16_t));
+		Utils::SwapByteOrder(tag);
+		zipfile.read(reinterpret_cast<char*>(&size), sizeof(uint16_t));
+		Utils::SwapByteOrder(size);
+		if (!zipfile) {
+			break;
+		}
+
+		if (tag != zip64_extra_field) {
+			zipfile.seekg(size, std::ios_base::cur);
+			continue;
+		}
+
+		auto it = values.begin();
+		for (uint16_t read = 0; it != values.end() && read + 8 <= size; read += 8, ++it) {
+			**it = read_u64(zipfile);
+		}
+		break;
+	}
+
+	zipfile.clear();
+	zipfile.seekg(end);
+}
+
+/**
+ * Streambuf for entries stored without compression.
+ * Reads the entry directly from the archive, large reads bypass the buffer.
+ */
+class ZipStoredStreamBuf : public std::streambuf {
+public:
+	ZipStoredStreamBuf(Filesystem_Stream::InputStream archive, uint64_t data_offset, uint64_t size) :
+		archive(std::move(archive)), data_offset(data_offset), size(size), buffer(buffer_size) {
+		setg(buffer.data(), buffer.data(), buffer.data());
+	}
+	ZipStoredStreamBuf(ZipStoredStreamBuf const& other) = delete;
+	ZipStoredStreamBuf const& operator=(ZipStoredStreamBuf const& other) = delete;
+
+protected:
+	int_type underflow() override {
+		buffer_offset += egptr() - eback();
+		setg(buffer.data(), buffer.data(), buffer.data());
+
+		auto bytes = Read(buffer.data(), std::min<uint64_t>(buffer.size(), size - buffer_offset));
+		if (bytes <= 0) {
+			return traits_type::eof();
+		}
+
+		setg(buffer.data(), buffer.data(), buffer.data() + bytes);
+		return traits_type::to_int_type(*gptr());
+	}
+
+	std::streamsize xsgetn(char* s, std::streamsize count) override {
+		if (count < static_cast<std::streamsize>(buffer.size()) || gptr() != egptr()) {
+			return std::streambuf::xsgetn(s, count);
+		}
+
+		// Large read with an empty buffer: Copy directly into the destination
+		buffer_offset += egptr() - eback();
+		setg(buffer.data(), buffer.data(), buffer.data());
+
+		auto bytes = Read(s, std::min<uint64_t>(count, size - buffer_offset));
+		buffer_offset += bytes;
+		return bytes;
+	}
+
+	std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override {
+		if (dir == std::ios_base::beg) {
+			return seekpos(offset, mode);
+		} else if (dir == std::ios_base::cur) {
+			return seekpos(buffer_offset + (gptr() - eback()) + offset, mode);
+		}
+		return seekpos(size + offset, mode);
+	}
+
+	std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) override {
+		auto off = static_cast<uint64_t>(Utils::Clamp<std::streamoff>(pos, 0, size));
+		if (off >= buffer_offset && off <= buffer_offset + (egptr() - eback())) {
+			setg(eback(), eback() + (off - buffer_offset), egptr());
+		} else {
+			buffer_offset = off;
+			setg(buffer.data(), buffer.data(), buffer.data());
+		}
+		return off;
+	}
+
+private:
+	std::streamsize Read(char* s, uint64_t count) {
+		if (count == 0) {
+			return 0;
+		}
+		archive.clear();
+		archive.seekg(data_offset + buffer_offset);
+		archive.read(s, count);
+		return archive.gcount();
+	}
+
+	static constexpr size_t buffer_size = 16 * 1024;
+
+	Filesystem_Stream::InputStream archive;
+	uint64_t data_offset;
+	uint64_t size;
+	/** Offset in the entry of the first byte in the buffer */
+	uint64_t buffer_offset = 0;
+	std::vector<char> buffer;
+};
+
+/**
+ * Streambuf for deflated entries. Inflates the entry on demand.
+ *
+ * Seeking forward skips over the data by inflating it. Seeking backward restarts
+ * inflating at the closest checkpoint before the target. Checkpoints are recorded
+ * at deflate block boundaries in intervals of checkpoint_span bytes while inflating.
+ */
+class ZipDeflateStreamBuf : public std::streambuf {
+public:
+	ZipDeflateStreamBuf(Filesystem_Stream::InputStream archive, uint64_t data_offset, uint64_t compressed_size, uint64_t uncompressed_size, std::string name) :
+		archive(std::move(archive)), data_offset(data_offset), compressed_size(compressed_size),
+		uncompressed_size(uncompressed_size), name(std::move(name)), in_buffer(in_buffer_size), out_buffer(out_buffer_size) {
+		setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+		ok = inflateInit2(&zlib_stream, -MAX_WBITS) == Z_OK;
+		this->archive.seekg(data_offset);
+	}
+	ZipDeflateStreamBuf(ZipDeflateStreamBuf const& other) = delete;
+	ZipDeflateStreamBuf const& operator=(ZipDeflateStreamBuf const& other) = delete;
+	~ZipDeflateStreamBuf() {
+		if (ok) {
+			inflateEnd(&zlib_stream);
+		}
+	}
+
+	bool IsOk() const {
+		return ok;
+	}
+
+protected:
+	int_type underflow() override {
+		buffer_offset += egptr() - eback();
+		setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+
+		if (!ok || buffer_offset >= uncompressed_size) {
+			return traits_type::eof();
+		}
+
+		if (buffer_offset < out_offset) {
+			Rewind(buffer_offset);
+		}
+
+		// Inflate until the chunk containing the requested position is reached
+		for (;;) {
+			const uint64_t chunk_offset = out_offset;
+			const size_t bytes = Inflate();
+			if (bytes == 0) {
+				return traits_type::eof();
+			}
+
+			if (buffer_offset < out_offset) {
+				setg(out_buffer.data(), out_buffer.data() + (buffer_offset - chunk_offset), out_buffer.data() + bytes);
+				buffer_offset = chunk_offset;
+				return traits_type::to_int_type(*gptr());
+			}
+		}
+	}
+
+	std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override {
+		if (dir == std::ios_base::beg) {
+			return seekpos(offset, mode);
+		} else if (dir == std::ios_base::cur) {
+			return seekpos(buffer_offset + (gptr() - eback()) + offset, mode);
+		}
+		return seekpos(uncompressed_size + offset, mode);
+	}
+
+	std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) override {
+		// Seeking is lazy: The data is only inflated when it is read
+		auto off = static_cast<uint64_t>(Utils::Clamp<std::streamoff>(pos, 0, uncompressed_size));
+		if (off >= buffer_offset && off <= buffer_offset + (egptr() - eback())) {
+			setg(eback(), eback() + (off - buffer_offset), egptr());
+		} else {
+			buffer_offset = off;
+			setg(out_buffer.data(), out_buffer.data(), out_buffer.data());
+		}
+		return off;
+	}
+
+private:
+	struct Checkpoint {
+		/** Offset in the uncompressed data */
+		uint64_t out_offset;
+		/** Offset in the compressed data */
+		uint64_t in_offset;
+		/** Amount of bits of the byte before in_offset that belong to the next block */
+		int bits;
+		/** The last 32 KiB of uncompressed data */
+		std::vector<uint8_t> window;
+	};
+
+	/**
+	 * Inflates the next chunk into out_buffer.
+	 *
+	 * @return amount of inflated bytes, 0 at the end of the data or on error
+	 */
+	size_t Inflate() {
+		zlib_stream.next_out = reinterpret_cast<Bytef*>(out_buffer.data());
+		zlib_stream.avail_out = static_cast<uInt>(out_buffer.size());
+
+		while (zlib_stream.avail_out > 0 && !stream_end) {
+			if (zlib_stream.avail_in == 0) {
+				auto bytes = std::min<uint64_t>(in_buffer.size(), compressed_size - in_offset);
+				archive.read(reinterpret_cast<char*>(in_buffer.data()), bytes);
+				bytes = archive.gcount();
+				in_offset += bytes;
+				zlib_stream.next_in = in_buffer.data();
+				zlib_stream.avail_in = static_cast<uInt>(bytes);
+			}
+
+			const int zlib_error = inflate(&zlib_stream, Z_BLOCK);
+			if (zlib_error == Z_STREAM_END) {
+				stream_end = true;
+				break;
+			} else if (zlib_error != Z_OK) {
+				// Z_BUF_ERROR: No progress possible because the archive is truncated
+				Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+				ok = false;
+				break;
+			}
+
+			// Bit 7: End of a block, Bit 6: End of the last block
+			if ((zlib_stream.data_type & 128) && !(zlib_stream.data_type & 64)) {
+				AddCheckpoint(out_offset + (out_buffer.size() - zlib_stream.avail_out));
+			}
+		}
+
+		const size_t bytes = out_buffer.size() - zlib_stream.avail_out;
+		out_offset += bytes;
+		return bytes;
+	}
+
+	void AddCheckpoint(uint64_t offset) {
+		const uint64_t last_offset = checkpoints.empty() ? 0 : checkpoints.back().out_offset;
+		if (offset < last_offset + checkpoint_span) {
+			return;
+		}
+
+		Checkpoint cp;
+		cp.out_offset = offset;
+		cp.in_offset = in_offset - zlib_stream.avail_in;
+		cp.bits = zlib_stream.data_type & 7;
+		cp.window.resize(32 * 1024);
+		uInt window_size = 0;
+		if (inflateGetDictionary(&zlib_stream, cp.window.data(), &window_size) != Z_OK) {
+			return;
+		}
+		cp.window.resize(window_size);
+		checkpoints.push_back(std::move(cp));
+	}
+
+	/** Restarts inflating at the closest checkpoint before offset */
+	void Rewind(uint64_t offset) {
+		auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), offset, [](uint64_t off, const Checkpoint& cp) {
+			return off < cp.out_offset;
+		});
+
+		inflateReset(&zlib_stream);
+		zlib_stream.avail_in = 0;
+		stream_end = false;
+		archive.clear();
+
+		if (it == checkpoints.begin()) {
+			in_offset = 0;
+			out_offset = 0;
+			archive.seekg(data_offset);
+			return;
+		}
+
+		const auto& cp = *(it - 1);
+		in_offset = cp.in_offset;
+		out_offset = cp.out_offset;
+		archive.seekg(data_offset + cp.in_offset - (cp.bits ? 1 : 0));
+		if (cp.bits) {
+			int c = archive.get();
+			inflatePrime(&zlib_stream, cp.bits, c >> (8 - cp.bits));
+		}
+		inflateSetDictionary(&zlib_stream, cp.window.data(), static_cast<uInt>(cp.window.size()));
+	}
+
+	static constexpr size_t in_buffer_size = 16 * 1024;
+	static constexpr size_t out_buffer_size = 32 * 1024;
+	static constexpr uint64_t checkpoint_span = 1024 * 1024;
+
+	Filesystem_Stream::InputStream archive;
+	uint64_t data_offset;
+	uint64_t compressed_size;
+	uint64_t uncompressed_size;
+	std::string name;
+
+	z_stream zlib_stream = {};
+	bool ok = false;
+	bool stream_end = false;
+	std::vector<Bytef> in_buffer;
+	std::vector<char> out_buffer;
+	/** Amount of compressed bytes read from the archive */
+	uint64_t in_offset = 0;
+	/** Amount of bytes inflated so far */
+	uint64_t out_offset = 0;
+	/** Offset in the entry of the first byte in out_buffer */
+	uint64_t buffer_offset = 0;
+	std::vector<Checkpoint> checkpoints;
+};
+
 ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, std::string_view enc) :
 	Filesystem(base_path, parent_fs) {
 	zip_is = parent_fs.OpenInputStream(GetPath());
@@ -59,9 +399,9 @@ ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, st
 		return;
 	}
 
-	uint16_t central_directory_entries = 0;
-	uint32_t central_directory_size = 0;
-	uint32_t central_directory_offset = 0;
+	uint64_t central_directory_entries = 0;
+	uint64_t central_directory_size = 0;
+	uint64_t central_directory_offset = 0;
 
 	ZipEntry entry = {};
 	entry.is_directory = false;
@@ -207,7 +547,7 @@ ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, st
 	zip_entries_cp437.erase(zip_entries_cp437.begin(), entries_del_it.base());
 }
 
-bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint32_t& offset, uint32_t& size, uint16_t& num_entries) const {
+bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint64_t& offset, uint64_t& size, uint64_t& num_entries) const {
 	uint32_t magic = 0;
 	bool found = false;
 
@@ -235,20 +575,58 @@ bool ZipFilesystem::FindCentralDirectory(std::istream& zipfile, uint32_t& offset
 		}
 	}
 
-	if (found) {
-		zipfile.seekg(-(static_cast<int>(items.size()) - i - 4), std::ios_base::cur); // Move right after the magic
-		zipfile.seekg(6, std::ios_base::cur); // Jump over multiarchive related fields
-		zipfile.read(reinterpret_cast<char*>(&num_entries), sizeof(uint16_t));
-		Utils::SwapByteOrder(num_entries);
-		zipfile.read(reinterpret_cast<char*>(&size), sizeof(uint32_t));
-		Utils::SwapByteOrder(size);
-		zipfile.read(reinterpret_cast<char*>(&offset), sizeof(uint32_t));
-		Utils::SwapByteOrder(offset);
+	if (!found) {
+		return false;
+	}
+
+	zipfile.seekg(-(static_cast<int>(items.size()) - i), std::ios_base::cur); // Move to the magic
+	const std::streamoff eocd_pos = zipfile.tellg();
+	zipfile.seekg(4 + 6, std::ios_base::cur); // Jump over the magic and multiarchive related fields
+
+	uint16_t num_entries16 = 0;
+	uint32_t size32 = 0;
+	uint32_t offset32 = 0;
+	zipfile.read(reinterpret_cast<char*>(&num_entries16), sizeof(uint16_t));
+	Utils::SwapByteOrder(num_entries16);
+	zipfile.read(reinterpret_cast<char*>(&size32), sizeof(uint32_t));
+	Utils::SwapByteOrder(size32);
+	zipfile.read(reinterpret_cast<char*>(&offset32), sizeof(uint32_t));
+	Utils::SwapByteOrder(offset32);
+
+	num_entries = num_entries16;
+	size = size32;
+	offset = offset32;
+
+	if (num_entries16 != 0xFFFF && size32 != 0xFFFFFFFF && offset32 != 0xFFFFFFFF) {
+		return true;
+	}
+
+	// Zip64: The locator is directly in front of the end of central directory
+	if (eocd_pos < zip64_end_of_central_directory_locator_size) {
 		return true;
 	}
-	else {
+	zipfile.seekg(eocd_pos - zip64_end_of_central_directory_locator_size);
+	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	Utils::SwapByteOrder(magic);
+	if (magic != zip64_end_of_central_directory_locator) {
+		return true;
+	}
+	zipfile.seekg(4, std::ios_base::cur); // Jump over multiarchive related fields
+	const uint64_t zip64_eocd_offset = read_u64(zipfile);
+
+	zipfile.seekg(zip64_eocd_offset);
+	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+	Utils::SwapByteOrder(magic);
+	if (magic != zip64_end_of_central_directory) {
+		Output::Debug("ZipFS: Zip64 end of central directory not found");
 		return false;
 	}
+	zipfile.seekg(8 + 2 + 2 + 4 + 4 + 8, std::ios_base::cur); // Jump over size, versions and multiarchive related fields
+	num_entries = read_u64(zipfile);
+	size = read_u64(zipfile);
+	offset = read_u64(zipfile);
+
+	return !zipfile.fail();
 }
 
 bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string& filename, ZipEntry& entry, bool& is_utf8) const {
@@ -257,6 +635,9 @@ bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string
 	uint16_t filepath_length;
 	uint16_t extra_field_length;
 	uint16_t comment_length;
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
+	uint32_t fileoffset;
 
 	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
 	Utils::SwapByteOrder(magic); // Take care of big endian systems
@@ -266,10 +647,10 @@ bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string
 	Utils::SwapByteOrder(flags);
 	is_utf8 = (flags & 0x800) == 0x800;
 	zipfile.seekg(10, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.compressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.compressed_size);
-	zipfile.read(reinterpret_cast<char*>(&entry.uncompressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.uncompressed_size);
+	zipfile.read(reinterpret_cast<char*>(&compressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(compressed_size);
+	zipfile.read(reinterpret_cast<char*>(&uncompressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(uncompressed_size);
 	zipfile.read(reinterpret_cast<char*>(&filepath_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(filepath_length);
 	zipfile.read(reinterpret_cast<char*>(&extra_field_length), sizeof(uint16_t));
@@ -277,15 +658,37 @@ bool ZipFilesystem::ReadCentralDirectoryEntry(std::istream& zipfile, std::string
 	zipfile.read(reinterpret_cast<char*>(&comment_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(comment_length);
 	zipfile.seekg(8, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.fileoffset), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.fileoffset);
+	zipfile.read(reinterpret_cast<char*>(&fileoffset), sizeof(uint32_t));
+	Utils::SwapByteOrder(fileoffset);
 	if (filename_buffer.capacity() < filepath_length + 1u) {
 		filename_buffer.resize(filepath_length + 1u);
 	}
 	zipfile.read(reinterpret_cast<char*>(filename_buffer.data()), filepath_length);
 	filename = std::string(filename_buffer.data(), filepath_length);
-	// Jump over currently not needed entries
-	zipfile.seekg(comment_length + extra_field_length, std::ios_base::cur);
+
+	entry.compressed_size = compressed_size;
+	entry.uncompressed_size = uncompressed_size;
+	entry.fileoffset = fileoffset;
+
+	// Zip64: The real values are in the extra field
+	std::vector<uint64_t*> zip64_values;
+	if (uncompressed_size == 0xFFFFFFFF) {
+		zip64_values.push_back(&entry.uncompressed_size);
+	}
+	if (compressed_size == 0xFFFFFFFF) {
+		zip64_values.push_back(&entry.compressed_size);
+	}
+	if (fileoffset == 0xFFFFFFFF) {
+		zip64_values.push_back(&entry.fileoffset);
+	}
+
+	if (zip64_values.empty()) {
+		// Jump over currently not needed entries
+		zipfile.seekg(comment_length + extra_field_length, std::ios_base::cur);
+	} else {
+		read_zip64_extra_field(zipfile, extra_field_length, zip64_values);
+		zipfile.seekg(comment_length, std::ios_base::cur);
+	}
 	return true;
 }
 
@@ -295,6 +698,8 @@ bool ZipFilesystem::ReadLocalHeader(std::istream& zipfile, StorageMethod& method
 	uint16_t extra_field_length;
 	uint16_t flags;
 	uint16_t compression;
+	uint32_t compressed_size;
+	uint32_t uncompressed_size;
 
 	zipfile.read(reinterpret_cast<char*>(&magic), sizeof(magic));
 	Utils::SwapByteOrder(magic); // Take care of big endian systems
@@ -305,15 +710,24 @@ bool ZipFilesystem::ReadLocalHeader(std::istream& zipfile, StorageMethod& method
 	zipfile.read(reinterpret_cast<char*>(&compression), sizeof(uint16_t));
 	Utils::SwapByteOrder(compression);
 	zipfile.seekg(8, std::ios_base::cur); // Jump over currently not needed entries
-	zipfile.read(reinterpret_cast<char*>(&entry.compressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.compressed_size);
-	zipfile.read(reinterpret_cast<char*>(&entry.uncompressed_size), sizeof(uint32_t));
-	Utils::SwapByteOrder(entry.uncompressed_size);
+	zipfile.read(reinterpret_cast<char*>(&compressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(compressed_size);
+	zipfile.read(reinterpret_cast<char*>(&uncompressed_size), sizeof(uint32_t));
+	Utils::SwapByteOrder(uncompressed_size);
 	zipfile.read(reinterpret_cast<char*>(&filepath_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(filepath_length);
 	zipfile.read(reinterpret_cast<char*>(&extra_field_length), sizeof(uint16_t));
 	Utils::SwapByteOrder(extra_field_length);
 
+	entry.compressed_size = compressed_size;
+	entry.uncompressed_size = uncompressed_size;
+
+	if (compressed_size == 0xFFFFFFFF || uncompressed_size == 0xFFFFFFFF) {
+		// Zip64: The local header always contains both sizes
+		zipfile.seekg(filepath_length, std::ios_base::cur);
+		read_zip64_extra_field(zipfile, extra_field_length, {&entry.uncompressed_size, &entry.compressed_size});
+	}
+
 	switch (compression) {
 	case 0:
 		method = StorageMethod::Plain;
@@ -389,17 +803,30 @@ std::streambuf* ZipFilesystem::CreateInputStreambuffer(std::string_view path, st
 				}
 			}
 
-			if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
-				Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
-				return nullptr;
-			}
+			const uint64_t data_offset = central_entry->fileoffset + local_entry.fileoffset;
 
-			zip_is.seekg(central_entry->fileoffset + local_entry.fileoffset);
 			if (method == StorageMethod::Plain) {
-				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
-				zip_is.read(reinterpret_cast<char*>(data.data()), data.size());
-				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
+				auto archive = GetParent().OpenInputStream(GetPath());
+				if (!archive) {
+					return nullptr;
+				}
+				return new ZipStoredStreamBuf(std::move(archive), data_offset, local_entry.uncompressed_size);
 			} else if (method == StorageMethod::Deflate) {
+				if (local_entry.uncompressed_size > max_inflate_in_memory) {
+					auto archive = GetParent().OpenInputStream(GetPath());
+					if (!archive) {
+						return nullptr;
+					}
+					auto sb = std::make_unique<ZipDeflateStreamBuf>(std::move(archive), data_offset,
+						local_entry.compressed_size, local_entry.uncompressed_size, path_normalized);
+					if (!sb->IsOk()) {
+						Output::Warning("ZipFS: zlib initialization failed for {}", path_normalized);
+						return nullptr;
+					}
+					return sb.release();
+				}
+
+				zip_is.seekg(data_offset);
 				std::vector<uint8_t> comp_buf;
 				comp_buf.resize(local_entry.compressed_size);
 				zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
@@ -56,13 +56,13 @@ protected:
 private:
 	enum class StorageMethod {Unknown, Plain, Deflate};
 	struct ZipEntry {
-		uint32_t compressed_size;
-		uint32_t uncompressed_size;
-		uint32_t fileoffset;
+		uint64_t compressed_size;
+		uint64_t uncompressed_size;
+		uint64_t fileoffset;
 		bool is_directory;
 	};
 
-	bool FindCentralDirectory(std::istream& stream, uint32_t& offset, uint32_t& size, uint16_t& num_entries) const;
+	bool FindCentralDirectory(std::istream& stream, uint64_t& offset, uint64_t& size, uint64_t& num_entries) const;
 	bool ReadCentralDirectoryEntry(std::istream& zipfile, std::string& filepath, ZipEntry& entry, bool& is_utf8) const;
 	bool ReadLocalHeader(std::istream& zipfile, StorageMethod& method, ZipEntry& entry) const;
 	const ZipEntry* Find(std::string_view what) const;
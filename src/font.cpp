@@ -140,6 +140,11 @@ namespace {
 		mutable BitmapRef glyph_bm;
 	}; // class BitmapFont
 
+	/** Edge length of the atlas bitmaps of the glyph cache */
+	constexpr int glyph_atlas_size = 256;
+	size_t glyph_cache_limit = 1024 * 1024;
+	size_t shape_cache_limit = 256;
+
 #ifdef HAVE_FREETYPE
 	FT_Library library = nullptr;
 
@@ -158,7 +163,21 @@ namespace {
 		void vApplyStyle(const Style& style) override;
 
 	private:
+		/** Location and metrics of a rendered glyph */
+		struct CachedGlyph {
+			/** Atlas containing the glyph or an own bitmap when it does not fit into an atlas */
+			BitmapRef bitmap;
+			Rect rect;
+			Point advance;
+			Point offset;
+			bool has_color = false;
+		};
+
 		void SetSize(int height, bool create);
+		bool IsGlyphCacheEnabled() const;
+		uint64_t GetGlyphCacheKey(uint32_t glyph) const;
+		void AllocateGlyph(int width, int height, CachedGlyph& cached) const;
+		void ClearGlyphCache() const;
 
 		FT_Face face = nullptr;
 		std::vector<uint8_t> ft_buffer;
@@ -168,6 +187,19 @@ namespace {
 		/** Workaround for bad kerning in RM2000 and RMG2000 fonts */
 		bool rm2000_workaround = false;
 
+		/** Rendered glyphs, key is glyph index, size and style (see GetGlyphCacheKey) */
+		mutable std::unordered_map<uint64_t, CachedGlyph> glyph_cache;
+		/** Advance of measured characters, key is codepoint, size and style */
+		mutable std::unordered_map<uint64_t, Point> advance_cache;
+		/** Atlas new glyphs are packed into. Filled atlases are kept alive by the cached glyphs */
+		mutable BitmapRef atlas;
+		/** Memory used by the glyph cache, see Font::SetGlyphCacheLimit */
+		mutable size_t glyph_cache_bytes = 0;
+		/** Shelf packing state of the atlas */
+		mutable int atlas_x = 0;
+		mutable int atlas_y = 0;
+		mutable int atlas_row_height = 0;
+
 #ifdef HAVE_HARFBUZZ
 		hb_buffer_t* hb_buffer = nullptr;
 		hb_font_t* hb_font = nullptr;
@@ -340,6 +372,16 @@ bool FTFont::IsOk() const {
 }
 
 Rect FTFont::vGetSize(char32_t glyph) const {
+	const bool use_cache = IsGlyphCacheEnabled();
+	const uint64_t key = GetGlyphCacheKey(glyph);
+
+	if (use_cache) {
+		auto it = advance_cache.find(key);
+		if (it != advance_cache.end()) {
+			return {0, 0, it->second.x, it->second.y};
+		}
+	}
+
 	auto glyph_index = FT_Get_Char_Index(face, glyph);
 
 	if (glyph_index == 0) {
@@ -388,6 +430,10 @@ Rect FTFont::vGetSize(char32_t glyph) const {
 		advance.x = 6;
 	}
 
+	if (use_cache) {
+		advance_cache[key] = advance;
+	}
+
 	return {0, 0, advance.x, advance.y};
 }
 
@@ -414,6 +460,17 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 		}
 	}
 
+	const bool use_cache = IsGlyphCacheEnabled();
+	const uint64_t key = GetGlyphCacheKey(glyph);
+
+	if (use_cache) {
+		auto it = glyph_cache.find(key);
+		if (it != glyph_cache.end()) {
+			const auto& cached = it->second;
+			return { cached.bitmap, cached.advance, cached.offset, cached.has_color, cached.rect };
+		}
+	}
+
 	auto render_glyph = [&](auto flags, auto mode) {
 		if (FT_Load_Glyph(face, glyph, flags) != FT_Err_Ok) {
 			Output::Debug("Couldn't load FreeType character {:#x}", uint32_t(glyph));
@@ -458,39 +515,114 @@ Font::GlyphRet FTFont::vRenderShaped(char32_t glyph) const {
 	const int width = ft_bitmap->width;
 	const int height = ft_bitmap->rows;
 
-	BitmapRef bm;
-	bool has_color = false;
+	CachedGlyph cached;
+	cached.advance.x = Utils::RoundTo<int>(slot->advance.x / 64.0);
+	cached.advance.y = Utils::RoundTo<int>(slot->advance.y / 64.0);
+	cached.offset.x = slot->bitmap_left;
+	cached.offset.y = slot->bitmap_top - baseline_offset;
+	cached.has_color = ft_bitmap->pixel_mode == FT_PIXEL_MODE_BGRA;
+
+	if (EP_UNLIKELY(rm2000_workaround)) {
+		cached.advance.x = 6;
+	}
+
+	if (use_cache) {
+		AllocateGlyph(width, height, cached);
+	} else {
+		cached.bitmap = Bitmap::Create(width, height);
+		cached.rect = cached.bitmap->GetRect();
+	}
 
-	if (ft_bitmap->pixel_mode == FT_PIXEL_MODE_BGRA) {
-		bm = Bitmap::Create(ft_bitmap->buffer, width, height, 0, format_B8G8R8A8_a().format());
-		has_color = true;
+	Bitmap& bm = *cached.bitmap;
+	const Rect& dst_rect = cached.rect;
+
+	if (cached.has_color) {
+		auto color_bm = Bitmap::Create(ft_bitmap->buffer, width, height, 0, format_B8G8R8A8_a().format());
+		bm.Blit(dst_rect.x, dst_rect.y, *color_bm, color_bm->GetRect(), Opacity::Opaque());
 	} else {
-		bm = Bitmap::Create(width, height);
-		auto* data = reinterpret_cast<uint32_t*>(bm->pixels());
+		auto* pixels = reinterpret_cast<uint8_t*>(bm.pixels());
+		const int bm_pitch = bm.pitch();
 
 		for (int row = 0; row < height; ++row) {
+			auto* data = reinterpret_cast<uint32_t*>(pixels + (dst_rect.y + row) * bm_pitch) + dst_rect.x;
 			for (int col = 0; col < width; ++col) {
 				unsigned c = ft_bitmap->buffer[pitch * row + (col / 8)];
 				unsigned bit = 7 - (col % 8);
 				c = c & (0x01 << bit) ? 255 : 0;
-				data[row * width + col] = (c << 24) + (c << 16) + (c << 8) + c;
+				data[col] = (c << 24) + (c << 16) + (c << 8) + c;
 			}
 		}
 	}
 
-	Point advance;
-	Point offset;
+	if (use_cache) {
+		glyph_cache[key] = cached;
+	}
 
-	advance.x = Utils::RoundTo<int>(slot->advance.x / 64.0);
-	advance.y = Utils::RoundTo<int>(slot->advance.y / 64.0);
-	offset.x = slot->bitmap_left;
-	offset.y = slot->bitmap_top - baseline_offset;
+	return { cached.bitmap, cached.advance, cached.offset, cached.has_color, cached.rect };
+}
 
-	if (EP_UNLIKELY(rm2000_workaround)) {
-		advance.x = 6;
+bool FTFont::IsGlyphCacheEnabled() const {
+	return glyph_cache_limit >= static_cast<size_t>(glyph_atlas_size * glyph_atlas_size * 4);
+}
+
+uint64_t FTFont::GetGlyphCacheKey(uint32_t glyph) const {
+	return (static_cast<uint64_t>(current_style.size & 0xFFFF) << 34)
+		| (static_cast<uint64_t>(current_style.bold) << 33)
+		| (static_cast<uint64_t>(current_style.italic) << 32)
+		| glyph;
+}
+
+void FTFont::AllocateGlyph(int width, int height, CachedGlyph& cached) const {
+	constexpr size_t atlas_bytes = glyph_atlas_size * glyph_atlas_size * 4;
+
+	if (width <= 0 || height <= 0 || width > glyph_atlas_size || height > glyph_atlas_size) {
+		// Empty or too large for the atlas: Use an own bitmap
+		const size_t bytes = static_cast<size_t>(std::max(width, 0)) * std::max(height, 0) * 4;
+		if (glyph_cache_bytes + bytes > glyph_cache_limit) {
+			ClearGlyphCache();
+		}
+
+		cached.bitmap = Bitmap::Create(width, height);
+		cached.rect = cached.bitmap->GetRect();
+		glyph_cache_bytes += bytes;
+		return;
+	}
+
+	if (atlas && atlas_x + width > glyph_atlas_size) {
+		// Start a new shelf
+		atlas_x = 0;
+		atlas_y += atlas_row_height;
+		atlas_row_height = 0;
+	}
+
+	if (!atlas || atlas_y + height > glyph_atlas_size) {
+		if (glyph_cache_bytes + atlas_bytes > glyph_cache_limit) {
+			// Budget exhausted: Start over. Atlases still referenced by a GlyphRet stay alive.
+			ClearGlyphCache();
+		}
+
+		atlas = Bitmap::Create(glyph_atlas_size, glyph_atlas_size);
+		atlas_x = 0;
+		atlas_y = 0;
+		atlas_row_height = 0;
+		glyph_cache_bytes += atlas_bytes;
 	}
 
-	return { bm, advance, offset, has_color };
+	cached.bitmap = atlas;
+	cached.rect = { atlas_x, atlas_y, width, height };
+
+	atlas_x += width;
+	atlas_row_height = std::max(atlas_row_height, height);
+}
+
+void FTFont::ClearGlyphCache() const {
+	glyph_cache.clear();
+	advance_cache.clear();
+	atlas.reset();
+	atlas_x = 0;
+	atlas_y = 0;
+	atlas_row_height = 0;
+	glyph_cache_bytes = 0;
 }
 
 bool FTFont::vCanShape() const {
@@ -668,6 +800,22 @@ FontRef Font::CreateFtFont(Filesystem_Stream::InputStream is, int size, bool bol
 #endif
 }
 
+void Font::SetGlyphCacheLimit(size_t bytes) {
+	glyph_cache_limit = bytes;
+}
+
+size_t Font::GetGlyphCacheLimit() {
+	return glyph_cache_limit;
+}
+
+void Font::SetShapeCacheLimit(size_t entries) {
+	shape_cache_limit = entries;
+}
+
+size_t Font::GetShapeCacheLimit() {
+	return shape_cache_limit;
+}
+
 void Font::ResetDefault() {
 	SetDefault(nullptr, true);
 	SetDefault(nullptr, false);
@@ -773,7 +921,12 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 		return false;
 	}
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
+	// Area of the glyph in the source bitmap
+	const Rect src_rect = gret.rect.IsEmpty() ? gret.bitmap->GetRect() : gret.rect;
+	const int mask_x = src_rect.x;
+	const int mask_y = src_rect.y;
+
+	auto rect = Rect(x, y, src_rect.width, src_rect.height);
 	if (EP_UNLIKELY(rect.width == 0)) {
 		return false;
 	}
@@ -785,7 +938,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 	unsigned src_x = 0;
 	unsigned src_y = 0;
 
-	int glyph_height = gret.bitmap->height() - gret.offset.y;
+	int glyph_height = src_rect.height - gret.offset.y;
 
 	// Adjust how the mask is applied depending on the glyph size to prevent that
 	// pixels from outside of the mask color are read
@@ -811,7 +964,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 			// First draw the shadow, offset by one
 			if (!gret.has_color && current_style.draw_shadow) {
 				auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-				dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, *sys_large, 0, 0);
+				dest.MaskedBlit(shadow_rect, *gret.bitmap, mask_x, mask_y, *sys_large, 0, 0);
 			}
 
 			src_x = current_style.size;
@@ -820,15 +973,15 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 
 		if (!gret.has_color) {
 			if (current_style.draw_gradient) {
-				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *sys_large, src_x, src_y);
+				dest.MaskedBlit(rect, *gret.bitmap, mask_x, mask_y, *sys_large, src_x, src_y);
 			} else {
 				auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-				auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+				auto col_bm = Bitmap::Create(src_rect.width, src_rect.height, col);
+				dest.MaskedBlit(rect, *gret.bitmap, mask_x, mask_y, *col_bm, 0, 0);
 			}
 		} else {
 			// Color glyphs, emojis etc.
-			dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+			dest.Blit(rect.x, rect.y, *gret.bitmap, src_rect, Opacity::Opaque());
 		}
 
 		return true;
@@ -839,7 +992,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 		// First draw the shadow, offset by one
 		if (!gret.has_color && current_style.draw_shadow) {
 			auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-			dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, sys, 16, 32);
+			dest.MaskedBlit(shadow_rect, *gret.bitmap, mask_x, mask_y, sys, 16, 32);
 		}
 
 		src_x = color % 10 * 16 + 2;
@@ -859,15 +1012,15 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 				src_y -= glyph_height - 12;
 			}
 
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
+			dest.MaskedBlit(rect, *gret.bitmap, mask_x, mask_y, sys, src_x, src_y);
 		} else {
 			auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-			auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+			auto col_bm = Bitmap::Create(src_rect.width, src_rect.height, col);
+			dest.MaskedBlit(rect, *gret.bitmap, mask_x, mask_y, *col_bm, 0, 0);
 		}
 	} else {
 		// Color glyphs, emojis etc.
-		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+		dest.Blit(rect.x, rect.y, *gret.bitmap, src_rect, Opacity::Opaque());
 	}
 
 	return true;
@@ -883,8 +1036,9 @@ Point Font::Render(Bitmap& dest, int x, int y, Color const& color, char32_t glyp
 		return {};
 	}
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
-	dest.MaskedBlit(rect, *gret.bitmap, 0, 0, color);
+	const Rect src_rect = gret.rect.IsEmpty() ? gret.bitmap->GetRect() : gret.rect;
+	auto rect = Rect(x, y, src_rect.width, src_rect.height);
+	dest.MaskedBlit(rect, *gret.bitmap, src_rect.x, src_rect.y, color);
 
 	gret.advance.x += current_style.letter_spacing;
 
@@ -898,11 +1052,35 @@ bool Font::CanShape() const {
 std::vector<Font::ShapeRet> Font::Shape(std::u32string_view text) const {
 	assert(vCanShape());
 
-	return vShape(text);
+	if (shape_cache_limit == 0) {
+		return vShape(text);
+	}
+
+	// Everything of the style that can change the shaping result
+	std::u32string key;
+	key.reserve(text.size() + 2);
+	key.push_back(static_cast<char32_t>(current_style.size));
+	key.push_back(static_cast<char32_t>((current_style.bold ? 1 : 0) | (current_style.italic ? 2 : 0)));
+	key.append(text.begin(), text.end());
+
+	auto it = shape_cache.find(key);
+	if (it != shape_cache.end()) {
+		return it->second;
+	}
+
+	if (shape_cache.size() >= shape_cache_limit) {
+		shape_cache.clear();
+	}
+
+	auto ret = vShape(text);
+	shape_cache.emplace(std::move(key), ret);
+	return ret;
 }
 
 void Font::SetFallbackFont(FontRef fallback_font) {
 	this->fallback_font = fallback_font;
+	// Metrics of glyphs not found in this font are provided by the fallback font
+	shape_cache.clear();
 }
 
 bool Font::IsStyleApplied() const {
@@ -26,6 +26,8 @@
 #include "rect.h"
 #include "string_view.h"
 #include <string>
+#include <unordered_map>
+#include <vector>
 #include <lcf/scope_guard.h>
 
 class Color;
@@ -55,6 +57,11 @@ class Font {
 		Point offset;
 		/** When enabled the glyph is colored and not masked with the system graphic */
 		bool has_color = false;
+		/**
+		 * Area of the bitmap that contains the glyph.
+		 * When empty the whole bitmap is used. Set for glyphs located in a glyph atlas.
+		 */
+		Rect rect;
 	};
 
 	/** Contains metrics of a glyph shaped by Harfbuzz */
@@ -228,6 +235,32 @@ class Font {
 	 * @return font handle or nullptr on failure or if FreeType is unavailable
 	 */
 	static FontRef CreateFtFont(Filesystem_Stream::InputStream is, int size, bool bold, bool italic);
+
+	/**
+	 * Sets the memory budget of the glyph cache of each FreeType font.
+	 * Rendered glyphs are packed into atlas bitmaps. When a new atlas would
+	 * exceed the budget all cached glyphs of the font are discarded.
+	 * A budget smaller than one atlas disables the glyph cache.
+	 *
+	 * @param bytes budget in bytes
+	 */
+	static void SetGlyphCacheLimit(size_t bytes);
+
+	/** @return memory budget of the glyph cache in bytes */
+	static size_t GetGlyphCacheLimit();
+
+	/**
+	 * Sets how many results of Shape are memoized per font.
+	 * When the limit is reached the memoized results are discarded.
+	 * 0 disables memoization.
+	 *
+	 * @param entries amount of shaped strings to keep
+	 */
+	static void SetShapeCacheLimit(size_t entries);
+
+	/** @return amount of shaped strings memoized per font */
+	static size_t GetShapeCacheLimit();
+
 	static FontRef Default();
 	static FontRef Default(bool use_mincho);
 	static FontRef DefaultBitmapFont();
@@ -264,6 +297,9 @@ class Font {
 	FontRef fallback_font;
 
 private:
+	/** Memoized results of Shape, the key is the font size followed by the text */
+	mutable std::unordered_map<std::u32string, std::vector<ShapeRet>> shape_cache;
+
 	bool RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, const GlyphRet& gret) const;
 };
 
@@ -24,6 +24,7 @@
 #include "input.h"
 #include "font.h"
 #include "drawable_mgr.h"
+#include "player.h"
 
 using namespace std::chrono_literals;
 
@@ -109,3 +110,22 @@ void FpsOverlay::Draw(Bitmap& dst) {
 	}
 }
 
+bool FpsOverlay::GetDamage(DamageInfo& info) const {
+	// The bitmaps are only rendered in Draw, the size is calculated from the text
+	info.rect = {};
+
+	if (draw_fps) {
+		Rect rect = Text::GetSize(*Font::DefaultBitmapFont(), text);
+		info.rect.Merge({ 1, 2, rect.width + 1, rect.height - 1 });
+		info.Hash(std::hash<std::string>()(text));
+	}
+
+	if (last_speed_mod > 1) {
+		Rect rect = Text::GetSize(*Font::DefaultBitmapFont(), "> x" + std::to_string(last_speed_mod));
+		info.rect.Merge({ Player::screen_width - rect.width - 2, 2, rect.width + 1, rect.height - 1 });
+		info.Hash(last_speed_mod);
+	}
+
+	info.Hash(draw_fps);
+	return true;
+}
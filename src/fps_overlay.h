@@ -35,6 +35,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(DamageInfo& info) const override;
+
 	/**
 	 * Update the fps overlay.
 	 *
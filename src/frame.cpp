@@ -47,6 +47,16 @@ void Frame::Draw(Bitmap& dst) {
 	}
 }
 
+bool Frame::GetDamage(DamageInfo& info) const {
+	info.rect = {};
+	if (frame_bitmap) {
+		info.rect = frame_bitmap->GetRect();
+		info.Hash(frame_bitmap.get());
+		info.Hash(frame_bitmap->GetRevision());
+	}
+	return true;
+}
+
 void Frame::OnFrameGraphicReady(FileRequestResult* result) {
 	frame_bitmap = Cache::Frame(result->file);
 }
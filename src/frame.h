@@ -32,6 +32,8 @@ public:
 	Frame();
 
 	void Draw(Bitmap& dst) override;
+
+	bool GetDamage(DamageInfo& info) const override;
 	void Update();
 
 private:
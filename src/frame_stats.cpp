@@ -0,0 +1,89 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "frame_stats.h"
+#include <algorithm>
+#include <fmt/format.h>
+
+void FrameStats::Add(duration update, duration draw) {
+	update_times.push_back(update);
+	draw_times.push_back(draw);
+}
+
+FrameStats::Summary FrameStats::GetUpdateSummary() const {
+	return Summarize(update_times);
+}
+
+FrameStats::Summary FrameStats::GetDrawSummary() const {
+	return Summarize(draw_times);
+}
+
+FrameStats::Summary FrameStats::GetTotalSummary() const {
+	std::vector<duration> total_times(update_times.size());
+	for (size_t i = 0; i < total_times.size(); ++i) {
+		total_times[i] = update_times[i] + draw_times[i];
+	}
+	return Summarize(std::move(total_times));
+}
+
+FrameStats::Summary FrameStats::Summarize(std::vector<duration> times) {
+	Summary summary;
+	if (times.empty()) {
+		return summary;
+	}
+
+	std::sort(times.begin(), times.end());
+
+	// Nearest rank percentile
+	auto percentile = [&](int p) {
+		size_t rank = (times.size() * p + 99) / 100;
+		return times[std::max<size_t>(rank, 1) - 1];
+	};
+
+	summary.min = times.front();
+	summary.max = times.back();
+	for (auto& t: times) {
+		summary.total += t;
+	}
+	summary.mean = summary.total / static_cast<duration::rep>(times.size());
+	summary.p50 = percentile(50);
+	summary.p95 = percentile(95);
+	summary.p99 = percentile(99);
+
+	return summary;
+}
+
+std::string FrameStats::GetReport() const {
+	auto ms = [](duration d) {
+		return std::chrono::duration<double, std::milli>(d).count();
+	};
+
+	std::string report = fmt::format("Frames: {}\n", GetFrames());
+	report += fmt::format("{:<8}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}{:>12}\n",
+		"(ms)", "min", "mean", "p50", "p95", "p99", "max", "total");
+
+	auto add_row = [&](const char* name, const Summary& s) {
+		report += fmt::format("{:<8}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}{:>10.3f}{:>12.1f}\n",
+			name, ms(s.min), ms(s.mean), ms(s.p50), ms(s.p95), ms(s.p99), ms(s.max), ms(s.total));
+	};
+	add_row("update", GetUpdateSummary());
+	add_row("draw", GetDrawSummary());
+	add_row("total", GetTotalSummary());
+
+	return report;
+}
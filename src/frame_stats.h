@@ -0,0 +1,85 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_FRAME_STATS_H
+#define EP_FRAME_STATS_H
+
+// Headers
+#include <chrono>
+#include <string>
+#include <vector>
+
+/**
+ * Collects the time spent per frame in the update and in the draw step.
+ * Used by the headless mode to benchmark whole playthroughs.
+ */
+class FrameStats {
+public:
+	using duration = std::chrono::nanoseconds;
+
+	/** Statistics of one series of frame times */
+	struct Summary {
+		duration min = {};
+		duration max = {};
+		duration mean = {};
+		duration p50 = {};
+		duration p95 = {};
+		duration p99 = {};
+		duration total = {};
+	};
+
+	/**
+	 * Adds the timing of one frame.
+	 *
+	 * @param update time spent for updating the scene
+	 * @param draw time spent for drawing the screen
+	 */
+	void Add(duration update, duration draw);
+
+	/** @return amount of added frames */
+	int GetFrames() const;
+
+	/** @return statistics of the update times */
+	Summary GetUpdateSummary() const;
+
+	/** @return statistics of the draw times */
+	Summary GetDrawSummary() const;
+
+	/** @return statistics of the sum of update and draw times */
+	Summary GetTotalSummary() const;
+
+	/** @return human readable table of all statistics */
+	std::string GetReport() const;
+
+	/**
+	 * Calculates the statistics of a series of frame times.
+	 *
+	 * @param times frame times, sorted by this function
+	 * @return statistics, all zero when times is empty
+	 */
+	static Summary Summarize(std::vector<duration> times);
+
+private:
+	std::vector<duration> update_times;
+	std::vector<duration> draw_times;
+};
+
+inline int FrameStats::GetFrames() const {
+	return static_cast<int>(update_times.size());
+}
+
+#endif
@@ -998,18 +998,10 @@ inline int Game_Character::GetX() const {
 	return data()->position_x;
 }
 
-inline void Game_Character::SetX(int new_x) {
-	data()->position_x = new_x;
-}
-
 inline int Game_Character::GetY() const {
 	return data()->position_y;
 }
 
-inline void Game_Character::SetY(int new_y) {
-	data()->position_y = new_y;
-}
-
 inline int Game_Character::GetMapId() const {
 	return data()->map_id;
 }
@@ -32,7 +32,11 @@ Game_Clock::duration Game_Clock::OnNextFrame(time_point now) {
 
 	const auto dt = now - data.frame_time;
 	data.frame_time = now;
-	data.frame_accumulator += std::chrono::duration_cast<duration>(dt * data.speed);
+	if (data.fixed_time_step) {
+		data.frame_accumulator += std::chrono::duration_cast<duration>(GetTargetGameTimeStep() * data.speed);
+	} else {
+		data.frame_accumulator += std::chrono::duration_cast<duration>(dt * data.speed);
+	}
 	data.frame_accumulator = std::min(data.frame_accumulator, mfa);
 
 	const auto fps = (1.0f / std::chrono::duration<float>(dt).count());
@@ -76,6 +76,15 @@ public:
 	/** @return the speed up or slowdown factor we'll use to run the game. */
 	static float GetGameSpeedFactor();
 
+	/**
+	 * Enables a fixed time step. Every frame then runs exactly one simulation
+	 * step independent of the real time that passed. Used to run the game
+	 * deterministically and as fast as possible.
+	 *
+	 * @param fixed enable fixed time step
+	 */
+	static void SetFixedTimeStep(bool fixed);
+
 	/** Get the time of the current frame */
 	static time_point GetFrameTime();
 
@@ -117,6 +126,7 @@ private:
 		float speed = 1.0;
 		float fps = 0.0;
 		int frame = 0;
+		bool fixed_time_step = false;
 	};
 	static Data data;
 };
@@ -180,4 +190,8 @@ inline float Game_Clock::GetGameSpeedFactor() {
 	return data.speed;
 }
 
+inline void Game_Clock::SetFixedTimeStep(bool fixed) {
+	data.fixed_time_step = fixed;
+}
+
 #endif
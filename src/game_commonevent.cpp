@@ -93,6 +93,13 @@ std::vector<lcf::rpg::EventCommand>& Game_CommonEvent::GetList() {
 	return lcf::ReaderUtil::GetElement(lcf::Data::commonevents, common_event_id)->event_commands;
 }
 
+std::shared_ptr<const Game_Interpreter_JumpTable> Game_CommonEvent::GetJumpTable() {
+	if (!jump_table) {
+		jump_table = std::make_shared<const Game_Interpreter_JumpTable>(GetList());
+	}
+	return jump_table;
+}
+
 lcf::rpg::SaveEventExecState Game_CommonEvent::GetSaveData() {
 	lcf::rpg::SaveEventExecState state;
 	if (interpreter) {
@@ -104,6 +104,14 @@ public:
 	 */
 	std::vector<lcf::rpg::EventCommand>& GetList();
 
+	/**
+	 * Returns the jump table of the event commands.
+	 * The table is built on first use and shared by all runs of the event.
+	 *
+	 * @return jump table
+	 */
+	std::shared_ptr<const Game_Interpreter_JumpTable> GetJumpTable();
+
 	lcf::rpg::SaveEventExecState GetSaveData();
 
 	/** @return true if waiting for foreground execution */
@@ -121,6 +129,8 @@ private:
 	/** Interpreter for parallel common events. */
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
 
+	std::shared_ptr<const Game_Interpreter_JumpTable> jump_table;
+
 	friend class Game_Interpreter_Inspector;
 };
 
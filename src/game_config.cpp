@@ -273,6 +273,22 @@ FilesystemView Game_Config::GetFontFilesystem() {
 	return FileFinder::Root().Create(path);
 }
 
+FilesystemView Game_Config::GetCacheFilesystem() {
+	auto config_fs = GetGlobalConfigFilesystem();
+	if (!config_fs) {
+		return {};
+	}
+
+	std::string path = FileFinder::MakePath(config_fs.GetFullPath(), "Cache");
+
+	if (!FileFinder::Root().MakeDirectory(path, true)) {
+		Output::Warning("Could not create cache path {}", path);
+		return {};
+	}
+
+	return FileFinder::Root().Create(path);
+}
+
 Filesystem_Stream::OutputStream Game_Config::GetGlobalConfigFileOutput() {
 	auto fs = GetGlobalConfigFilesystem();
 
@@ -559,6 +575,12 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--image-cache-size")) {
+			if (arg.ParseValue(0, li_value)) {
+				player.image_cache_size.Set(li_value);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--soundfont-path")) {
 			if (arg.NumValues() > 0) {
 				soundfont_path = FileFinder::MakeCanonical(arg.Value(0), 0);
@@ -683,6 +705,7 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	player.screenshot_timestamp.FromIni(ini);
 	player.automatic_screenshots.FromIni(ini);
 	player.automatic_screenshots_interval.FromIni(ini);
+	player.image_cache_size.FromIni(ini);
 }
 
 void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
@@ -776,6 +799,7 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	player.screenshot_timestamp.ToIni(os);
 	player.automatic_screenshots.ToIni(os);
 	player.automatic_screenshots_interval.ToIni(os);
+	player.image_cache_size.ToIni(os);
 
 	os << "\n";
 }
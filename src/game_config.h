@@ -108,6 +108,7 @@ struct Game_ConfigPlayer {
 	BoolConfigParam screenshot_timestamp{ "Screenshot timestamp", "Add the current date and time to the file name", "Player", "ScreenshotTimestamp", true };
 	BoolConfigParam automatic_screenshots{ "Automatic screenshots", "Periodically take screenshots", "Player", "AutomaticScreenshots", false };
 	RangeConfigParam<int> automatic_screenshots_interval{ "Screenshot interval", "The interval between automatic screenshots (seconds)", "Player", "AutomaticScreenshotsInterval", 30, 1, 999999 };
+	RangeConfigParam<int> image_cache_size{ "Image cache size", "Memory for keeping unused images loaded (MiB)", "Player", "ImageCacheSize", 10, 1, 1024 };
 
 	void Hide();
 };
@@ -207,6 +208,12 @@ struct Game_Config {
 	 */
 	static FilesystemView GetFontFilesystem();
 
+	/**
+	 * Returns the filesystem view to the cache directory
+	 * This is config/Cache
+	 */
+	static FilesystemView GetCacheFilesystem();
+
 	/**
 	 * Returns a handle to the global config file for reading.
 	 * The file is created if it does not exist.
@@ -148,16 +148,18 @@ static bool CompareMoveRouteCommandCodes(const lcf::rpg::MoveRoute& l, const lcf
 	return true;
 }
 
-void Game_Event::RefreshPage() {
-	const lcf::rpg::EventPage* new_page = nullptr;
+const lcf::rpg::EventPage* Game_Event::FindActivePage() {
 	for (auto i = event->pages.crbegin(); i != event->pages.crend(); ++i) {
 		// Loop in reverse order to see whether any page meets conditions...
 		if (AreConditionsMet(*i)) {
-			new_page = &(*i);
-			// Stop looking for more...
-			break;
+			return &(*i);
 		}
 	}
+	return nullptr;
+}
+
+void Game_Event::RefreshPage() {
+	const lcf::rpg::EventPage* new_page = FindActivePage();
 
 	if (!new_page) {
 		ClearWaitingForegroundExecution();
@@ -615,6 +617,21 @@ const lcf::rpg::EventPage* Game_Event::GetPage(int page) const {
 	return &event->pages[page - 1];
 }
 
+std::shared_ptr<const Game_Interpreter_JumpTable> Game_Event::GetJumpTable(const lcf::rpg::EventPage& page) const {
+	const auto index = static_cast<size_t>(&page - event->pages.data());
+	assert(index < event->pages.size());
+
+	if (jump_tables.size() != event->pages.size()) {
+		jump_tables.resize(event->pages.size());
+	}
+
+	auto& table = jump_tables[index];
+	if (!table) {
+		table = std::make_shared<const Game_Interpreter_JumpTable>(page.event_commands);
+	}
+	return table;
+}
+
 const lcf::rpg::EventPage *Game_Event::GetActivePage() const {
 	return page;
 }
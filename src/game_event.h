@@ -43,6 +43,7 @@ public:
 	/** @param ev Event referenced */
 	void SetUnderlyingEvent(const lcf::rpg::Event* ev) {
 		event = ev;
+		jump_tables.clear();
 	}
 
 	/** Load from saved game */
@@ -66,6 +67,13 @@ public:
 	 */
 	void RefreshPage();
 
+	/**
+	 * Evaluates the page conditions without changing the event.
+	 *
+	 * @return the page RefreshPage would activate or nullptr if no page matches
+	 */
+	const lcf::rpg::EventPage* FindActivePage();
+
 	/**
 	 * Gets event ID.
 	 *
@@ -166,6 +174,15 @@ public:
 	/** @returns the number of pages this event has */
 	int GetNumPages() const;
 
+	/**
+	 * Returns the jump table of the commands of a page.
+	 * The table is built on first use and shared by all runs of the page.
+	 *
+	 * @param page page of this event
+	 * @return jump table
+	 */
+	std::shared_ptr<const Game_Interpreter_JumpTable> GetJumpTable(const lcf::rpg::EventPage& page) const;
+
 protected:
 	/** Check for and fix incorrect data after loading save game */
 	void SanitizeData();
@@ -218,6 +235,8 @@ private:
 	const lcf::rpg::Event* event = nullptr;
 	const lcf::rpg::EventPage* page = nullptr;
 	std::unique_ptr<Game_Interpreter_Map> interpreter;
+	/** Jump tables of the pages, indexed like the pages of event */
+	mutable std::vector<std::shared_ptr<const Game_Interpreter_JumpTable>> jump_tables;
 
 	friend class Game_Interpreter_Inspector;
 };
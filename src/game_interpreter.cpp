@@ -51,11 +51,13 @@
 #include "sprite_character.h"
 #include "scene_gameover.h"
 #include "scene_map.h"
+#include "save_writer.h"
 #include "scene_save.h"
 #include "scene_settings.h"
 #include "scene.h"
 #include "game_clock.h"
 #include "input.h"
+#include "instrumentation.h"
 #include "main_data.h"
 #include "output.h"
 #include "player.h"
@@ -90,6 +92,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	_jump_tables.clear();
 }
 
 // Is interpreter running.
@@ -102,7 +105,8 @@ void Game_Interpreter::PushInternal(
 	InterpreterPush push_info,
 	std::vector<lcf::rpg::EventCommand> _list,
 	int event_id,
-	int event_page_id
+	int event_page_id,
+	std::shared_ptr<const Game_Interpreter_JumpTable> jump_table
 ) {
 	if (_list.empty()) {
 		return;
@@ -141,6 +145,8 @@ void Game_Interpreter::PushInternal(
 	}
 
 	_state.stack.push_back(std::move(frame));
+	_jump_tables.resize(_state.stack.size());
+	_jump_tables.back() = std::move(jump_table);
 }
 
 
@@ -548,21 +554,28 @@ void Game_Interpreter::Update(bool reset_loop_count) {
 
 // Setup Starting Event
 void Game_Interpreter::PushInternal(Game_Event* ev, ExecutionType ex_type) {
-	PushInternal(
-		{ ex_type, EventType::MapEvent },
-		ev->GetList(), ev->GetId(), ev->GetActivePage() ? ev->GetActivePage()->ID : 0
-	);
+	const auto* page = ev->GetActivePage();
+	if (!page) {
+		return;
+	}
+	PushInternal(ev, page, ex_type);
 }
 
 void Game_Interpreter::PushInternal(Game_Event* ev, const lcf::rpg::EventPage* page, ExecutionType ex_type) {
+	if (page->event_commands.empty()) {
+		return;
+	}
 	PushInternal(
 		{ ex_type, EventType::MapEvent },
-		page->event_commands, ev->GetId(), page->ID
+		page->event_commands, ev->GetId(), page->ID, ev->GetJumpTable(*page)
 	);
 }
 
 void Game_Interpreter::PushInternal(Game_CommonEvent* ev, ExecutionType ex_type) {
-	PushInternal({ ex_type, EventType::CommonEvent }, ev->GetList(), ev->GetId());
+	if (ev->GetList().empty()) {
+		return;
+	}
+	PushInternal({ ex_type, EventType::CommonEvent }, ev->GetList(), ev->GetId(), 0, ev->GetJumpTable());
 }
 
 bool Game_Interpreter::CheckGameOver() {
@@ -585,15 +598,22 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
-		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
-			break;
-		}
+	index = GetJumpTable().FindNextConditional(list, index, codes, indent);
+}
+
+const Game_Interpreter_JumpTable& Game_Interpreter::GetJumpTable() {
+	const auto& frame = GetFrame();
+	const size_t frame_idx = _state.stack.size() - 1;
+
+	if (_jump_tables.size() != _state.stack.size()) {
+		_jump_tables.resize(_state.stack.size());
 	}
+
+	auto& table = _jump_tables[frame_idx];
+	if (!table || !table->Matches(frame.commands)) {
+		table = std::make_shared<const Game_Interpreter_JumpTable>(frame.commands);
+	}
+	return *table;
 }
 
 // Execute Command.
@@ -604,6 +624,8 @@ bool Game_Interpreter::ExecuteCommand() {
 }
 
 bool Game_Interpreter::ExecuteCommand(lcf::rpg::EventCommand const& com) {
+	EP_INSTRUMENT_ZONE("Game_Interpreter::ExecuteCommand", com.code);
+
 	switch (static_cast<Cmd>(com.code)) {
 		case Cmd::ShowMessage:
 			return CmdSetup<&Game_Interpreter::CommandShowMessage, 0>(com);
@@ -3755,18 +3777,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 
 bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters.empty() || list[idx].parameters[0] != label_id)
-			continue;
+	int idx = GetJumpTable().FindLabel(label_id);
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	return true;
@@ -3850,13 +3867,7 @@ bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */)
 
 	// This emulates an RPG_RT bug where break loop ignores scopes and
 	// unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
-	}
+	index = std::min(GetJumpTable().FindNextEndLoop(index) + 1, static_cast<int>(list.size()));
 
 	return true;
 }
@@ -3866,8 +3877,6 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
-	int indent = com.indent;
-
 	if (Player::IsPatchManiac() && com.parameters.size() >= 5 && com.parameters[0] != 0) {
 		int type = com.parameters[0];
 		int offset = com.indent * 2;
@@ -3920,16 +3929,11 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	}
 
 	// Restart the loop
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
-		index = idx;
-		break;
+	int idx = GetJumpTable().FindLoopBegin(list, index);
+	if (idx < 0) {
+		return false;
 	}
+	index = idx;
 
 	// Jump past the Cmd::Loop to the first command.
 	if (index < (int)frame.commands.size()) {
@@ -4372,6 +4376,7 @@ bool Game_Interpreter::CommandManiacGetSaveInfo(lcf::rpg::EventCommand const& co
 		return true;
 	}
 
+	SaveWriter::Wait();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, save_number);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
@@ -4468,6 +4473,7 @@ bool Game_Interpreter::CommandManiacLoad(lcf::rpg::EventCommand const& com) {
 	// Not implemented (kinda useless feature):
 	// When com.parameters[2] is 1 the check whether the file exists is skipped
 	// When skipped and missing RPG_RT will crash
+	SaveWriter::Wait();
 	auto savefs = FileFinder::Save();
 	std::string save_name = Scene_Save::GetSaveFilename(savefs, slot);
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
@@ -20,12 +20,14 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 #include "async_handler.h"
 #include "game_character.h"
 #include "game_actor.h"
 #include "game_interpreter_shared.h"
+#include "game_interpreter_jump_table.h"
 #include <lcf/dbarray.h>
 #include <lcf/rpg/fwd.h>
 #include <lcf/rpg/eventcommand.h>
@@ -174,6 +176,14 @@ protected:
 	 */
 	void SkipToNextConditional(std::initializer_list<Cmd> codes, int indent);
 
+	/**
+	 * Returns the jump table of the current frame.
+	 * The table is built on first use.
+	 *
+	 * @return jump table
+	 */
+	const Game_Interpreter_JumpTable& GetJumpTable();
+
 	/**
 	 * Sets up a wait (and closes the message box)
 	 */
@@ -359,13 +369,19 @@ protected:
 	lcf::rpg::SaveEventExecState _state;
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
+	/**
+	 * Jump tables of the stack frames in _state. Frames of map and common
+	 * events share the table of their source list, others build it on demand.
+	 */
+	std::vector<std::shared_ptr<const Game_Interpreter_JumpTable>> _jump_tables;
 
 	private:
 		void PushInternal(
 			InterpreterPush push_info,
 			std::vector<lcf::rpg::EventCommand> _list,
 			int _event_id,
-			int event_page_id = 0
+			int event_page_id = 0,
+			std::shared_ptr<const Game_Interpreter_JumpTable> jump_table = nullptr
 		);
 
 		void PushInternal(Game_Event* ev, InterpreterExecutionType ex_type);
@@ -0,0 +1,125 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "game_interpreter_jump_table.h"
+#include <algorithm>
+
+Game_Interpreter_JumpTable::Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list)
+	: size(static_cast<int>(list.size()))
+{
+	next_sibling.resize(size);
+	block_end.resize(size);
+	prev_sibling.resize(size);
+	next_end_loop.resize(size);
+
+	// Monotonic stacks: The nearest command with a lower (or equal) indent
+	std::vector<int> le_stack;
+	std::vector<int> lt_stack;
+	int end_loop = size;
+
+	for (int i = size - 1; i >= 0; --i) {
+		const int indent = list[i].indent;
+
+		while (!le_stack.empty() && list[le_stack.back()].indent > indent) {
+			le_stack.pop_back();
+		}
+		next_sibling[i] = le_stack.empty() ? size : le_stack.back();
+		le_stack.push_back(i);
+
+		while (!lt_stack.empty() && list[lt_stack.back()].indent >= indent) {
+			lt_stack.pop_back();
+		}
+		block_end[i] = lt_stack.empty() ? size : lt_stack.back();
+		lt_stack.push_back(i);
+
+		next_end_loop[i] = end_loop;
+		if (static_cast<Cmd>(list[i].code) == Cmd::EndLoop) {
+			end_loop = i;
+		}
+	}
+
+	le_stack.clear();
+	for (int i = 0; i < size; ++i) {
+		const int indent = list[i].indent;
+
+		while (!le_stack.empty() && list[le_stack.back()].indent > indent) {
+			le_stack.pop_back();
+		}
+		prev_sibling[i] = le_stack.empty() ? -1 : le_stack.back();
+		le_stack.push_back(i);
+
+		const auto& com = list[i];
+		if (static_cast<Cmd>(com.code) == Cmd::Label && !com.parameters.empty()) {
+			labels.emplace_back(com.parameters[0], i);
+		}
+	}
+
+	// Stable: For duplicated labels the first one is used
+	std::stable_sort(labels.begin(), labels.end(), [](const auto& l, const auto& r) {
+		return l.first < r.first;
+	});
+}
+
+int Game_Interpreter_JumpTable::FindLabel(int label_id) const {
+	auto it = std::lower_bound(labels.begin(), labels.end(), label_id, [](const auto& l, int id) {
+		return l.first < id;
+	});
+	if (it == labels.end() || it->first != label_id) {
+		return -1;
+	}
+	return it->second;
+}
+
+int Game_Interpreter_JumpTable::FindNextConditional(const std::vector<lcf::rpg::EventCommand>& list, int index, std::initializer_list<Cmd> codes, int indent) const {
+	int idx = index;
+
+	while (idx < size) {
+		const int cur_indent = list[idx].indent;
+		if (cur_indent == indent) {
+			idx = next_sibling[idx];
+		} else if (cur_indent > indent) {
+			// Everything until the end of this block is indented even more
+			idx = block_end[idx];
+		} else {
+			// Broken event code, the block ended without the searched command
+			++idx;
+		}
+
+		if (idx < size && list[idx].indent <= indent
+				&& std::find(codes.begin(), codes.end(), static_cast<Cmd>(list[idx].code)) != codes.end()) {
+			return idx;
+		}
+	}
+
+	return size;
+}
+
+int Game_Interpreter_JumpTable::FindLoopBegin(const std::vector<lcf::rpg::EventCommand>& list, int index) const {
+	const int indent = list[index].indent;
+
+	for (int idx = prev_sibling[index]; idx >= 0; idx = prev_sibling[idx]) {
+		if (list[idx].indent < indent) {
+			return -1;
+		}
+		if (static_cast<Cmd>(list[idx].code) == Cmd::Loop) {
+			return idx;
+		}
+	}
+
+	return index;
+}
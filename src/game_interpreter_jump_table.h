@@ -0,0 +1,113 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_JUMP_TABLE_H
+#define EP_GAME_INTERPRETER_JUMP_TABLE_H
+
+// Headers
+#include <initializer_list>
+#include <utility>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Control flow targets of an event command list.
+ *
+ * Built once per list, afterwards jumps to labels, else/end branches and
+ * loop bounds do not need to scan the command list anymore.
+ * The results are identical to a linear scan, including for broken event
+ * code with missing end commands.
+ */
+class Game_Interpreter_JumpTable {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	/**
+	 * Analyzes a command list.
+	 *
+	 * @param list event commands
+	 */
+	explicit Game_Interpreter_JumpTable(const std::vector<lcf::rpg::EventCommand>& list);
+
+	/**
+	 * The table is shared between the stack frames that run copies of the
+	 * same source list.
+	 *
+	 * @param list event commands
+	 * @return Whether the table belongs to this list or a copy of it
+	 */
+	bool Matches(const std::vector<lcf::rpg::EventCommand>& list) const;
+
+	/**
+	 * @param label_id label number
+	 * @return index of the first label with this number or -1 if there is none
+	 */
+	int FindLabel(int label_id) const;
+
+	/**
+	 * Finds the next command after index with an indent <= indent and one of
+	 * the given codes.
+	 *
+	 * @param list event commands the table was built from
+	 * @param index index to start from (exclusive)
+	 * @param codes codes to search for
+	 * @param indent the indentation level to check
+	 * @return index of the found command or the list size if there is none
+	 */
+	int FindNextConditional(const std::vector<lcf::rpg::EventCommand>& list, int index, std::initializer_list<Cmd> codes, int indent) const;
+
+	/**
+	 * Finds the Loop command belonging to the EndLoop at index.
+	 * Searches backwards through the commands with the same indentation.
+	 *
+	 * @param list event commands the table was built from
+	 * @param index index of the EndLoop
+	 * @return index of the Loop, -1 when the block ends before a Loop was
+	 *   found or index when the list starts before a Loop was found.
+	 */
+	int FindLoopBegin(const std::vector<lcf::rpg::EventCommand>& list, int index) const;
+
+	/**
+	 * @param index index to start from (exclusive)
+	 * @return index of the next EndLoop ignoring the indentation or the list size
+	 */
+	int FindNextEndLoop(int index) const;
+
+private:
+	int size = 0;
+
+	/** Next command with an indent <= the indent of the command */
+	std::vector<int> next_sibling;
+	/** Next command with an indent < the indent of the command */
+	std::vector<int> block_end;
+	/** Previous command with an indent <= the indent of the command */
+	std::vector<int> prev_sibling;
+	/** Next EndLoop command */
+	std::vector<int> next_end_loop;
+	/** label id and command index, sorted by id */
+	std::vector<std::pair<int, int>> labels;
+};
+
+inline bool Game_Interpreter_JumpTable::Matches(const std::vector<lcf::rpg::EventCommand>& list) const {
+	return size == static_cast<int>(list.size());
+}
+
+inline int Game_Interpreter_JumpTable::FindNextEndLoop(int index) const {
+	return index < size ? next_end_loop[index] : size;
+}
+
+#endif
@@ -87,6 +87,7 @@ void Game_Interpreter_Map::SetState(const lcf::rpg::SaveEventExecState& save) {
 	Clear();
 	_state = save;
 	_keyinput.fromSave(save);
+	_jump_tables.clear();
 }
 
 void Game_Interpreter_Map::OnMapChange() {
@@ -22,10 +22,12 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <functional>
 #include <numeric>
 #include <unordered_set>
 
 #include "async_handler.h"
+#include "cache.h"
 #include "options.h"
 #include "system.h"
 #include "game_battle.h"
@@ -43,7 +45,9 @@
 #include "scene_map.h"
 #include <lcf/lmu/reader.h>
 #include <lcf/reader_lcf.h>
+#include <lcf/reader_util.h>
 #include "map_data.h"
+#include "map_preload.h"
 #include "main_data.h"
 #include "output.h"
 #include "util_macro.h"
@@ -51,6 +55,7 @@
 #include "filefinder.h"
 #include "player.h"
 #include "input.h"
+#include "instrumentation.h"
 #include "utils.h"
 #include "rand.h"
 #include <lcf/scope_guard.h>
@@ -67,12 +72,24 @@ namespace {
 	lcf::rpg::SavePanorama panorama;
 
 	bool need_refresh;
+	// Events whose page conditions observe a changed switch or variable
+	std::vector<int> refresh_event_ids;
 
 	int animation_type;
 	bool animation_fast;
 	std::vector<unsigned char> passages_down;
 	std::vector<unsigned char> passages_up;
+	// Map geometry passability of every tile, kept in sync with the tile data.
+	// Low byte: Passable flags of the upper layer tile (directions and Above).
+	// High byte: Passable directions of the lower layer tile.
+	std::vector<uint16_t> passability;
 	std::vector<Game_Event> events;
+	// Events indexed by tile for the position based lookups.
+	// Every bucket is a linked list of indices into events, in ascending order.
+	// The last bucket holds all events outside of the map.
+	std::vector<int> event_tile_head;
+	std::vector<int> event_tile_next;
+	std::vector<int> event_tile_bucket;
 	std::vector<Game_CommonEvent> common_events;
 	std::unique_ptr<Game_Map::Caching::MapCache> map_cache;
 
@@ -98,6 +115,12 @@ namespace Game_Map {
 void SetupCommon();
 }
 
+static void RebuildPassability();
+static void UpdatePassability(int tile_index);
+static void RebuildEventTileIndex();
+static void RefreshEvents();
+static void CompactRefreshEvents();
+
 void Game_Map::OnContinueFromBattle() {
 	Main_Data::game_system->BgmPlay(Main_Data::game_system->GetBeforeBattleMusic());
 }
@@ -113,6 +136,7 @@ void Game_Map::Init() {
 
 	interpreter.reset(new Game_Interpreter_Map(true));
 	map_cache.reset(new Caching::MapCache());
+	MapPreload::Clear();
 
 	InitCommonEvents();
 
@@ -133,7 +157,11 @@ void Game_Map::InitCommonEvents() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	event_tile_head.clear();
+	event_tile_next.clear();
+	event_tile_bucket.clear();
 	map.reset();
+	passability.clear();
 	map_info = {};
 	panorama = {};
 }
@@ -162,11 +190,12 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 	Parallax::ClearChangedBG();
 
 	SetEncounterSteps(GetMapInfo().encounter_steps);
-	SetChipset(map->chipset_id);
 
 	std::iota(map_info.lower_tiles.begin(), map_info.lower_tiles.end(), 0);
 	std::iota(map_info.upper_tiles.begin(), map_info.upper_tiles.end(), 0);
 
+	SetChipset(map->chipset_id);
+
 	// Save allowed
 	const auto* current_info = &GetMapInfo();
 	int current_index = current_info->ID;
@@ -285,6 +314,9 @@ void Game_Map::SetupFromSave(
 	map_info.events.clear();
 	interpreter->Clear();
 
+	// Event positions were restored from the save
+	RebuildEventTileIndex();
+
 	GetVehicle(Game_Vehicle::Boat)->SetSaveData(std::move(save_boat));
 	GetVehicle(Game_Vehicle::Ship)->SetSaveData(std::move(save_ship));
 	GetVehicle(Game_Vehicle::Airship)->SetSaveData(std::move(save_airship));
@@ -370,13 +402,123 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
 	return map;
 }
 
+std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMap(int map_id) {
+	auto map = MapPreload::Get(map_id);
+	if (map) {
+		return map;
+	}
+
+	map = LoadMapFile(map_id);
+	if (map && !Tr::GetCurrentTranslationId().empty()) {
+		TranslateMapMessages(map_id, *map);
+	}
+	return map;
+}
+
+void Game_Map::PrefetchAssets(const lcf::rpg::Map& map) {
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	EP_INSTRUMENT_ZONE("Game_Map::PrefetchAssets");
+
+	if (const auto* chipset = lcf::ReaderUtil::GetElement(lcf::Data::chipsets, map.chipset_id)) {
+		Cache::PrefetchChipset(std::string_view(chipset->chipset_name));
+	}
+
+	if (map.parallax_flag) {
+		Cache::PrefetchPanorama(std::string_view(map.parallax_name));
+	}
+
+	// The cache stops accepting prefetches when the budget is used up, so the
+	// graphics shown right after the transfer are queued first
+	for (const auto& ev: map.events) {
+		if (!ev.pages.empty() && !ev.pages.front().character_name.empty()) {
+			Cache::PrefetchCharset(std::string_view(ev.pages.front().character_name));
+		}
+	}
+
+	for (const auto& ev: map.events) {
+		for (size_t i = 1; i < ev.pages.size(); ++i) {
+			if (!ev.pages[i].character_name.empty()) {
+				Cache::PrefetchCharset(std::string_view(ev.pages[i].character_name));
+			}
+		}
+	}
+
+	// Pictures are large and often only shown in cutscenes
+	constexpr int max_pictures = 4;
+	int num_pictures = 0;
+	for (const auto& ev: map.events) {
+		for (const auto& page: ev.pages) {
+			for (const auto& com: page.event_commands) {
+				if (num_pictures >= max_pictures) {
+					return;
+				}
+				if (static_cast<Cmd>(com.code) == Cmd::ShowPicture && !com.string.empty() && com.parameters.size() > 7) {
+					Cache::PrefetchPicture(std::string_view(com.string), com.parameters[7] > 0);
+					++num_pictures;
+				}
+			}
+		}
+	}
+}
+
+void Game_Map::PreloadMaps(const lcf::rpg::Map& map) {
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	EP_INSTRUMENT_ZONE("Game_Map::PreloadMaps");
+
+	// Limits the file reads done after the transfer
+	constexpr size_t max_preloads = 8;
+
+	// Teleports of the events closest to the player are likely used first
+	const int player_x = Main_Data::game_player->GetX();
+	const int player_y = Main_Data::game_player->GetY();
+	std::vector<std::pair<int, int>> teleports;
+
+	for (const auto& ev: map.events) {
+		const int distance = std::abs(ev.x - player_x) + std::abs(ev.y - player_y);
+		for (const auto& page: ev.pages) {
+			for (const auto& com: page.event_commands) {
+				if (static_cast<Cmd>(com.code) == Cmd::Teleport && !com.parameters.empty()) {
+					teleports.emplace_back(distance, com.parameters[0]);
+				}
+			}
+		}
+	}
+	std::stable_sort(teleports.begin(), teleports.end(), [](const auto& a, const auto& b) {
+		return a.first < b.first;
+	});
+
+	std::vector<int> map_ids;
+	auto add = [&](int map_id) {
+		if (map_id > 0 && map_id != GetMapId() && map_ids.size() < max_preloads
+				&& std::find(map_ids.begin(), map_ids.end(), map_id) == map_ids.end()) {
+			map_ids.push_back(map_id);
+		}
+	};
+
+	for (const auto& teleport: teleports) {
+		add(teleport.second);
+	}
+
+	for (const auto& vehicle: vehicles) {
+		add(vehicle.GetMapId());
+	}
+
+	// The targets of the previous map are not relevant anymore
+	MapPreload::CancelRequests();
+	for (int map_id: map_ids) {
+		MapPreload::Request(map_id);
+	}
+}
+
 void Game_Map::SetupCommon() {
 	screen_width = (Player::screen_width / 16.0) * SCREEN_TILE_SIZE;
 	screen_height = (Player::screen_height / 16.0) * SCREEN_TILE_SIZE;
 
-	if (!Tr::GetCurrentTranslationId().empty()) {
-		TranslateMapMessages(GetMapId(), *map);
-	}
+	// Decoded while the events are created, the sprites are created afterwards
+	PrefetchAssets(*map);
+	PreloadMaps(*map);
 	SetNeedRefresh(true);
 
 	PrintPathToMap();
@@ -396,6 +538,7 @@ void Game_Map::CreateMapEvents() {
 		events.emplace_back(GetMapId(), &ev);
 		AddEventToCache(ev);
 	}
+	RebuildEventTileIndex();
 }
 
 void Game_Map::AddEventToCache(const lcf::rpg::Event& ev) {
@@ -443,17 +586,13 @@ bool Game_Map::CloneMapEvent(int src_map_id, int src_event_id, int target_x, int
 	if (src_map_id == GetMapId()) {
 		source_map = &GetMap();
 	} else {
-		source_map_storage = Game_Map::LoadMapFile(src_map_id);
+		source_map_storage = Game_Map::LoadMap(src_map_id);
 		source_map = source_map_storage.get();
 
 		if (source_map_storage == nullptr) {
 			Output::Warning("CloneMapEvent: Invalid source map ID {}", src_map_id);
 			return false;
 		}
-
-		if (!Tr::GetCurrentTranslationId().empty()) {
-			TranslateMapMessages(src_map_id, *source_map_storage);
-		}
 	}
 
 	const lcf::rpg::Event* source_event = FindEventById(source_map->events, src_event_id);
@@ -539,6 +678,10 @@ bool Game_Map::DestroyMapEvent(const int event_id, bool from_clone) {
 		Scene_Map* scene = (Scene_Map*)Scene::Find(Scene::Map).get();
 		scene->spriteset->Refresh();
 		SetNeedRefresh(true);
+	} else {
+		// The caller updates the references, but the index positions of the
+		// following events shifted already
+		RebuildEventTileIndex();
 	}
 
 	if (GetInterpreter().GetOriginalEventId() == event_id) {
@@ -563,9 +706,101 @@ void Game_Map::UpdateUnderlyingEventReferences() {
 		ev.SetUnderlyingEvent(&map->events.at(idx++));
 	}
 
+	RebuildEventTileIndex();
+
 	Main_Data::game_screen->UpdateUnderlyingEventReferences();
 }
 
+static int GetEventTileBucket(int x, int y) {
+	const int oob_bucket = static_cast<int>(event_tile_head.size()) - 1;
+	if (!map || x < 0 || x >= map->width || y < 0 || y >= map->height) {
+		return oob_bucket;
+	}
+	return x + y * map->width;
+}
+
+static void LinkEventTile(int idx, int bucket) {
+	event_tile_bucket[idx] = bucket;
+	int* link = &event_tile_head[bucket];
+	while (*link >= 0 && *link < idx) {
+		link = &event_tile_next[*link];
+	}
+	event_tile_next[idx] = *link;
+	*link = idx;
+}
+
+static void UnlinkEventTile(int idx) {
+	int* link = &event_tile_head[event_tile_bucket[idx]];
+	while (*link != idx) {
+		link = &event_tile_next[*link];
+	}
+	*link = event_tile_next[idx];
+	event_tile_next[idx] = -1;
+}
+
+static void RebuildEventTileIndex() {
+	const size_t num_buckets = (map ? map->width * map->height : 0) + 1;
+	if (event_tile_head.size() == num_buckets) {
+		// Only reset the buckets which are in use
+		for (int bucket: event_tile_bucket) {
+			event_tile_head[bucket] = -1;
+		}
+		event_tile_head.back() = -1;
+	} else {
+		event_tile_head.assign(num_buckets, -1);
+	}
+
+	event_tile_next.assign(events.size(), -1);
+	event_tile_bucket.assign(events.size(), 0);
+
+	// Prepending in reverse order keeps every bucket sorted
+	for (int i = static_cast<int>(events.size()) - 1; i >= 0; --i) {
+		const int bucket = GetEventTileBucket(events[i].GetX(), events[i].GetY());
+		event_tile_bucket[i] = bucket;
+		event_tile_next[i] = event_tile_head[bucket];
+		event_tile_head[bucket] = i;
+	}
+}
+
+/**
+ * Calls fn for all events at (x, y) in the order of the events vector,
+ * stops when fn returns true.
+ */
+template <typename F>
+static void ForEachEventAt(int x, int y, F&& fn) {
+	if (event_tile_head.empty()) {
+		return;
+	}
+	for (int i = event_tile_head[GetEventTileBucket(x, y)]; i >= 0; i = event_tile_next[i]) {
+		auto& ev = events[i];
+		// Required for the out of map bucket
+		if (ev.IsInPosition(x, y) && fn(ev)) {
+			return;
+		}
+	}
+}
+
+void Game_Map::OnEventMoved(const Game_Event& ev) {
+	const auto* begin = events.data();
+	const auto* end = begin + events.size();
+	if (std::less<const Game_Event*>()(&ev, begin) || !std::less<const Game_Event*>()(&ev, end)) {
+		// Not an event of the current map or still under construction
+		return;
+	}
+
+	const int idx = static_cast<int>(&ev - begin);
+	if (idx >= static_cast<int>(event_tile_next.size())) {
+		// The events changed, the index is rebuilt afterwards
+		return;
+	}
+
+	const int bucket = GetEventTileBucket(ev.GetX(), ev.GetY());
+	if (bucket != event_tile_bucket[idx]) {
+		UnlinkEventTile(idx);
+		LinkEventTile(idx, bucket);
+	}
+}
+
 const lcf::rpg::Event* Game_Map::FindEventById(const std::vector<lcf::rpg::Event>& events, int eventId) {
 	for (const auto& ev : events) {
 		if (ev.ID == eventId) {
@@ -637,14 +872,56 @@ std::vector<uint8_t> Game_Map::GetTilesLayer(int layer) {
 	return layer >= 1 ? map_info.upper_tiles : map_info.lower_tiles;
 }
 
+//#define EP_DEBUG_MAP_REFRESH
+
 void Game_Map::Refresh() {
 	if (GetMapId() > 0) {
-		for (Game_Event& ev : events) {
-			ev.RefreshPage();
+		if (need_refresh) {
+			for (Game_Event& ev : events) {
+				ev.RefreshPage();
+			}
+		} else {
+			RefreshEvents();
 		}
 	}
 
 	need_refresh = false;
+	refresh_event_ids.clear();
+}
+
+static void CompactRefreshEvents() {
+	std::sort(refresh_event_ids.begin(), refresh_event_ids.end());
+	refresh_event_ids.erase(std::unique(refresh_event_ids.begin(), refresh_event_ids.end()), refresh_event_ids.end());
+}
+
+// Re-evaluates only the pages of the events observing a changed switch or variable
+static void RefreshEvents() {
+	EP_INSTRUMENT_ZONE("Game_Map::RefreshEvents", static_cast<int64_t>(refresh_event_ids.size()));
+
+	// Same order as the full refresh: events are sorted by ID
+	CompactRefreshEvents();
+
+	auto it = events.begin();
+	for (int event_id: refresh_event_ids) {
+		it = std::lower_bound(it, events.end(), event_id, [](const Game_Event& ev, int id) {
+			return ev.GetId() < id;
+		});
+		if (it == events.end()) {
+			break;
+		}
+		if (it->GetId() == event_id) {
+			it->RefreshPage();
+		}
+	}
+
+#ifdef EP_DEBUG_MAP_REFRESH
+	// A full refresh must not change any page now
+	for (Game_Event& ev : events) {
+		if (ev.FindActivePage() != ev.GetActivePage()) {
+			Output::Warning("Refresh: Event {} ({}) was not refreshed but its page changed", ev.GetId(), ev.GetName());
+		}
+	}
+#endif
 }
 
 Game_Interpreter_Map& Game_Map::GetInterpreter() {
@@ -883,19 +1160,25 @@ bool Game_Map::CheckOrMakeWayEx(const Game_Character& self,
 	}
 	if (vehicle_type != Game_Vehicle::Airship && check_events_and_vehicles) {
 		// Check for collision with events on the target tile.
-		if (ignore_some_events_by_id.empty()) {
+		auto is_ignored = [&](const Game_Event& other) {
+			return !ignore_some_events_by_id.empty()
+				&& std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end();
+		};
+		if (make_way) {
+			// Updating the other events can move any of them, so check all
 			for (auto& other: GetEvents()) {
-				if (CheckOrMakeCollideEvent(other)) {
+				if (!is_ignored(other) && CheckOrMakeCollideEvent(other)) {
 					return false;
 				}
 			}
 		} else {
-			for (auto& other: GetEvents()) {
-				if (std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
-					continue;
-				if (CheckOrMakeCollideEvent(other)) {
-					return false;
-				}
+			bool collides = false;
+			ForEachEventAt(to_x, to_y, [&](Game_Event& other) {
+				collides = !is_ignored(other) && CheckOrMakeCollideEvent(other);
+				return collides;
+			});
+			if (collides) {
+				return false;
 			}
 		}
 
@@ -953,12 +1236,13 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
-			return false;
-		}
+	bool has_event = false;
+	ForEachEventAt(x, y, [&](Game_Event& ev) {
+		has_event = ev.IsActive() && ev.GetActivePage() != nullptr;
+		return has_event;
+	});
+	if (has_event) {
+		return false;
 	}
 	for (auto vid: { Game_Vehicle::Boat, Game_Vehicle::Ship }) {
 		auto& vehicle = vehicles[vid - 1];
@@ -975,10 +1259,7 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-	tile_id = map_info.upper_tiles[tile_id];
-
-	return (passages_up[tile_id] & bit) != 0;
+	return (passability[tile_index] & bit) != 0;
 }
 
 bool Game_Map::CanEmbarkShip(Game_Player& player, int x, int y) {
@@ -991,13 +1272,15 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+	bool has_event = false;
+	ForEachEventAt(x, y, [&](Game_Event& ev) {
+		has_event = ev.GetLayer() == lcf::rpg::EventPage::Layers_same
 			&& ev.IsActive()
-			&& ev.GetActivePage() != nullptr) {
-			return false;
-		}
+			&& ev.GetActivePage() != nullptr;
+		return has_event;
+	});
+	if (has_event) {
+		return false;
 	}
 
 	int bit = GetPassableMask(x, y, player.GetX(), player.GetY());
@@ -1006,6 +1289,11 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 }
 
 bool Game_Map::IsPassableLowerTile(int bit, int tile_index) {
+	return ((passability[tile_index] >> 8) & bit) != 0;
+}
+
+/** @return Passable direction bits of the lower layer tile */
+static int GetLowerTilePassage(int tile_index) {
 	int tile_raw_id = map->lower_layer[tile_index];
 	int tile_id = 0;
 
@@ -1022,7 +1310,7 @@ bool Game_Map::IsPassableLowerTile(int bit, int tile_index) {
 				(autotile_id >= 33 && autotile_id <= 37) ||
 				autotile_id == 42 || autotile_id == 43 ||
 				autotile_id == 45 || autotile_id == 46))
-			return true;
+			return Passable::Down | Passable::Left | Passable::Right | Passable::Up;
 
 	} else if (tile_raw_id >= BLOCK_C) {
 		tile_id = (tile_raw_id - BLOCK_C) / BLOCK_C_STRIDE + BLOCK_C_INDEX;
@@ -1031,7 +1319,32 @@ bool Game_Map::IsPassableLowerTile(int bit, int tile_index) {
 		tile_id = tile_raw_id / BLOCK_B_STRIDE;
 	}
 
-	return (passages_down[tile_id] & bit) != 0;
+	return passages_down[tile_id] & (Passable::Down | Passable::Left | Passable::Right | Passable::Up);
+}
+
+/** @return Passable direction and Above bits of the upper layer tile */
+static int GetUpperTilePassage(int tile_index) {
+	int tile_id = map->upper_layer[tile_index] - BLOCK_F;
+	tile_id = map_info.upper_tiles[tile_id];
+
+	return passages_up[tile_id] & (Passable::Down | Passable::Left | Passable::Right | Passable::Up | Passable::Above);
+}
+
+static void UpdatePassability(int tile_index) {
+	passability[tile_index] = static_cast<uint16_t>(GetUpperTilePassage(tile_index) | (GetLowerTilePassage(tile_index) << 8));
+}
+
+static void RebuildPassability() {
+	if (!map) {
+		passability.clear();
+		return;
+	}
+
+	const int num_tiles = map->width * map->height;
+	passability.resize(num_tiles);
+	for (int i = 0; i < num_tiles; ++i) {
+		UpdatePassability(i);
+	}
 }
 
 bool Game_Map::IsPassableTile(
@@ -1069,19 +1382,20 @@ bool Game_Map::IsPassableTile(
 
 		// Highest ID event with layer=below, not through, and a tile graphic wins.
 		int event_tile_id = 0;
-		for (auto& ev: events) {
+		ForEachEventAt(x, y, [&](Game_Event& ev) {
 			if (self == &ev) {
-				continue;
+				return false;
 			}
 			if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
-				continue;
+				return false;
 			}
-			if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
+			if (ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
 				if (ev.HasTileSprite()) {
 					event_tile_id = ev.GetTileId();
 				}
 			}
-		}
+			return false;
+		});
 
 		// If there was a below tile event, and the tile is not above
 		// Override the chipset with event tile behavior.
@@ -1100,23 +1414,21 @@ bool Game_Map::IsPassableTile(
 	}
 
 	if (check_map_geometry) {
-		int tile_index = x + y * GetTilesX();
-		int tile_id = map->upper_layer[tile_index] - BLOCK_F;
-		tile_id = map_info.upper_tiles[tile_id];
+		const int tile_passage = passability[x + y * GetTilesX()];
 
 		if (vehicle_type == Game_Vehicle::Boat || vehicle_type == Game_Vehicle::Ship) {
-			if ((passages_up[tile_id] & Passable::Above) == 0)
+			if ((tile_passage & Passable::Above) == 0)
 				return false;
 			return true;
 		}
 
-		if ((passages_up[tile_id] & bit) == 0)
+		if ((tile_passage & bit) == 0)
 			return false;
 
-		if ((passages_up[tile_id] & Passable::Above) == 0)
+		if ((tile_passage & Passable::Above) == 0)
 			return true;
 
-		return IsPassableLowerTile(bit, tile_index);
+		return ((tile_passage >> 8) & bit) != 0;
 	} else {
 		return true;
 	}
@@ -1183,14 +1495,15 @@ int Game_Map::GetTerrainTag(int x, int y) {
 }
 
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
-			return &ev;
+	// The bucket is in ascending order, the last match has the highest id
+	Game_Event* result = nullptr;
+	ForEachEventAt(x, y, [&](Game_Event& ev) {
+		if (!require_active || ev.IsActive()) {
+			result = &ev;
 		}
-	}
-	return nullptr;
+		return false;
+	});
+	return result;
 }
 
 bool Game_Map::LoopHorizontal() {
@@ -1242,16 +1555,21 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
-	}
+	int event_id = 0;
+	ForEachEventAt(x, y, [&](Game_Event& ev) {
+		event_id = ev.GetId();
+		return true;
+	});
 
-	return 0;
+	return event_id;
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
+	EP_INSTRUMENT_ZONE("Game_Map::Update");
+	if (!is_preupdate) {
+		MapPreload::Update();
+	}
+
 	if (GetNeedRefresh()) {
 		Refresh();
 	}
@@ -1762,25 +2080,32 @@ bool Game_Map::GetNeedRefresh() {
 		return false;
 	}
 
-	return need_refresh;
+	return need_refresh || !refresh_event_ids.empty();
 }
 
 void Game_Map::SetNeedRefresh(bool refresh) {
 	need_refresh = refresh;
+	refresh_event_ids.clear();
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(int switch_id) {
 	if (need_refresh)
 		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::SwitchSet>(switch_id))
-		SetNeedRefresh(true);
+	map_cache->GetRefreshTargets<Caching::ObservedVarOps::SwitchSet>(switch_id, refresh_event_ids);
+	if (refresh_event_ids.size() > 2 * events.size() + 64) {
+		// Changed often without a refresh in between (e.g. anti-lag switch)
+		CompactRefreshEvents();
+	}
 }
 
 void Game_Map::SetNeedRefreshForVarChange(int var_id) {
 	if (need_refresh)
 		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::VarSet>(var_id))
-		SetNeedRefresh(true);
+	map_cache->GetRefreshTargets<Caching::ObservedVarOps::VarSet>(var_id, refresh_event_ids);
+	if (refresh_event_ids.size() > 2 * events.size() + 64) {
+		// Changed often without a refresh in between (e.g. anti-lag switch)
+		CompactRefreshEvents();
+	}
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids) {
@@ -1863,6 +2188,8 @@ void Game_Map::SetChipset(int id) {
 		passages_down.resize(162, (unsigned char) 0x0F);
 	if (passages_up.size() < 144)
 		passages_up.resize(144, (unsigned char) 0x0F);
+
+	RebuildPassability();
 }
 
 bool Game_Map::ReloadChipset() {
@@ -1875,6 +2202,8 @@ bool Game_Map::ReloadChipset() {
 
 void Game_Map::OnTranslationChanged() {
 	ReloadChipset();
+	// The cached maps are translated
+	MapPreload::Clear();
 	// Marks common events for reload on map change
 	// This is not save to do while they are executing
 	translation_changed = true;
@@ -1949,17 +2278,26 @@ static int DoSubstitute(std::vector<uint8_t>& tiles, int old_id, int new_id) {
 }
 
 int Game_Map::SubstituteDown(int old_id, int new_id) {
-	return DoSubstitute(map_info.lower_tiles, old_id, new_id);
+	int num_subst = DoSubstitute(map_info.lower_tiles, old_id, new_id);
+	if (num_subst > 0) {
+		RebuildPassability();
+	}
+	return num_subst;
 }
 
 int Game_Map::SubstituteUp(int old_id, int new_id) {
-	return DoSubstitute(map_info.upper_tiles, old_id, new_id);
+	int num_subst = DoSubstitute(map_info.upper_tiles, old_id, new_id);
+	if (num_subst > 0) {
+		RebuildPassability();
+	}
+	return num_subst;
 }
 
 void Game_Map::ReplaceTileAt(int x, int y, int new_id, int layer) {
 	auto pos = x + y * map->width;
 	auto& layer_vec = layer >= 1 ? map->upper_layer : map->lower_layer;
 	layer_vec[pos] = static_cast<int16_t>(new_id);
+	UpdatePassability(pos);
 }
 
 int Game_Map::GetTileIdAt(int x, int y, int layer, bool chip_id_or_index) {
@@ -134,6 +134,33 @@ namespace Game_Map {
 	 */
 	std::unique_ptr<lcf::rpg::Map> LoadMapFile(int map_id);
 
+	/**
+	 * Loads the map from the preload cache or from disk and translates it.
+	 *
+	 * @param map_id the id of the map to load
+	 * @return the map, or nullptr if it couldn't be loaded
+	 */
+	std::unique_ptr<lcf::rpg::Map> LoadMap(int map_id);
+
+	/**
+	 * Starts decoding the graphics used by a map in the background, in order:
+	 * Chipset, panorama, charsets of the first event pages, charsets of the
+	 * other pages and a few pictures of "Show Picture" commands with a
+	 * constant name.
+	 *
+	 * @param map the map
+	 */
+	void PrefetchAssets(const lcf::rpg::Map& map);
+
+	/**
+	 * Requests parsing the maps that are likely entered next in the background:
+	 * Targets of "Teleport" commands, ordered by the distance of the event to
+	 * the player, and maps with vehicles on them.
+	 *
+	 * @param map the current map
+	 */
+	void PreloadMaps(const lcf::rpg::Map& map);
+
 	/**
 	 * Setups a new map.
 	 *
@@ -177,6 +204,8 @@ namespace Game_Map {
 
 	/**
 	 * Refreshes the map.
+	 * Re-evaluates the pages of all events when SetNeedRefresh was called,
+	 * otherwise only of the events observing a changed switch or variable.
 	 */
 	void Refresh();
 
@@ -528,7 +557,7 @@ namespace Game_Map {
 	void SetPositionY(int new_position_y, bool reset_panorama = true);
 
 	/**
-	 * @return need refresh flag.
+	 * @return whether a full refresh or a refresh of single events is pending.
 	 */
 	bool GetNeedRefresh();
 
@@ -540,7 +569,8 @@ namespace Game_Map {
 	Game_Interpreter_Map& GetInterpreter();
 
 	/**
-	 * Sets the need refresh flag.
+	 * Sets the need refresh flag. When set all event pages are re-evaluated
+	 * on the next Refresh.
 	 *
 	 * @param refresh need refresh flag.
 	 */
@@ -607,6 +637,15 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEventAt(int x, int y, bool require_active);
 
+	/**
+	 * Updates the tile index used by the position based event lookups.
+	 * Must be called whenever the position of a map event changes.
+	 * Events which are not part of the current map are ignored.
+	 *
+	 * @param ev the event which moved
+	 */
+	void OnEventMoved(const Game_Event& ev);
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
@@ -718,6 +757,9 @@ namespace Game_Map {
 			void AddEvent(const lcf::rpg::Event& ev);
 			void RemoveEvent(const lcf::rpg::Event& ev);
 
+			/** @return IDs of the events in this cache */
+			const std::vector<int>& GetEventIds() const;
+
 		private:
 			std::vector<int> event_ids;
 		};
@@ -742,6 +784,15 @@ namespace Game_Map {
 			template <ObservedVarOps Op>
 			bool GetNeedRefresh(int var_id);
 
+			/**
+			 * Appends the IDs of all events with a page condition on var_id.
+			 *
+			 * @param var_id switch or variable ID
+			 * @param event_ids receives the event IDs
+			 */
+			template <ObservedVarOps Op>
+			void GetRefreshTargets(int var_id, std::vector<int>& event_ids) const;
+
 			void Clear();
 		private:
 			MapEventCacheData_t refresh_targets_by_varid[ObservedVarOps_END];
@@ -927,4 +978,20 @@ inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int var_id) {
 	return events_cache.find(var_id) != events_cache.end();
 }
 
+template <Game_Map::Caching::ObservedVarOps Op>
+inline void Game_Map::Caching::MapCache::GetRefreshTargets(int var_id, std::vector<int>& event_ids) const {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+	auto it = events_cache.find(var_id);
+	if (it != events_cache.end()) {
+		const auto& ids = it->second.GetEventIds();
+		event_ids.insert(event_ids.end(), ids.begin(), ids.end());
+	}
+}
+
+inline const std::vector<int>& Game_Map::Caching::MapEventCache::GetEventIds() const {
+	return event_ids;
+}
+
 #endif
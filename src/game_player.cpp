@@ -153,7 +153,7 @@ void Game_Player::MoveTo(int map_id, int x, int y) {
 
 		ResetAnimation();
 
-		auto map = Game_Map::LoadMapFile(GetMapId());
+		auto map = Game_Map::LoadMap(GetMapId());
 
 		Game_Map::Setup(std::move(map));
 		Game_Map::PlayBgm();
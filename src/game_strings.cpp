@@ -16,7 +16,11 @@
  */
 
  // Headers
+#include <iterator>
+#include <list>
 #include <regex>
+#include <type_traits>
+#include <unordered_map>
 #include <lcf/encoder.h>
 #include <lcf/reader_util.h>
 #include "async_handler.h"
@@ -33,6 +37,86 @@
 #include "json_helper.h"
 #endif
 
+namespace {
+	/**
+	 * Least recently used cache of compiled regular expressions.
+	 * Constructing a std::regex is far more expensive than matching short
+	 * strings, games call the string commands with the same pattern in loops.
+	 */
+	template <typename CharT>
+	class RegExCache {
+	public:
+		using Regex = std::basic_regex<CharT>;
+
+		const Regex& Get(std::string_view pattern, std::regex_constants::syntax_option_type flags = std::regex_constants::ECMAScript);
+		void Clear();
+
+	private:
+		struct Key {
+			std::string_view pattern;
+			std::regex_constants::syntax_option_type flags;
+
+			bool operator==(const Key& o) const {
+				return pattern == o.pattern && flags == o.flags;
+			}
+		};
+
+		struct KeyHash {
+			size_t operator()(const Key& key) const {
+				return std::hash<std::string_view>()(key.pattern) ^ static_cast<size_t>(key.flags);
+			}
+		};
+
+		struct Entry {
+			std::string pattern;
+			std::regex_constants::syntax_option_type flags;
+			Regex regex;
+		};
+
+		static constexpr size_t capacity = 32;
+
+		/** Most recently used first, the key of index refers to the pattern of the entry */
+		std::list<Entry> entries;
+		std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> index;
+	};
+
+	template <typename CharT>
+	const typename RegExCache<CharT>::Regex& RegExCache<CharT>::Get(std::string_view pattern, std::regex_constants::syntax_option_type flags) {
+		auto it = index.find({pattern, flags});
+		if (it != index.end()) {
+			entries.splice(entries.begin(), entries, it->second);
+			return it->second->regex;
+		}
+
+		// Throws on invalid patterns before anything is inserted
+		Regex regex;
+		if constexpr (std::is_same_v<CharT, wchar_t>) {
+			regex.assign(Utils::ToWideString(pattern), flags);
+		} else {
+			regex.assign(pattern.data(), pattern.size(), flags);
+		}
+
+		if (entries.size() >= capacity) {
+			const auto& last = entries.back();
+			index.erase({last.pattern, last.flags});
+			entries.pop_back();
+		}
+
+		entries.push_front({std::string(pattern), flags, std::move(regex)});
+		index.emplace(Key{entries.front().pattern, flags}, entries.begin());
+		return entries.front().regex;
+	}
+
+	template <typename CharT>
+	void RegExCache<CharT>::Clear() {
+		index.clear();
+		entries.clear();
+	}
+
+	RegExCache<char> char_regex_cache;
+	RegExCache<wchar_t> wide_regex_cache;
+}
+
 void Game_Strings::WarnGet(int id) const {
 	Output::Debug("Invalid read strvar[{}]!", id);
 	--_warnings;
@@ -293,8 +377,6 @@ std::string_view Game_Strings::PopLine(Str_Params params, int offset, int string
 }
 
 std::string_view Game_Strings::ExMatch(Str_Params params, std::string expr, int var_id, int begin, int string_out_id, Game_Variables& variables) {
-	// std::regex only works with char and wchar, not char32
-	// For full Unicode support requires the w-API, even on non-Windows systems
 	int var_result;
 	std::string str_result;
 
@@ -305,16 +387,7 @@ std::string_view Game_Strings::ExMatch(Str_Params params, std::string expr, int
 	auto source = Get(params.string_id);
 	std::string base = Substring(source, begin, Utils::UTF8Length(source));
 
-	std::wsmatch match;
-	auto wbase = Utils::ToWideString(base);
-	auto wexpr = Utils::ToWideString(expr);
-
-	std::wregex r(wexpr);
-
-	std::regex_search(wbase, match, r);
-	str_result = Utils::FromWideString(match.str());
-
-	var_result = match.position() + begin;
+	var_result = RegExMatch(base, expr, str_result) + begin;
 	variables.Set(var_id, var_result);
 	Game_Map::SetNeedRefreshForVarChange(var_id);
 
@@ -454,20 +527,47 @@ std::string Game_Strings::Erase(std::string_view source, int begin, int length)
 	return ret;
 }
 
+int Game_Strings::RegExMatch(std::string_view str, std::string_view search, std::string& match) {
+	if (Utils::StringIsAscii(str) && Utils::StringIsAscii(search)) {
+		// Byte and codepoint positions are identical, no conversion necessary
+		std::cmatch cmatch;
+		std::regex_search(str.data(), str.data() + str.size(), cmatch, char_regex_cache.Get(search));
+		match = cmatch.str();
+		return static_cast<int>(cmatch.position());
+	}
+
+	// std::regex only works with char and wchar, not char32
+	// For full Unicode support requires the w-API, even on non-Windows systems
+	std::wsmatch wmatch;
+	auto wstr = Utils::ToWideString(str);
+
+	std::regex_search(wstr, wmatch, wide_regex_cache.Get(search));
+	match = Utils::FromWideString(wmatch.str());
+	return static_cast<int>(wmatch.position());
+}
+
 std::string Game_Strings::RegExReplace(std::string_view str, std::string_view search, std::string_view replace, std::regex_constants::match_flag_type flags) {
+	if (Utils::StringIsAscii(str) && Utils::StringIsAscii(search)) {
+		std::string result;
+		std::regex_replace(std::back_inserter(result), str.begin(), str.end(), char_regex_cache.Get(search), std::string(replace), flags);
+		return result;
+	}
+
 	// std::regex only works with char and wchar, not char32
 	// For full Unicode support requires the w-API, even on non-Windows systems
 	auto wstr = Utils::ToWideString(str);
-	auto wsearch = Utils::ToWideString(search);
 	auto wreplace = Utils::ToWideString(replace);
 
-	std::wregex rexp(wsearch);
-
-	auto result = std::regex_replace(wstr, rexp, wreplace, flags);
+	auto result = std::regex_replace(wstr, wide_regex_cache.Get(search), wreplace, flags);
 
 	return Utils::FromWideString(result);
 }
 
+void Game_Strings::ClearRegExCache() {
+	char_regex_cache.Clear();
+	wide_regex_cache.Clear();
+}
+
 int Game_Strings::AdjustIndex(std::string_view str, int index) {
 	if (index >= 0) {
 		return index;
@@ -102,9 +102,21 @@ public:
 	static std::string Substring(std::string_view source, int begin, int length);
 	static std::string Insert(std::string_view source, std::string_view what, int where);
 	static std::string Erase(std::string_view source, int begin, int length);
+	/**
+	 * Searches for the first match of a regular expression.
+	 *
+	 * @param str string to search in
+	 * @param search regular expression
+	 * @param match receives the matched text
+	 * @return position of the match in codepoints
+	 */
+	static int RegExMatch(std::string_view str, std::string_view search, std::string& match);
 	static std::string RegExReplace(std::string_view str, std::string_view search, std::string_view replace, std::regex_constants::match_flag_type flags = std::regex_constants::match_default);
 	static int AdjustIndex(std::string_view str, int index);
 
+	/** Removes all compiled regular expressions from the cache */
+	static void ClearRegExCache();
+
 	static std::optional<std::string> ManiacsCommandInserter(char ch, const char** iter, const char* end, uint32_t escape_char);
 	static std::optional<std::string> ManiacsCommandInserterHex(char ch, const char** iter, const char* end, uint32_t escape_char);
 
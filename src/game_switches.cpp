@@ -20,6 +20,81 @@
 #include "output.h"
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
+#include <algorithm>
+
+namespace {
+	using Word_t = uint64_t;
+	constexpr int word_bits = 64;
+	constexpr Word_t all_bits = ~Word_t(0);
+
+	int PopCount(Word_t word) {
+#ifdef __GNUC__
+		return __builtin_popcountll(word);
+#else
+		word = word - ((word >> 1) & 0x5555555555555555ULL);
+		word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+		word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+		return static_cast<int>((word * 0x0101010101010101ULL) >> 56);
+#endif
+	}
+
+	/**
+	 * Calls op(word, mask) for each word that contains bits of the range.
+	 * The mask selects the bits of the word that are in the range.
+	 *
+	 * @param words packed bits
+	 * @param first_idx first bit
+	 * @param last_idx last bit (exclusive)
+	 * @param op operation
+	 */
+	template <typename W, typename F>
+	void ForEachWord(W* words, int first_idx, int last_idx, F&& op) {
+		if (first_idx >= last_idx) {
+			return;
+		}
+
+		const int first_word = first_idx / word_bits;
+		const int last_word = (last_idx - 1) / word_bits;
+		const Word_t first_mask = all_bits << (first_idx % word_bits);
+		const Word_t last_mask = all_bits >> (word_bits - 1 - (last_idx - 1) % word_bits);
+
+		if (first_word == last_word) {
+			op(words[first_word], first_mask & last_mask);
+			return;
+		}
+
+		op(words[first_word], first_mask);
+		for (int i = first_word + 1; i < last_word; ++i) {
+			op(words[i], all_bits);
+		}
+		op(words[last_word], last_mask);
+	}
+}
+
+void Game_Switches::SetData(const Switches_t& s) {
+	_size = static_cast<int>(s.size());
+	_words.assign((_size + kWordBits - 1) / kWordBits, 0);
+	for (int i = 0; i < _size; ++i) {
+		if (s[i]) {
+			_words[i / kWordBits] |= Word_t(1) << (i % kWordBits);
+		}
+	}
+}
+
+Game_Switches::Switches_t Game_Switches::GetData() const {
+	Switches_t s(_size);
+	for (int i = 0; i < _size; ++i) {
+		s[i] = (_words[i / kWordBits] >> (i % kWordBits)) & 1;
+	}
+	return s;
+}
+
+void Game_Switches::Resize(int size) {
+	if (size > _size) {
+		_words.resize((size + kWordBits - 1) / kWordBits, 0);
+		_size = size;
+	}
+}
 
 void Game_Switches::WarnGet(int variable_id) const {
 	Output::Debug("Invalid read sw[{}]!", variable_id);
@@ -34,11 +109,11 @@ bool Game_Switches::Set(int switch_id, bool value) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
-	}
-	ss[switch_id - 1] = value;
+	Resize(switch_id);
+	const int idx = switch_id - 1;
+	const Word_t bit = Word_t(1) << (idx % kWordBits);
+	auto& word = _words[idx / kWordBits];
+	word = value ? (word | bit) : (word & ~bit);
 	return value;
 }
 
@@ -47,13 +122,10 @@ void Game_Switches::SetRange(int first_id, int last_id, bool value) {
 		Output::Debug("Invalid write sw[{},{}] = {}!", first_id, last_id, value);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id, false);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i] = value;
-	}
+	Resize(last_id);
+	ForEachWord(_words.data(), std::max(0, first_id - 1), last_id, [value](Word_t& word, Word_t mask) {
+		word = value ? (word | mask) : (word & ~mask);
+	});
 }
 
 bool Game_Switches::Flip(int switch_id) {
@@ -64,12 +136,11 @@ bool Game_Switches::Flip(int switch_id) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
-	}
-	ss[switch_id - 1].flip();
-	return ss[switch_id - 1];
+	Resize(switch_id);
+	const int idx = switch_id - 1;
+	auto& word = _words[idx / kWordBits];
+	word ^= Word_t(1) << (idx % kWordBits);
+	return (word >> (idx % kWordBits)) & 1;
 }
 
 void Game_Switches::FlipRange(int first_id, int last_id) {
@@ -77,13 +148,18 @@ void Game_Switches::FlipRange(int first_id, int last_id) {
 		Output::Debug("Invalid flip sw[{},{}]!", first_id, last_id);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i].flip();
-	}
+	Resize(last_id);
+	ForEachWord(_words.data(), std::max(0, first_id - 1), last_id, [](Word_t& word, Word_t mask) {
+		word ^= mask;
+	});
+}
+
+int Game_Switches::CountRange(int first_id, int last_id) const {
+	int count = 0;
+	ForEachWord(_words.data(), std::max(0, first_id - 1), std::min(last_id, _size), [&count](Word_t word, Word_t mask) {
+		count += PopCount(word & mask);
+	});
+	return count;
 }
 
 std::string_view Game_Switches::GetName(int _id) const {
@@ -19,6 +19,7 @@
 #define EP_GAME_SWITCHES_H
 
 // Headers
+#include <cstdint>
 #include <vector>
 #include <string>
 #include <lcf/data.h>
@@ -27,16 +28,20 @@
 
 /**
  * Game_Switches class
+ *
+ * The switches are packed into 64 bit words, range operations change
+ * a whole word at once.
  */
 class Game_Switches {
 public:
+	/** Layout of the switches in save files */
 	using Switches_t = std::vector<bool>;
 	static constexpr int kMaxWarnings = 10;
 
 	Game_Switches() = default;
 
-	void SetData(Switches_t s);
-	const Switches_t& GetData() const;
+	void SetData(const Switches_t& s);
+	Switches_t GetData() const;
 
 	void SetLowerLimit(size_t limit);
 
@@ -49,6 +54,13 @@ public:
 	bool Flip(int switch_id);
 	void FlipRange(int first_id, int last_id);
 
+	/**
+	 * @param first_id first switch
+	 * @param last_id last switch (inclusive)
+	 * @return amount of switches in the range that are ON
+	 */
+	int CountRange(int first_id, int last_id) const;
+
 	std::string_view GetName(int switch_id) const;
 
 	bool IsValid(int switch_id) const;
@@ -59,33 +71,31 @@ public:
 	void SetWarning(int w);
 
 private:
+	using Word_t = uint64_t;
+	static constexpr int kWordBits = 64;
+
 	bool ShouldWarn(int first_id, int last_id) const;
 	void WarnGet(int variable_id) const;
+	void Resize(int size);
 
-	Switches_t _switches;
+	/** Bits beyond _size are always 0 */
+	std::vector<Word_t> _words;
+	int _size = 0;
 	size_t lower_limit = 0;
 	mutable int _warnings = kMaxWarnings;
 };
 
 
-inline void Game_Switches::SetData(Switches_t s) {
-	_switches = std::move(s);
-}
-
-inline const Game_Switches::Switches_t& Game_Switches::GetData() const {
-	return _switches;
-}
-
 inline void Game_Switches::SetLowerLimit(size_t limit) {
 	lower_limit = limit;
 }
 
 inline int Game_Switches::GetSize() const {
-	return static_cast<int>(_switches.size());
+	return _size;
 }
 
 inline int Game_Switches::GetSizeWithLimit() const {
-	return std::max<int>(lower_limit, _switches.size());
+	return std::max<int>(lower_limit, _size);
 }
 
 inline bool Game_Switches::IsValid(int variable_id) const {
@@ -100,10 +110,11 @@ inline bool Game_Switches::Get(int switch_id) const {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		WarnGet(switch_id);
 	}
-	if (switch_id <= 0 || switch_id > static_cast<int>(_switches.size())) {
+	if (switch_id <= 0 || switch_id > _size) {
 		return false;
 	}
-	return _switches[switch_id - 1];
+	const int idx = switch_id - 1;
+	return (_words[idx / kWordBits] >> (idx % kWordBits)) & 1;
 }
 
 inline int Game_Switches::GetInt(int switch_id) const {
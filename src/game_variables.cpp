@@ -24,6 +24,17 @@
 #include "rand.h"
 #include <cmath>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_VARIABLES_SSE2
+#  include <emmintrin.h>
+#  ifdef __SSE4_1__
+#    include <smmintrin.h>
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_VARIABLES_NEON
+#  include <arm_neon.h>
+#endif
+
 namespace {
 using Var_t = Game_Variables::Var_t;
 
@@ -128,6 +139,230 @@ constexpr Var_t VarBitShiftRight(Var_t n, Var_t d) {
 	return n >> d;
 };
 
+/*
+ * Range kernels: Apply an operation with a constant operand to a range.
+ * Kernels with has_vector = true also process 4 variables at once, the result
+ * is identical to the scalar operation.
+ */
+
+#if defined(EP_VARIABLES_SSE2)
+using VarVec = __m128i;
+
+inline VarVec VecLoad(const Var_t* p) {
+	return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+inline void VecStore(Var_t* p, VarVec v) {
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+}
+
+inline VarVec VecSplat(Var_t v) {
+	return _mm_set1_epi32(v);
+}
+
+inline VarVec VecSelect(VarVec mask, VarVec a, VarVec b) {
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+inline VarVec VecClamp(VarVec v, VarVec lo, VarVec hi) {
+#ifdef __SSE4_1__
+	return _mm_max_epi32(_mm_min_epi32(v, hi), lo);
+#else
+	v = VecSelect(_mm_cmpgt_epi32(v, hi), hi, v);
+	return VecSelect(_mm_cmplt_epi32(v, lo), lo, v);
+#endif
+}
+
+/** INT32_MAX for non-negative l, INT32_MIN otherwise */
+inline VarVec VecSaturated(VarVec l) {
+	return _mm_xor_si128(_mm_srai_epi32(l, 31), _mm_set1_epi32(std::numeric_limits<Var_t>::max()));
+}
+#elif defined(EP_VARIABLES_NEON)
+using VarVec = int32x4_t;
+
+inline VarVec VecLoad(const Var_t* p) {
+	return vld1q_s32(p);
+}
+
+inline void VecStore(Var_t* p, VarVec v) {
+	vst1q_s32(p, v);
+}
+
+inline VarVec VecSplat(Var_t v) {
+	return vdupq_n_s32(v);
+}
+
+inline VarVec VecClamp(VarVec v, VarVec lo, VarVec hi) {
+	return vmaxq_s32(vminq_s32(v, hi), lo);
+}
+#endif
+
+struct KernelSet {
+	static constexpr bool has_vector = true;
+	explicit KernelSet(Var_t value) : value(value) {}
+	Var_t operator()(Var_t) const { return value; }
+#if defined(EP_VARIABLES_SSE2) || defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec) const { return VecSplat(value); }
+#endif
+	Var_t value;
+};
+
+struct KernelAdd {
+	static constexpr bool has_vector = true;
+	explicit KernelAdd(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarAdd(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const {
+		const VarVec r = VecSplat(value);
+		const VarVec res = _mm_add_epi32(l, r);
+		// Overflow when the sign of the result differs from the sign of both operands
+		const VarVec overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(l, res), _mm_xor_si128(r, res)), 31);
+		return VecSelect(overflow, VecSaturated(l), res);
+	}
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return vqaddq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+struct KernelSub {
+	static constexpr bool has_vector = true;
+	explicit KernelSub(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarSub(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const {
+		const VarVec r = VecSplat(value);
+		const VarVec res = _mm_sub_epi32(l, r);
+		// Overflow when the operands have different signs and the result has the sign of r
+		const VarVec overflow = _mm_srai_epi32(_mm_and_si128(_mm_xor_si128(l, r), _mm_xor_si128(l, res)), 31);
+		return VecSelect(overflow, VecSaturated(l), res);
+	}
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return vqsubq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+struct KernelMult {
+	static constexpr bool has_vector = false;
+	explicit KernelMult(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarMult(l, value); }
+	Var_t value;
+};
+
+struct KernelDiv {
+	static constexpr bool has_vector = false;
+	explicit KernelDiv(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarDiv(l, value); }
+	Var_t value;
+};
+
+struct KernelMod {
+	static constexpr bool has_vector = false;
+	explicit KernelMod(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarMod(l, value); }
+	Var_t value;
+};
+
+struct KernelBitOr {
+	static constexpr bool has_vector = true;
+	explicit KernelBitOr(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarBitOr(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return _mm_or_si128(l, VecSplat(value)); }
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return vorrq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+struct KernelBitAnd {
+	static constexpr bool has_vector = true;
+	explicit KernelBitAnd(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarBitAnd(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return _mm_and_si128(l, VecSplat(value)); }
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return vandq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+struct KernelBitXor {
+	static constexpr bool has_vector = true;
+	explicit KernelBitXor(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarBitXor(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return _mm_xor_si128(l, VecSplat(value)); }
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return true; }
+	VarVec operator()(VarVec l) const { return veorq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+// Shifts by 32 or more or by a negative amount depend on the CPU, these stay scalar
+
+struct KernelBitShiftLeft {
+	static constexpr bool has_vector = true;
+	explicit KernelBitShiftLeft(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarBitShiftLeft(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return value >= 0 && value < 32; }
+	VarVec operator()(VarVec l) const { return _mm_sll_epi32(l, _mm_cvtsi32_si128(value)); }
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return value >= 0 && value < 32; }
+	VarVec operator()(VarVec l) const { return vshlq_s32(l, VecSplat(value)); }
+#endif
+	Var_t value;
+};
+
+struct KernelBitShiftRight {
+	static constexpr bool has_vector = true;
+	explicit KernelBitShiftRight(Var_t value) : value(value) {}
+	Var_t operator()(Var_t l) const { return VarBitShiftRight(l, value); }
+#if defined(EP_VARIABLES_SSE2)
+	bool CanVectorize() const { return value >= 0 && value < 32; }
+	VarVec operator()(VarVec l) const { return _mm_sra_epi32(l, _mm_cvtsi32_si128(value)); }
+#elif defined(EP_VARIABLES_NEON)
+	bool CanVectorize() const { return value >= 0 && value < 32; }
+	// A negative amount shifts right
+	VarVec operator()(VarVec l) const { return vshlq_s32(l, VecSplat(-value)); }
+#endif
+	Var_t value;
+};
+
+template <typename K>
+void ApplyKernel(Var_t* vars, int count, const K& kernel, Var_t minval, Var_t maxval) {
+	int i = 0;
+
+#if defined(EP_VARIABLES_SSE2) || defined(EP_VARIABLES_NEON)
+	if constexpr (K::has_vector) {
+		if (kernel.CanVectorize()) {
+			const VarVec lo = VecSplat(minval);
+			const VarVec hi = VecSplat(maxval);
+			for (; i + 4 <= count; i += 4) {
+				VecStore(vars + i, VecClamp(kernel(VecLoad(vars + i)), lo, hi));
+			}
+		}
+	}
+#endif
+
+	for (; i < count; ++i) {
+		vars[i] = Utils::Clamp(kernel(vars[i]), minval, maxval);
+	}
+}
+
 }
 
 Game_Variables::Game_Variables(Var_t minval, Var_t maxval)
@@ -198,6 +433,14 @@ void Game_Variables::WriteRange(const int first_id, const int last_id, V&& value
 	}
 }
 
+template <typename K>
+void Game_Variables::WriteRangeValue(const int first_id, const int last_id, Var_t value) {
+	const int first_idx = std::max(0, first_id - 1);
+	if (first_idx < last_id) {
+		ApplyKernel(_variables.data() + first_idx, last_id - first_idx, K(value), _min, _max);
+	}
+}
+
 template <typename F>
 void Game_Variables::WriteArray(const int first_id_a, const int last_id_a, const int first_id_b, F&& op) {
 	auto& vv = _variables;
@@ -263,124 +506,122 @@ Game_Variables::Var_t Game_Variables::BitShiftRight(int variable_id, Var_t value
 
 void Game_Variables::SetRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSet);
+	WriteRangeValue<KernelSet>(first_id, last_id, value);
 }
 
 void Game_Variables::AddRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarAdd);
+	WriteRangeValue<KernelAdd>(first_id, last_id, value);
 }
 
 void Game_Variables::SubRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarSub);
+	WriteRangeValue<KernelSub>(first_id, last_id, value);
 }
 
 void Game_Variables::MultRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMult);
+	WriteRangeValue<KernelMult>(first_id, last_id, value);
 }
 
 void Game_Variables::DivRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarDiv);
+	WriteRangeValue<KernelDiv>(first_id, last_id, value);
 }
 
 void Game_Variables::ModRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] %= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarMod);
+	WriteRangeValue<KernelMod>(first_id, last_id, value);
 }
 
 void Game_Variables::BitOrRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] |= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitOr);
+	WriteRangeValue<KernelBitOr>(first_id, last_id, value);
 }
 
 void Game_Variables::BitAndRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] &= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitAnd);
+	WriteRangeValue<KernelBitAnd>(first_id, last_id, value);
 }
 
 void Game_Variables::BitXorRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] ^= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitXor);
+	WriteRangeValue<KernelBitXor>(first_id, last_id, value);
 }
 
 void Game_Variables::BitShiftLeftRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] <<= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitShiftLeft);
+	WriteRangeValue<KernelBitShiftLeft>(first_id, last_id, value);
 }
 
 void Game_Variables::BitShiftRightRange(int first_id, int last_id, Var_t value) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] >>= {}!", value);
-	WriteRange(first_id, last_id, [value](){ return value; }, VarBitShiftRight);
+	WriteRangeValue<KernelBitShiftRight>(first_id, last_id, value);
 }
 
-template <typename F>
-void Game_Variables::WriteRangeVariable(int first_id, const int last_id, const int var_id, F&& op) {
+template <typename K>
+void Game_Variables::WriteRangeVariable(int first_id, const int last_id, const int var_id) {
 	if (var_id >= first_id && var_id <= last_id) {
-		auto value = Get(var_id);
-		WriteRange(first_id, var_id, [value](){ return value; }, std::forward<F>(op));
+		WriteRangeValue<K>(first_id, var_id, Get(var_id));
 		first_id = var_id + 1;
 	}
-	auto value = Get(var_id);
-	WriteRange(first_id, last_id, [value](){ return value; }, std::forward<F>(op));
+	WriteRangeValue<K>(first_id, last_id, Get(var_id));
 }
 
 
 void Game_Variables::SetRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] = Var({})!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSet);
+	WriteRangeVariable<KernelSet>(first_id, last_id, var_id);
 }
 
 void Game_Variables::AddRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] += var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarAdd);
+	WriteRangeVariable<KernelAdd>(first_id, last_id, var_id);
 }
 
 void Game_Variables::SubRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] -= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarSub);
+	WriteRangeVariable<KernelSub>(first_id, last_id, var_id);
 }
 
 void Game_Variables::MultRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] *= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMult);
+	WriteRangeVariable<KernelMult>(first_id, last_id, var_id);
 }
 
 void Game_Variables::DivRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarDiv);
+	WriteRangeVariable<KernelDiv>(first_id, last_id, var_id);
 }
 
 void Game_Variables::ModRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] /= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarMod);
+	WriteRangeVariable<KernelMod>(first_id, last_id, var_id);
 }
 
 void Game_Variables::BitOrRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] |= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitOr);
+	WriteRangeVariable<KernelBitOr>(first_id, last_id, var_id);
 }
 
 void Game_Variables::BitAndRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] &= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitAnd);
+	WriteRangeVariable<KernelBitAnd>(first_id, last_id, var_id);
 }
 
 void Game_Variables::BitXorRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] ^= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitXor);
+	WriteRangeVariable<KernelBitXor>(first_id, last_id, var_id);
 }
 
 void Game_Variables::BitShiftLeftRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] <<= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitShiftLeft);
+	WriteRangeVariable<KernelBitShiftLeft>(first_id, last_id, var_id);
 }
 
 void Game_Variables::BitShiftRightRangeVariable(int first_id, int last_id, int var_id) {
 	PrepareRange(first_id, last_id, "Invalid write var[{},{}] >>= var[{}]!", var_id);
-	WriteRangeVariable(first_id, last_id, var_id, VarBitShiftRight);
+	WriteRangeVariable<KernelBitShiftRight>(first_id, last_id, var_id);
 }
 
 void Game_Variables::SetRangeVariableIndirect(int first_id, int last_id, int var_id) {
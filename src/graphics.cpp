@@ -19,6 +19,7 @@
 #include <memory>
 #include <sstream>
 #include <chrono>
+#include <unordered_map>
 
 #include "graphics.h"
 #include "cache.h"
@@ -28,8 +29,10 @@
 #include "transition.h"
 #include "scene.h"
 #include "drawable_mgr.h"
+#include "damage_region.h"
 #include "baseui.h"
 #include "game_clock.h"
+#include "instrumentation.h"
 
 using namespace std::chrono_literals;
 
@@ -42,6 +45,30 @@ namespace Graphics {
 	std::unique_ptr<FpsOverlay> fps_overlay;
 
 	std::string window_title_key;
+
+	/** Damage tracking state of a drawable in the last drawn frame */
+	struct DamageEntry {
+		Rect rect;
+		uint64_t state = 0;
+		uint64_t frame = 0;
+	};
+
+	/**
+	 * Compares the drawables against the last frame and collects the
+	 * damaged areas of dst in damage.
+	 */
+	void CollectDamage(Bitmap& dst, DrawableList& drawable_list);
+
+	std::unordered_map<const Drawable*, DamageEntry> damage_entries;
+	/** Visible drawables of the current frame in drawing order */
+	std::vector<std::pair<Drawable*, Rect>> damage_drawables;
+	DamageRegion damage;
+	uint64_t damage_frame = 0;
+	uint64_t background_state = 0;
+	const Bitmap* last_dst = nullptr;
+	Rect last_dst_rect;
+	const DrawableList* last_drawable_list = nullptr;
+	bool redraw_all = true;
 }
 
 void Graphics::Init() {
@@ -105,6 +132,7 @@ void Graphics::UpdateTitle() {
 }
 
 void Graphics::Draw(Bitmap& dst) {
+	EP_INSTRUMENT_ZONE("Graphics::Draw");
 	auto& transition = Transition::instance();
 
 	auto min_z = std::numeric_limits<Drawable::Z_t>::min();
@@ -115,7 +143,119 @@ void Graphics::Draw(Bitmap& dst) {
 		min_z = transition.GetZ() + 1;
 		dst.Clear();
 	}
-	LocalDraw(dst, min_z, max_z);
+
+	if (min_z != std::numeric_limits<Drawable::Z_t>::min()) {
+		// Transitions change the whole screen
+		LocalDraw(dst, min_z, max_z);
+		Invalidate();
+		return;
+	}
+
+	auto& drawable_list = DrawableMgr::GetLocalList();
+	CollectDamage(dst, drawable_list);
+
+	if (damage.IsEmpty()) {
+		// Nothing changed since the last frame
+		return;
+	}
+
+	if (damage.IsFull()) {
+		LocalDraw(dst, min_z, max_z);
+		return;
+	}
+
+	// Only redraw the damaged areas, everything else is unchanged since the last frame
+	for (const auto& rect: damage.GetRects()) {
+		dst.SetClipRect(rect);
+		current_scene->DrawBackground(dst);
+		for (const auto& [drawable, drawable_rect]: damage_drawables) {
+			if (!drawable_rect.IsOutOfBounds(rect)) {
+				drawable->Draw(dst);
+			}
+		}
+	}
+	dst.SetClipRect({});
+}
+
+void Graphics::CollectDamage(Bitmap& dst, DrawableList& drawable_list) {
+	++damage_frame;
+	damage.Reset(dst.GetRect());
+	damage_drawables.clear();
+
+	bool full = redraw_all
+		|| &dst != last_dst
+		|| dst.GetRect() != last_dst_rect
+		|| &drawable_list != last_drawable_list;
+
+	last_dst = &dst;
+	last_dst_rect = dst.GetRect();
+	last_drawable_list = &drawable_list;
+
+	// Drawables that are not damage tracked change in unknown ways and
+	// force a full redraw in this and in the next frame
+	bool untracked = false;
+
+	if (!drawable_list.empty()) {
+		Drawable::DamageInfo info;
+		if (!current_scene->GetBackgroundDamage(info)) {
+			untracked = true;
+		} else if (info.state != background_state) {
+			full = true;
+		}
+		background_state = info.state;
+	}
+
+	if (drawable_list.IsDirty()) {
+		drawable_list.Sort();
+	}
+
+	size_t tracked = 0;
+	for (auto* drawable: drawable_list) {
+		if (!drawable->IsVisible()) {
+			continue;
+		}
+
+		Drawable::DamageInfo info;
+		if (!drawable->GetDamage(info)) {
+			untracked = true;
+			continue;
+		}
+		info.Hash(drawable->GetZ());
+		++tracked;
+
+		auto& entry = damage_entries[drawable];
+		if (entry.frame == 0) {
+			damage.Add(info.rect);
+		} else if (entry.state != info.state || entry.rect != info.rect) {
+			damage.Add(entry.rect);
+			damage.Add(info.rect);
+		}
+		entry = { info.rect, info.state, damage_frame };
+
+		damage_drawables.emplace_back(drawable, info.rect);
+	}
+
+	// Drawables that were hidden or removed since the last frame.
+	// Usually there are none, then every entry was updated above.
+	if (tracked != damage_entries.size()) {
+		for (auto it = damage_entries.begin(); it != damage_entries.end();) {
+			if (it->second.frame != damage_frame) {
+				damage.Add(it->second.rect);
+				it = damage_entries.erase(it);
+			} else {
+				++it;
+			}
+		}
+	}
+
+	redraw_all = untracked;
+	if (full || untracked) {
+		damage.AddAll();
+	}
+}
+
+void Graphics::Invalidate() {
+	redraw_all = true;
 }
 
 void Graphics::LocalDraw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
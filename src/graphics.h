@@ -48,8 +48,22 @@ namespace Graphics {
 	 */
 	void Update();
 
+	/**
+	 * Draws the current scene.
+	 * Only the parts of dst are redrawn that changed since the last call,
+	 * see Drawable::GetDamage.
+	 *
+	 * @param dst bitmap to draw onto, must contain the last drawn frame
+	 */
 	void Draw(Bitmap& dst);
 
+	/**
+	 * Forces a redraw of the whole screen in the next call to Draw.
+	 * Must be called when the content of the display surface was modified
+	 * outside of Draw.
+	 */
+	void Invalidate();
+
 	void LocalDraw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z);
 
 	std::shared_ptr<Scene> UpdateSceneCallback();
@@ -0,0 +1,118 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "headless_ui.h"
+#include "bitmap.h"
+#include "filefinder.h"
+#include "output.h"
+#include "player.h"
+
+#include <fmt/format.h>
+
+HeadlessUi::HeadlessUi(int width, int height, const Game_Config& cfg) : BaseUi(cfg)
+{
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	// Run as fast as possible
+	frame_limit = Game_Clock::duration(0);
+
+	const DynamicFormat format(
+		32,
+		0x00FF0000,
+		0x0000FF00,
+		0x000000FF,
+		0xFF000000,
+		PF::NoAlpha);
+
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
+
+	main_surface = Bitmap::Create(current_display_mode.width,
+		current_display_mode.height,
+		false,
+		current_display_mode.bpp
+	);
+
+#ifdef SUPPORT_AUDIO
+	audio_ = std::make_unique<EmptyAudio>(cfg.audio);
+#endif
+
+	if (!Player::frame_hash_log_path.empty()) {
+		auto path = Player::frame_hash_log_path;
+		hash_log = std::make_unique<Filesystem_Stream::OutputStream>(FileFinder::Root().OpenOutputStream(path, std::ios::out | std::ios::trunc));
+
+		if (!*hash_log) {
+			hash_log.reset();
+			Output::Warning("Failed to open file for frame hash logging: {}", path);
+		}
+	}
+}
+
+bool HeadlessUi::vChangeDisplaySurfaceResolution(int new_width, int new_height) {
+	BitmapRef new_main_surface = Bitmap::Create(new_width, new_height, false, current_display_mode.bpp);
+
+	if (!new_main_surface) {
+		Output::Warning("ChangeDisplaySurfaceResolution Bitmap::Create failed");
+		return false;
+	}
+
+	main_surface = new_main_surface;
+
+	current_display_mode.width = new_width;
+	current_display_mode.height = new_height;
+
+	return true;
+}
+
+void HeadlessUi::UpdateDisplay() {
+	if (hash_log) {
+		*hash_log << fmt::format("{} {:016x}\n", Player::GetFrames(), HashBitmap(*main_surface));
+	}
+}
+
+bool HeadlessUi::ProcessEvents() {
+	// There is no window, the game only ends by itself or after the requested amount of frames
+	return Player::headless_frames <= 0 || Player::GetFrames() < Player::headless_frames;
+}
+
+void HeadlessUi::vGetConfig(Game_ConfigVideo& cfg) const {
+	cfg.renderer.Lock("Headless (Software)");
+}
+
+#ifdef SUPPORT_AUDIO
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
+
+uint64_t HeadlessUi::HashBitmap(const Bitmap& bitmap) {
+	uint64_t hash = 14695981039346656037ULL;
+
+	const auto* pixels = static_cast<const uint8_t*>(bitmap.pixels());
+	const int pitch = bitmap.pitch();
+	for (int y = 0; y < bitmap.height(); ++y) {
+		const uint8_t* row = pixels + y * pitch;
+		for (int x = 0; x < pitch; ++x) {
+			hash ^= row[x];
+			hash *= 1099511628211ULL;
+		}
+	}
+
+	return hash;
+}
@@ -0,0 +1,75 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_HEADLESS_UI_H
+#define EP_HEADLESS_UI_H
+
+// Headers
+#include <memory>
+#include "audio.h"
+#include "baseui.h"
+#include "filesystem_stream.h"
+
+/**
+ * HeadlessUi class.
+ * Renders into an off-screen bitmap without opening a window and without
+ * audio output. The game runs without frame limit.
+ * Used for benchmarking and regression testing (see --headless).
+ */
+class HeadlessUi final : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width display client width.
+	 * @param height display client height.
+	 * @param cfg config options
+	 */
+	HeadlessUi(int width, int height, const Game_Config& cfg);
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+	bool vChangeDisplaySurfaceResolution(int new_width, int new_height) override;
+	void UpdateDisplay() override;
+	bool ProcessEvents() override;
+	void vGetConfig(Game_ConfigVideo& cfg) const override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+	/** @} */
+
+	/**
+	 * Calculates a hash of the pixels of a bitmap.
+	 *
+	 * @param bitmap bitmap to hash
+	 * @return 64 bit FNV-1a hash
+	 */
+	static uint64_t HashBitmap(const Bitmap& bitmap);
+
+private:
+#ifdef SUPPORT_AUDIO
+	std::unique_ptr<EmptyAudio> audio_;
+#endif
+
+	/** Log of the screen hashes, see --frame-hash-log */
+	std::unique_ptr<Filesystem_Stream::OutputStream> hash_log;
+};
+
+#endif
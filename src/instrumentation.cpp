@@ -18,10 +18,112 @@
 #include "instrumentation.h"
 #include "utils.h"
 
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "filefinder.h"
+#include "output.h"
+#endif
+
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 __itt_domain* Instrumentation::domain = nullptr;
 #endif
 
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+namespace {
+	struct TraceEvent {
+		const char* name;
+		int64_t start;
+		int64_t end;
+		int64_t value;
+	};
+
+	/**
+	 * Zones of one thread. Only the owning thread writes, when the buffer is
+	 * full the oldest zones are overwritten.
+	 */
+	struct TraceBuffer {
+		static constexpr size_t size = 1 << 16;
+
+		std::array<TraceEvent, size> events;
+		std::atomic<uint64_t> head = {0};
+		/** Set while the owning thread records a zone */
+		std::atomic<bool> writing = {false};
+		int thread_id = 0;
+	};
+
+	using clock = std::chrono::steady_clock;
+
+	std::string process_name;
+	clock::time_point epoch = clock::now();
+	std::atomic<bool> recording = {true};
+
+	std::mutex buffers_mutex;
+	std::vector<std::unique_ptr<TraceBuffer>> buffers;
+
+	thread_local TraceBuffer* thread_buffer = nullptr;
+
+	TraceBuffer& GetThreadBuffer() {
+		if (!thread_buffer) {
+			std::lock_guard<std::mutex> lock(buffers_mutex);
+			buffers.push_back(std::make_unique<TraceBuffer>());
+			thread_buffer = buffers.back().get();
+			thread_buffer->thread_id = static_cast<int>(buffers.size());
+		}
+		return *thread_buffer;
+	}
+
+	std::string EscapeJson(std::string_view s) {
+		std::string out;
+		out.reserve(s.size());
+		for (char c: s) {
+			if (c == '"' || c == '\\') {
+				out += '\\';
+				out += c;
+			} else if (static_cast<unsigned char>(c) < 0x20) {
+				out += fmt::format("\\u{:04x}", static_cast<int>(c));
+			} else {
+				out += c;
+			}
+		}
+		return out;
+	}
+}
+
+int64_t Instrumentation::frame_start = 0;
+
+int64_t Instrumentation::Now() {
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - epoch).count();
+}
+
+void Instrumentation::Record(const char* name, int64_t start, int64_t end, int64_t value) {
+	if (!recording.load(std::memory_order_relaxed)) {
+		return;
+	}
+
+	auto& buf = GetThreadBuffer();
+
+	// Sequentially consistent together with Quit: Either Quit waits for this
+	// zone or this thread sees that recording stopped
+	buf.writing.store(true);
+	if (recording.load()) {
+		const uint64_t head = buf.head.load(std::memory_order_relaxed);
+		buf.events[head % TraceBuffer::size] = { name, start, end, value };
+		buf.head.store(head + 1, std::memory_order_release);
+	}
+	buf.writing.store(false, std::memory_order_release);
+}
+#endif
+
 void Instrumentation::Init(const char* name) {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(!domain);
@@ -30,7 +132,57 @@ void Instrumentation::Init(const char* name) {
 #else
 	domain = __itt_domain_create(name);
 #endif
+#elif defined(PLAYER_INSTRUMENTATION_TRACE)
+	process_name = name;
+	epoch = clock::now();
 #else
 	(void)name;
 #endif
 }
+
+void Instrumentation::Quit() {
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+	// Opening the file records zones itself.
+	// Threads that are still running stop recording, zones in progress are
+	// waited for below.
+	recording.store(false);
+
+	const char* env = getenv("EP_TRACE_FILE");
+	std::string path = env ? env : "easyrpg-player-trace.json";
+
+	auto os = FileFinder::Root().OpenOutputStream(path, std::ios_base::out | std::ios_base::trunc);
+	if (!os) {
+		Output::Warning("Instrumentation: Cannot write trace to {}", path);
+		return;
+	}
+
+	os << "{\"traceEvents\":[\n";
+	os << fmt::format(R"({{"name":"process_name","ph":"M","pid":1,"args":{{"name":"{}"}}}})", EscapeJson(process_name));
+
+	size_t num_events = 0;
+	std::lock_guard<std::mutex> lock(buffers_mutex);
+	for (auto& buf: buffers) {
+		while (buf->writing.load(std::memory_order_acquire)) {
+			std::this_thread::yield();
+		}
+
+		const uint64_t head = buf->head.load(std::memory_order_acquire);
+		const uint64_t first = head > TraceBuffer::size ? head - TraceBuffer::size : 0;
+
+		for (uint64_t i = first; i < head; ++i) {
+			const auto& ev = buf->events[i % TraceBuffer::size];
+			os << fmt::format(R"(,{}{{"name":"{}","ph":"X","pid":1,"tid":{},"ts":{:.3f},"dur":{:.3f})",
+				"\n", EscapeJson(ev.name), buf->thread_id, ev.start / 1000.0, (ev.end - ev.start) / 1000.0);
+			if (ev.value != NoValue) {
+				os << fmt::format(R"(,"args":{{"value":{}}})", ev.value);
+			}
+			os << "}";
+		}
+		num_events += head - first;
+	}
+
+	os << "\n]}\n";
+
+	Output::Debug("Instrumentation: Wrote {} zones to {}", num_events, path);
+#endif
+}
@@ -18,14 +18,17 @@
 #ifndef EP_INSTRUMENTATION_H
 #define EP_INSTRUMENTATION_H
 
-#if defined(PLAYER_INSTRUMENTATION) && PLAYER_INSTRUMENTATION == VTune
-#define PLAYER_INSTRUMENTATION_VTUNE
-#endif
+// PLAYER_INSTRUMENTATION_VTUNE: Frame markers for Intel VTune
+// PLAYER_INSTRUMENTATION_TRACE: Built-in zone profiler, writes a Chrome trace
+//   (chrome://tracing, Perfetto) to the file in the environment variable
+//   EP_TRACE_FILE or to easyrpg-player-trace.json
 
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 #include <ittnotify.h>
 #endif
 #include <cassert>
+#include <cstdint>
+#include <limits>
 
 class Instrumentation {
 public:
@@ -36,6 +39,9 @@ public:
 	 */
 	static void Init(const char* name);
 
+	/** Must be called once on shutdown. Writes the collected trace. */
+	static void Quit();
+
 	/** Call at the beginning of a frame */
 	static void FrameBegin();
 
@@ -73,25 +79,97 @@ public:
 		bool begun = false;
 	};
 
+	/** Value of a Zone without value */
+	static constexpr int64_t NoValue = std::numeric_limits<int64_t>::min();
+
+	/**
+	 * Measures the time until the zone is destroyed. Zones can be nested.
+	 * Use the EP_INSTRUMENT_ZONE macro instead, it compiles to nothing when
+	 * the zone profiler is disabled.
+	 */
+	class Zone {
+	public:
+		/**
+		 * Create a Zone
+		 *
+		 * @param name name of the zone, must be a string literal
+		 * @param value number shown as argument of the zone (e.g. the event command)
+		 */
+		explicit Zone(const char* name, int64_t value = NoValue);
+
+		Zone(const Zone&) = delete;
+		Zone& operator=(const Zone&) = delete;
+
+		/** Records the zone */
+		~Zone();
+	private:
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+		const char* name;
+		int64_t value;
+		int64_t start;
+#endif
+	};
+
 private:
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	static __itt_domain* domain;
 #endif
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+	/** @return nanoseconds since Init */
+	static int64_t Now();
+
+	/** Adds a zone to the ring buffer of the calling thread */
+	static void Record(const char* name, int64_t start, int64_t end, int64_t value);
+
+	static int64_t frame_start;
+#endif
 };
 
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+#define EP_INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define EP_INSTRUMENT_CONCAT(a, b) EP_INSTRUMENT_CONCAT_IMPL(a, b)
+/** Measures the enclosing scope, arguments are passed to Instrumentation::Zone */
+#define EP_INSTRUMENT_ZONE(...) Instrumentation::Zone EP_INSTRUMENT_CONCAT(ep_instrument_zone_, __LINE__)(__VA_ARGS__)
+#else
+#define EP_INSTRUMENT_ZONE(...) ((void)0)
+#endif
+
 inline void Instrumentation::FrameBegin() {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(domain);
 	__itt_frame_begin_v3(domain, nullptr);
 #endif
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+	frame_start = Now();
+#endif
 }
 inline void Instrumentation::FrameEnd() {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(domain);
 	__itt_frame_end_v3(domain, nullptr);
 #endif
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+	Record("Frame", frame_start, Now(), NoValue);
+#endif
 }
 
+#ifdef PLAYER_INSTRUMENTATION_TRACE
+inline Instrumentation::Zone::Zone(const char* name, int64_t value)
+	: name(name), value(value), start(Now())
+{
+}
+
+inline Instrumentation::Zone::~Zone() {
+	Record(name, start, Now(), value);
+}
+#else
+inline Instrumentation::Zone::Zone(const char*, int64_t) {
+}
+
+inline Instrumentation::Zone::~Zone() {
+}
+#endif
+
 inline Instrumentation::FrameScope::FrameScope(bool frame_begin)
 {
 	if (frame_begin) {
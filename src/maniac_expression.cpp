@@ -0,0 +1,1000 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "maniac_expression.h"
+
+#include "game_interpreter_control_variables.h"
+#include "game_map.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "output.h"
+#include "player.h"
+#include "utils.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+
+/*
+The following operations are unsupported:
+
+All array functions (Array, Range and Subscript):
+They could be implemented but are not very useful
+
+All Inplace functions:
+These functions are disabled when EasyRpg Extensions are active.
+Inplace assigns to variables while the ControlVariables event command is executed.
+This violates how the command is supposed to work because more variables than the target variables can be set.
+*/
+
+namespace {
+	enum class Op {
+		Null = 0,
+		U8,
+		U16,
+		S32,
+		UX8,
+		UX16,
+		SX32,
+		Var = 8,
+		Switch,
+		VarIndirect = 13,
+		SwitchIndirect,
+		Array = 19,
+		Negate = 24,
+		Not,
+		Flip,
+		AssignInplace = 34,
+		AddInplace,
+		SubInplace,
+		MulInplace,
+		DivInplace,
+		ModInplace,
+		BitOrInplace,
+		BitAndInplace,
+		BitXorInplace,
+		BitShiftLeftInplace,
+		BitShiftRightInplace,
+		Add = 48,
+		Sub,
+		Mul,
+		Div,
+		Mod,
+		BitOr,
+		BitAnd,
+		BitXor,
+		BitShiftLeft,
+		BitShiftRight,
+		Equal,
+		GreaterEqual,
+		LessEqual,
+		Greater,
+		Less,
+		NotEqual,
+		Or,
+		And,
+		Range,
+		Subscript,
+		Ternary = 72,
+		Function = 78
+	};
+
+	enum class Fn {
+		Rand = 0,
+		Item,
+		Event,
+		Actor,
+		Party,
+		Enemy,
+		Misc,
+		Pow,
+		Sqrt,
+		Sin,
+		Cos,
+		Atan2,
+		Min,
+		Max,
+		Abs,
+		Clamp,
+		Muldiv,
+		Divmul,
+		Between,
+		END
+	};
+
+	struct FnInfo {
+		const char* name;
+		int argc;
+	};
+
+	constexpr FnInfo fn_info[] = {
+		{ "rnd", 2 },
+		{ "item", 2 },
+		{ "event", 2 },
+		{ "actor", 2 },
+		{ "member", 2 },
+		{ "enemy", 2 },
+		{ "misc", 1 },
+		{ "pow", 2 },
+		{ "sqrt", 2 },
+		{ "sin", 3 },
+		{ "cos", 3 },
+		{ "atan2", 3 },
+		{ "min", 2 },
+		{ "max", 2 },
+		{ "abs", 1 },
+		{ "clamp", 3 },
+		{ "muldiv", 3 },
+		{ "divmul", 3 },
+		{ "between", 3 }
+	};
+	static_assert(sizeof(fn_info) / sizeof(fn_info[0]) == static_cast<size_t>(Fn::END), "fn_info incomplete");
+
+	constexpr int max_fn_args = 3;
+
+	/** Instructions of the compiled program */
+	enum class Code : uint8_t {
+		/** Push imm */
+		Const,
+		/** Push variable imm */
+		LoadVar,
+		/** Push switch imm */
+		LoadSwitch,
+		/** Replace the ID on the stack with the variable/switch */
+		Var,
+		Switch,
+		VarIndirect,
+		SwitchIndirect,
+		/** Apply op to the top of the stack */
+		Unary,
+		/** Apply op to the two topmost values */
+		Binary,
+		/** Condition, true and false value */
+		Ternary,
+		/** Assign op to the target (argc) with the ID and the value on the stack */
+		Inplace,
+		/** Call function op with argc values */
+		Function
+	};
+
+	int32_t ClampToInt32(int64_t value) {
+		return static_cast<int32_t>(Utils::Clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
+	}
+
+	bool IsLvalue(Op op) {
+		return op == Op::Var || op == Op::Switch || op == Op::VarIndirect || op == Op::SwitchIndirect;
+	}
+
+	bool IsBinary(Op op) {
+		return op >= Op::Add && op <= Op::And;
+	}
+
+	bool IsInplace(Op op) {
+		return op >= Op::AssignInplace && op <= Op::BitShiftRightInplace;
+	}
+
+	struct ProcessAssignmentRet {
+		Op op = Op::Null;
+		int id = 0;
+
+		int fetch() const {
+			switch (op) {
+			case Op::Var:
+				return Main_Data::game_variables->Get(id);
+			case Op::Switch:
+				return Main_Data::game_switches->Get(id);
+			case Op::VarIndirect: {
+				return Main_Data::game_variables->GetIndirect(id);
+			}
+			case Op::SwitchIndirect: {
+				int var = Main_Data::game_variables->GetIndirect(id);
+				return Main_Data::game_switches->Get(var);
+			}
+			default:
+				Output::Warning("Maniac: Expression assignment {} is not a lvalue", static_cast<int>(op));
+				return 0;
+			}
+		}
+
+		int assign(int value) const {
+			if (Player::HasEasyRpgExtensions()) {
+				Output::Warning("Maniac: Inplace assignments are not allowed in expressions when running in EasyRpg Mode");
+				return fetch();
+			}
+
+			switch (op) {
+			case Op::Var:
+				Game_Map::SetNeedRefreshForVarChange(id);
+				return Main_Data::game_variables->Set(id, value);
+			case Op::Switch:
+				Game_Map::SetNeedRefreshForSwitchChange(id);
+				return Main_Data::game_switches->Set(id, value > 0);
+			case Op::VarIndirect: {
+				int var = Main_Data::game_variables->GetIndirect(id);
+				Game_Map::SetNeedRefreshForVarChange(var);
+				return Main_Data::game_variables->Set(var, value);
+			}
+			case Op::SwitchIndirect: {
+				int var = Main_Data::game_variables->GetIndirect(id);
+				Game_Map::SetNeedRefreshForSwitchChange(var);
+				return Main_Data::game_switches->Set(var, value > 0);
+			}
+			default:
+				Output::Warning("Maniac: Expression assignment {} is not a lvalue", static_cast<int>(op));
+				return 0;
+			}
+		}
+	};
+
+	int ApplyUnary(Op op, int value) {
+		switch (op) {
+			case Op::Negate:
+				return -value;
+			case Op::Not:
+				return !value ? 0 : 1;
+			case Op::Flip:
+				return ~value;
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	int ApplyBinary(Op op, int imm, int imm2) {
+		switch (op) {
+			case Op::Add:
+				return ClampToInt32(static_cast<int64_t>(imm) + imm2);
+			case Op::Sub:
+				return ClampToInt32(static_cast<int64_t>(imm) - imm2);
+			case Op::Mul:
+				return ClampToInt32(static_cast<int64_t>(imm) * imm2);
+			case Op::Div:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm / imm2;
+			case Op::Mod:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm % imm2;
+			case Op::BitOr:
+				return imm | imm2;
+			case Op::BitAnd:
+				return imm & imm2;
+			case Op::BitXor:
+				return imm ^ imm2;
+			case Op::BitShiftLeft:
+				return imm << imm2;
+			case Op::BitShiftRight:
+				return imm >> imm2;
+			case Op::Equal:
+				return imm == imm2 ? 1 : 0;
+			case Op::GreaterEqual:
+				return imm >= imm2 ? 1 : 0;
+			case Op::LessEqual:
+				return imm <= imm2 ? 1 : 0;
+			case Op::Greater:
+				return imm > imm2 ? 1 : 0;
+			case Op::Less:
+				return imm < imm2 ? 1 : 0;
+			case Op::NotEqual:
+				return imm != imm2 ? 1 : 0;
+			case Op::Or:
+				return !!imm || !!imm2 ? 1 : 0;
+			case Op::And:
+				return !!imm && !!imm2 ? 1 : 0;
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	int ApplyInplace(Op op, const ProcessAssignmentRet& ret, int imm2) {
+		switch (op) {
+			case Op::AssignInplace:
+				return ret.assign(imm2);
+			case Op::AddInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) + imm2));
+			case Op::SubInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) - imm2));
+			case Op::MulInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) * imm2));
+			case Op::DivInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() / imm2);
+			case Op::ModInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() % imm2);
+			case Op::BitOrInplace:
+				return ret.assign(ret.fetch() | imm2);
+			case Op::BitAndInplace:
+				return ret.assign(ret.fetch() & imm2);
+			case Op::BitXorInplace:
+				return ret.assign(ret.fetch() ^ imm2);
+			case Op::BitShiftLeftInplace:
+				return ret.assign(ret.fetch() << imm2);
+			case Op::BitShiftRightInplace:
+				return ret.assign(ret.fetch() >> imm2);
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	/**
+	 * Calls an expression function.
+	 * The arguments are stored last to first in the op-code stream, args is
+	 * in parameter order (args[0] was read last).
+	 */
+	int CallFunction(Fn fn, const int* args, const Game_BaseInterpreterContext& ip) {
+		switch (fn) {
+			case Fn::Rand:
+				return ControlVariables::Random(args[0], args[1]);
+			case Fn::Item:
+				return ControlVariables::Item(args[0], args[1]);
+			case Fn::Event:
+				return ControlVariables::Event(args[0], args[1], ip);
+			case Fn::Actor:
+				return ControlVariables::Actor(args[0], args[1]);
+			case Fn::Party:
+				return ControlVariables::Party(args[0], args[1]);
+			case Fn::Enemy:
+				return ControlVariables::Enemy(args[0], args[1]);
+			case Fn::Misc:
+				return ControlVariables::Other(args[0]);
+			case Fn::Pow:
+				return ControlVariables::Pow(args[0], args[1]);
+			case Fn::Sqrt:
+				return ControlVariables::Sqrt(args[0], args[1]);
+			case Fn::Sin:
+				return ControlVariables::Sin(args[0], args[1], args[2]);
+			case Fn::Cos:
+				return ControlVariables::Cos(args[0], args[1], args[2]);
+			case Fn::Atan2:
+				return ControlVariables::Atan2(args[0], args[1], args[2]);
+			case Fn::Min:
+				return ControlVariables::Min(args[0], args[1]);
+			case Fn::Max:
+				return ControlVariables::Max(args[0], args[1]);
+			case Fn::Abs:
+				return ControlVariables::Abs(args[0]);
+			case Fn::Clamp:
+				return ControlVariables::Clamp(args[0], args[1], args[2]);
+			case Fn::Muldiv:
+				return ControlVariables::Muldiv(args[0], args[1], args[2]);
+			case Fn::Divmul:
+				return ControlVariables::Divmul(args[0], args[1], args[2]);
+			case Fn::Between:
+				return ControlVariables::Between(args[0], args[1], args[2]);
+			default:
+				assert(false);
+				return 0;
+		}
+	}
+
+	/** Splits the op-codes into bytes */
+	std::vector<int32_t> DecodeOpCodes(Span<const int32_t> op_codes) {
+		std::vector<int32_t> ops;
+		ops.reserve(op_codes.size() * 4);
+		for (auto &o: op_codes) {
+			auto uo = static_cast<uint32_t>(o);
+			ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
+			ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
+			ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
+			ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+		}
+		return ops;
+	}
+
+	int32_t MakeS32(int32_t b0, int32_t b1, int32_t b2, int32_t b3) {
+		return static_cast<int32_t>((static_cast<uint32_t>(b3) << 24) + (static_cast<uint32_t>(b2) << 16) + (static_cast<uint32_t>(b1) << 8) + static_cast<uint32_t>(b0));
+	}
+
+	using OpIterator = std::vector<int32_t>::const_iterator;
+
+	ProcessAssignmentRet ProcessAssignment(OpIterator& it, OpIterator end, const Game_BaseInterpreterContext& ip);
+
+	int Process(OpIterator& it, OpIterator end, const Game_BaseInterpreterContext& ip) {
+		int value = 0;
+		int imm = 0;
+		int imm2 = 0;
+		int imm3 = 0;
+
+		if (it == end) {
+			return 0;
+		}
+
+		auto op = static_cast<Op>(*it);
+		++it;
+
+		// When entering the switch it is on the first argument
+		switch (op) {
+			case Op::Null:
+				it++;
+				return 0;
+			case Op::U8:
+			case Op::UX8:
+				value = *it++;
+				return value;
+			case Op::U16:
+			case Op::UX16:
+				imm = *it++;
+				if (it == end) {
+					return 0;
+				}
+				imm2 = *it++;
+				value = (imm2 << 8) + imm;
+				return value;
+			case Op::S32:
+			case Op::SX32:
+				imm = *it++;
+				if (it == end) {
+					return 0;
+				}
+				imm2 = *it++;
+				if (it == end) {
+					return 0;
+				}
+				imm3 = *it++;
+				if (it == end) {
+					return 0;
+				}
+				value = *it++;
+				return MakeS32(imm, imm2, imm3, value);
+			case Op::Var:
+				imm = Process(it, end, ip);
+				return Main_Data::game_variables->Get(imm);
+			case Op::Switch:
+				imm = Process(it, end, ip);
+				return Main_Data::game_switches->GetInt(imm);
+			case Op::VarIndirect:
+				imm = Process(it, end, ip);
+				return Main_Data::game_variables->GetIndirect(imm);
+			case Op::SwitchIndirect:
+				imm = Process(it, end, ip);
+				return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(imm));
+			case Op::Negate:
+			case Op::Not:
+			case Op::Flip:
+				imm = Process(it, end, ip);
+				return ApplyUnary(op, imm);
+			case Op::AssignInplace:
+			case Op::AddInplace:
+			case Op::SubInplace:
+			case Op::MulInplace:
+			case Op::DivInplace:
+			case Op::ModInplace:
+			case Op::BitOrInplace:
+			case Op::BitAndInplace:
+			case Op::BitXorInplace:
+			case Op::BitShiftLeftInplace:
+			case Op::BitShiftRightInplace: {
+				auto ret = ProcessAssignment(it, end, ip);
+				imm2 = Process(it, end, ip);
+				return ApplyInplace(op, ret, imm2);
+			}
+			case Op::Add:
+			case Op::Sub:
+			case Op::Mul:
+			case Op::Div:
+			case Op::Mod:
+			case Op::BitOr:
+			case Op::BitAnd:
+			case Op::BitXor:
+			case Op::BitShiftLeft:
+			case Op::BitShiftRight:
+			case Op::Equal:
+			case Op::GreaterEqual:
+			case Op::LessEqual:
+			case Op::Greater:
+			case Op::Less:
+			case Op::NotEqual:
+			case Op::Or:
+			case Op::And:
+				imm = Process(it, end, ip);
+				imm2 = Process(it, end, ip);
+				return ApplyBinary(op, imm, imm2);
+			case Op::Ternary:
+				imm = Process(it, end, ip);
+				imm2 = Process(it, end, ip);
+				imm3 = Process(it, end, ip);
+				return imm != 0 ? imm2 : imm3;
+			case Op::Function: {
+				imm = *it++; // function
+				imm2 = *it++; // arguments
+
+				if ((imm2 & 0x80) != 0) {
+					// Argument count is 4 bytes, that mode is not supported
+					Output::Warning("Maniac: Expression func long args unsupported");
+					return 0;
+				}
+
+				if (imm < 0 || imm >= static_cast<int>(Fn::END)) {
+					Output::Warning("Maniac: Expression Unknown Func {}", imm);
+					for (int i = 0; i < imm2; ++i) {
+						Process(it, end, ip);
+					}
+					return 0;
+				}
+
+				const auto& info = fn_info[imm];
+				if (imm2 != info.argc) {
+					Output::Warning("Maniac: Expression {} args {} != {}", info.name, imm2, info.argc);
+					return 0;
+				}
+
+				int args[max_fn_args] = {};
+				for (int i = info.argc - 1; i >= 0; --i) {
+					args[i] = Process(it, end, ip);
+				}
+				return CallFunction(static_cast<Fn>(imm), args, ip);
+			}
+			default:
+				Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
+				return 0;
+		}
+	}
+
+	ProcessAssignmentRet ProcessAssignment(OpIterator& it, OpIterator end, const Game_BaseInterpreterContext& ip) {
+		// Like process but it remembers the type (Variable or Switch) without evaluating it to allow assignments
+		int imm = 0;
+
+		if (it == end) {
+			return {Op::Null, 0};
+		}
+
+		auto op = static_cast<Op>(*it);
+		++it;
+
+		// When entering the switch it is on the first argument
+		switch (op) {
+			case Op::Var:
+			case Op::Switch:
+			case Op::VarIndirect:
+			case Op::SwitchIndirect:
+				imm = Process(it, end, ip);
+				return {op, imm};
+			default:
+				--it; // back on the op as op is fetched again by Process
+				imm = Process(it, end, ip);
+				return {op, imm};
+		}
+	}
+
+	/**
+	 * Compiles the op-code stream into a stack program.
+	 * Every construct that makes the tree walker print a warning or read
+	 * out of bounds is rejected, these streams are interpreted.
+	 */
+	class Compiler {
+	public:
+		Compiler(const std::vector<int32_t>& ops, std::vector<ManiacExpression::Instruction>& program)
+			: ops(ops), program(program) {}
+
+		bool Expression();
+
+		bool AtEnd() const {
+			return pos >= ops.size();
+		}
+
+		bool AtTerminator() const {
+			return AtEnd() || static_cast<Op>(ops[pos]) == Op::Null;
+		}
+
+	private:
+		void Emit(Code code, int op = 0, int argc = 0, int32_t imm = 0) {
+			program.push_back({ static_cast<uint8_t>(code), static_cast<uint8_t>(op), static_cast<uint8_t>(argc), imm });
+		}
+
+		bool IsConst(size_t begin, size_t end) const {
+			return end - begin == 1 && static_cast<Code>(program[begin].code) == Code::Const;
+		}
+
+		/** Replaces the instructions from begin with a constant */
+		void Fold(size_t begin, int32_t value) {
+			program.resize(begin);
+			Emit(Code::Const, 0, 0, value);
+		}
+
+		const std::vector<int32_t>& ops;
+		std::vector<ManiacExpression::Instruction>& program;
+		size_t pos = 0;
+	};
+
+	bool Compiler::Expression() {
+		if (AtEnd()) {
+			Emit(Code::Const);
+			return true;
+		}
+
+		const auto op = static_cast<Op>(ops[pos++]);
+		const size_t begin = program.size();
+
+		switch (op) {
+			case Op::Null:
+				if (AtEnd()) {
+					return false;
+				}
+				++pos;
+				Emit(Code::Const);
+				return true;
+			case Op::U8:
+			case Op::UX8:
+				if (AtEnd()) {
+					return false;
+				}
+				Emit(Code::Const, 0, 0, ops[pos++]);
+				return true;
+			case Op::U16:
+			case Op::UX16: {
+				if (AtEnd()) {
+					return false;
+				}
+				const int32_t b0 = ops[pos++];
+				if (AtEnd()) {
+					Emit(Code::Const);
+					return true;
+				}
+				const int32_t b1 = ops[pos++];
+				Emit(Code::Const, 0, 0, (b1 << 8) + b0);
+				return true;
+			}
+			case Op::S32:
+			case Op::SX32: {
+				int32_t b[4];
+				for (int i = 0; i < 4; ++i) {
+					if (AtEnd()) {
+						if (i == 0) {
+							return false;
+						}
+						Emit(Code::Const);
+						return true;
+					}
+					b[i] = ops[pos++];
+				}
+				Emit(Code::Const, 0, 0, MakeS32(b[0], b[1], b[2], b[3]));
+				return true;
+			}
+			case Op::Var:
+			case Op::Switch:
+			case Op::VarIndirect:
+			case Op::SwitchIndirect: {
+				if (!Expression()) {
+					return false;
+				}
+				const bool is_const = IsConst(begin, program.size());
+				if (op == Op::Var && is_const) {
+					program.back().code = static_cast<uint8_t>(Code::LoadVar);
+				} else if (op == Op::Switch && is_const) {
+					program.back().code = static_cast<uint8_t>(Code::LoadSwitch);
+				} else if (op == Op::Var) {
+					Emit(Code::Var);
+				} else if (op == Op::Switch) {
+					Emit(Code::Switch);
+				} else if (op == Op::VarIndirect) {
+					Emit(Code::VarIndirect);
+				} else {
+					Emit(Code::SwitchIndirect);
+				}
+				return true;
+			}
+			case Op::Negate:
+			case Op::Not:
+			case Op::Flip:
+				if (!Expression()) {
+					return false;
+				}
+				if (IsConst(begin, program.size())) {
+					Fold(begin, ApplyUnary(op, program[begin].imm));
+				} else {
+					Emit(Code::Unary, static_cast<int>(op));
+				}
+				return true;
+			case Op::Ternary: {
+				if (!Expression()) {
+					return false;
+				}
+				const size_t second = program.size();
+				if (!Expression()) {
+					return false;
+				}
+				const size_t third = program.size();
+				if (!Expression()) {
+					return false;
+				}
+				if (IsConst(begin, second) && IsConst(second, third) && IsConst(third, program.size())) {
+					Fold(begin, program[begin].imm != 0 ? program[second].imm : program[third].imm);
+				} else {
+					Emit(Code::Ternary);
+				}
+				return true;
+			}
+			case Op::Function: {
+				if (pos + 2 > ops.size()) {
+					return false;
+				}
+				const int32_t fn = ops[pos++];
+				const int32_t argc = ops[pos++];
+				if ((argc & 0x80) != 0 || fn < 0 || fn >= static_cast<int>(Fn::END) || argc != fn_info[fn].argc) {
+					return false;
+				}
+				for (int i = 0; i < argc; ++i) {
+					if (!Expression()) {
+						return false;
+					}
+				}
+				Emit(Code::Function, fn, argc);
+				return true;
+			}
+			default:
+				break;
+		}
+
+		if (IsInplace(op)) {
+			// Assignments to something else than a variable or switch only warn
+			if (AtEnd() || !IsLvalue(static_cast<Op>(ops[pos]))) {
+				return false;
+			}
+			const auto target = static_cast<Op>(ops[pos++]);
+			if (!Expression() || !Expression()) {
+				return false;
+			}
+			Emit(Code::Inplace, static_cast<int>(op), static_cast<int>(target));
+			return true;
+		}
+
+		if (IsBinary(op)) {
+			if (!Expression()) {
+				return false;
+			}
+			const size_t second = program.size();
+			if (!Expression()) {
+				return false;
+			}
+			if (IsConst(begin, second) && IsConst(second, program.size())) {
+				Fold(begin, ApplyBinary(op, program[begin].imm, program[second].imm));
+			} else {
+				Emit(Code::Binary, static_cast<int>(op));
+			}
+			return true;
+		}
+
+		// Unsupported operation
+		return false;
+	}
+
+	int StackEffect(const ManiacExpression::Instruction& ins) {
+		switch (static_cast<Code>(ins.code)) {
+			case Code::Const:
+			case Code::LoadVar:
+			case Code::LoadSwitch:
+				return 1;
+			case Code::Binary:
+			case Code::Inplace:
+				return -1;
+			case Code::Ternary:
+				return -2;
+			case Code::Function:
+				return 1 - ins.argc;
+			default:
+				return 0;
+		}
+	}
+
+	// The interpreter copies the command lists it runs, so the cache is keyed
+	// by the content of the op-code stream and not by its address
+	uint64_t HashOpCodes(Span<const int32_t> op_codes) {
+		// 64 bit FNV-1a
+		uint64_t hash = 14695981039346656037ULL;
+		for (int32_t value: op_codes) {
+			hash ^= static_cast<uint32_t>(value);
+			hash *= 1099511628211ULL;
+		}
+		return hash;
+	}
+
+	constexpr size_t cache_limit = 4096;
+	std::unordered_map<uint64_t, std::unique_ptr<ManiacExpression>> cache;
+}
+
+ManiacExpression::ManiacExpression(Span<const int32_t> op_codes)
+	: op_codes(op_codes.begin(), op_codes.end())
+{
+	const auto ops = DecodeOpCodes(op_codes);
+	if (ops.empty()) {
+		complete = true;
+		return;
+	}
+
+	Compiler compiler(ops, program);
+	while (compiler.Expression()) {
+		expression_ends.push_back(static_cast<int>(program.size()));
+		if (compiler.AtTerminator()) {
+			complete = true;
+			break;
+		}
+	}
+	if (!complete) {
+		// Drop the partially compiled expression
+		program.resize(expression_ends.empty() ? 0 : expression_ends.back());
+	}
+
+	int depth = 0;
+	size_t expr = 0;
+	for (size_t i = 0; i < program.size(); ++i) {
+		depth += StackEffect(program[i]);
+		max_stack = std::max(max_stack, depth);
+		if (static_cast<int>(i) + 1 == expression_ends[expr]) {
+			assert(depth == 1);
+			depth = 0;
+			++expr;
+		}
+	}
+}
+
+const ManiacExpression& ManiacExpression::Get(Span<const int32_t> op_codes) {
+	const uint64_t key = HashOpCodes(op_codes);
+	auto it = cache.find(key);
+	if (it != cache.end()) {
+		const auto& cached = it->second->op_codes;
+		if (std::equal(cached.begin(), cached.end(), op_codes.begin(), op_codes.end())) {
+			return *it->second;
+		}
+	} else if (cache.size() >= cache_limit) {
+		cache.clear();
+	}
+
+	// New stream or hash collision
+	auto& entry = cache[key];
+	entry = std::make_unique<ManiacExpression>(op_codes);
+	return *entry;
+}
+
+void ManiacExpression::ClearCache() {
+	cache.clear();
+}
+
+size_t ManiacExpression::GetCacheSize() {
+	return cache.size();
+}
+
+int32_t ManiacExpression::Run(int begin, int end, const Game_BaseInterpreterContext& ip) const {
+	constexpr int small_stack_size = 32;
+	int32_t small_stack[small_stack_size];
+	std::vector<int32_t> large_stack;
+	int32_t* stack = small_stack;
+	if (max_stack > small_stack_size) {
+		large_stack.resize(max_stack);
+		stack = large_stack.data();
+	}
+
+	int sp = 0;
+	for (int i = begin; i < end; ++i) {
+		const auto& ins = program[i];
+		switch (static_cast<Code>(ins.code)) {
+			case Code::Const:
+				stack[sp++] = ins.imm;
+				break;
+			case Code::LoadVar:
+				stack[sp++] = Main_Data::game_variables->Get(ins.imm);
+				break;
+			case Code::LoadSwitch:
+				stack[sp++] = Main_Data::game_switches->GetInt(ins.imm);
+				break;
+			case Code::Var:
+				stack[sp - 1] = Main_Data::game_variables->Get(stack[sp - 1]);
+				break;
+			case Code::Switch:
+				stack[sp - 1] = Main_Data::game_switches->GetInt(stack[sp - 1]);
+				break;
+			case Code::VarIndirect:
+				stack[sp - 1] = Main_Data::game_variables->GetIndirect(stack[sp - 1]);
+				break;
+			case Code::SwitchIndirect:
+				stack[sp - 1] = Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(stack[sp - 1]));
+				break;
+			case Code::Unary:
+				stack[sp - 1] = ApplyUnary(static_cast<Op>(ins.op), stack[sp - 1]);
+				break;
+			case Code::Binary:
+				--sp;
+				stack[sp - 1] = ApplyBinary(static_cast<Op>(ins.op), stack[sp - 1], stack[sp]);
+				break;
+			case Code::Ternary:
+				sp -= 2;
+				stack[sp - 1] = stack[sp - 1] != 0 ? stack[sp] : stack[sp + 1];
+				break;
+			case Code::Inplace: {
+				--sp;
+				ProcessAssignmentRet ret = { static_cast<Op>(ins.argc), stack[sp - 1] };
+				stack[sp - 1] = ApplyInplace(static_cast<Op>(ins.op), ret, stack[sp]);
+				break;
+			}
+			case Code::Function: {
+				sp -= ins.argc;
+				int args[max_fn_args] = {};
+				for (int a = 0; a < ins.argc; ++a) {
+					args[a] = stack[sp + ins.argc - 1 - a];
+				}
+				stack[sp++] = CallFunction(static_cast<Fn>(ins.op), args, ip);
+				break;
+			}
+		}
+	}
+
+	assert(sp == 1);
+	return stack[0];
+}
+
+int32_t ManiacExpression::Evaluate(const Game_BaseInterpreterContext& interpreter) const {
+	if (expression_ends.empty()) {
+		return op_codes.empty() ? 0 : Interpret(op_codes, interpreter);
+	}
+	return Run(0, expression_ends[0], interpreter);
+}
+
+std::vector<int32_t> ManiacExpression::EvaluateAll(const Game_BaseInterpreterContext& interpreter) const {
+	if (!complete) {
+		return InterpretAll(op_codes, interpreter);
+	}
+
+	std::vector<int32_t> results;
+	results.reserve(expression_ends.size());
+	int begin = 0;
+	for (int end: expression_ends) {
+		results.push_back(Run(begin, end, interpreter));
+		begin = end;
+	}
+	return results;
+}
+
+int32_t ManiacExpression::Interpret(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto ops = DecodeOpCodes(op_codes);
+	auto beg = ops.begin();
+	return Process(beg, ops.end(), interpreter);
+}
+
+std::vector<int32_t> ManiacExpression::InterpretAll(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	const auto ops = DecodeOpCodes(op_codes);
+
+	if (ops.empty()) {
+		return {};
+	}
+
+	auto it = ops.begin();
+
+	std::vector<int32_t> results;
+
+	while (true) {
+		results.push_back(Process(it, ops.end(), interpreter));
+
+		if (it == ops.end() || static_cast<Op>(*it) == Op::Null) {
+			break;
+		}
+	}
+
+	return results;
+}
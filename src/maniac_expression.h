@@ -0,0 +1,132 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MANIAC_EXPRESSION_H
+#define EP_MANIAC_EXPRESSION_H
+
+// Headers
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "span.h"
+
+class Game_BaseInterpreterContext;
+
+/**
+ * Maniac Patch expression (op-code stream of Control Variables,
+ * Conditional Branch etc.) compiled into a flat stack program.
+ *
+ * Constant sub-expressions are folded and variable/switch reads with a
+ * constant ID become a single instruction.
+ * Streams that cannot be compiled (unsupported operations, wrong function
+ * argument counts, truncated data) are evaluated by the tree walking
+ * interpreter, which reports the errors.
+ */
+class ManiacExpression {
+public:
+	/**
+	 * Compiles an op-code stream.
+	 *
+	 * @param op_codes op-codes (4 bytes per value) as stored in the event command
+	 */
+	explicit ManiacExpression(Span<const int32_t> op_codes);
+
+	/**
+	 * Returns the compiled expression of an op-code stream.
+	 * The result is cached by the content of the op-code stream (the parameters
+	 * of an event command), copies of a command list share the compiled program.
+	 *
+	 * @param op_codes op-codes as stored in the event command
+	 * @return compiled expression, valid until the next call
+	 */
+	static const ManiacExpression& Get(Span<const int32_t> op_codes);
+
+	/** Removes all cached expressions */
+	static void ClearCache();
+
+	/** @return Amount of cached expressions */
+	static size_t GetCacheSize();
+
+	/**
+	 * Evaluates the first expression of the stream.
+	 *
+	 * @param interpreter interpreter context
+	 * @return result
+	 */
+	int32_t Evaluate(const Game_BaseInterpreterContext& interpreter) const;
+
+	/**
+	 * Evaluates a stream of multiple expressions terminated by a Null op.
+	 *
+	 * @param interpreter interpreter context
+	 * @return result of each expression
+	 */
+	std::vector<int32_t> EvaluateAll(const Game_BaseInterpreterContext& interpreter) const;
+
+	/** @return Whether the first expression was compiled */
+	bool IsCompiled() const;
+
+	/** @return Amount of instructions of the compiled program */
+	int GetNumInstructions() const;
+
+	/**
+	 * Evaluates the first expression by walking the op-code stream.
+	 * This is the slow path used when the stream cannot be compiled.
+	 *
+	 * @param op_codes op-codes as stored in the event command
+	 * @param interpreter interpreter context
+	 * @return result
+	 */
+	static int32_t Interpret(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates a stream of multiple expressions by walking the op-code stream.
+	 *
+	 * @param op_codes op-codes as stored in the event command
+	 * @param interpreter interpreter context
+	 * @return result of each expression
+	 */
+	static std::vector<int32_t> InterpretAll(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	struct Instruction {
+		uint8_t code;
+		uint8_t op;
+		uint8_t argc;
+		int32_t imm;
+	};
+
+private:
+	int32_t Run(int begin, int end, const Game_BaseInterpreterContext& interpreter) const;
+
+	std::vector<int32_t> op_codes;
+	std::vector<Instruction> program;
+	/** End of the instructions of each expression in program */
+	std::vector<int> expression_ends;
+	/** Whether all expressions until the terminator were compiled */
+	bool complete = false;
+	int max_stack = 0;
+};
+
+inline bool ManiacExpression::IsCompiled() const {
+	return !expression_ends.empty() || (complete && op_codes.empty());
+}
+
+inline int ManiacExpression::GetNumInstructions() const {
+	return static_cast<int>(program.size());
+}
+
+#endif
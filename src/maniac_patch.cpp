@@ -20,13 +20,13 @@
 #include "filesystem_stream.h"
 #include "input.h"
 #include "game_actors.h"
-#include "game_interpreter_control_variables.h"
 #include "game_map.h"
 #include "game_interpreter.h"
 #include "game_party.h"
 #include "game_switches.h"
 #include "game_variables.h"
 #include "main_data.h"
+#include "maniac_expression.h"
 #include "output.h"
 #include "player.h"
 
@@ -35,574 +35,16 @@
 #include <lcf/writer_lcf.h>
 #include <vector>
 
-/*
-The following operations are unsupported:
-
-All array functions (Array, Range and Subscript):
-They could be implemented but are not very useful
-
-All Inplace functions:
-These functions are disabled when EasyRpg Extensions are active.
-Inplace assigns to variables while the ControlVariables event command is executed.
-This violates how the command is supposed to work because more variables than the target variables can be set.
-*/
-
 namespace {
-	enum class Op {
-		Null = 0,
-		U8,
-		U16,
-		S32,
-		UX8,
-		UX16,
-		SX32,
-		Var = 8,
-		Switch,
-		VarIndirect = 13,
-		SwitchIndirect,
-		Array = 19,
-		Negate = 24,
-		Not,
-		Flip,
-		AssignInplace = 34,
-		AddInplace,
-		SubInplace,
-		MulInplace,
-		DivInplace,
-		ModInplace,
-		BitOrInplace,
-		BitAndInplace,
-		BitXorInplace,
-		BitShiftLeftInplace,
-		BitShiftRightInplace,
-		Add = 48,
-		Sub,
-		Mul,
-		Div,
-		Mod,
-		BitOr,
-		BitAnd,
-		BitXor,
-		BitShiftLeft,
-		BitShiftRight,
-		Equal,
-		GreaterEqual,
-		LessEqual,
-		Greater,
-		Less,
-		NotEqual,
-		Or,
-		And,
-		Range,
-		Subscript,
-		Ternary = 72,
-		Function = 78
-	};
-
-	enum class Fn {
-		Rand = 0,
-		Item,
-		Event,
-		Actor,
-		Party,
-		Enemy,
-		Misc,
-		Pow,
-		Sqrt,
-		Sin,
-		Cos,
-		Atan2,
-		Min,
-		Max,
-		Abs,
-		Clamp,
-		Muldiv,
-		Divmul,
-		Between
-	};
-
 	bool global_save_opened = false;
 }
 
-struct ProcessAssignmentRet {
-	Op op = Op::Null;
-	int id = 0;
-
-	int fetch() const {
-		switch (op) {
-		case Op::Var:
-			return Main_Data::game_variables->Get(id);
-		case Op::Switch:
-			return Main_Data::game_switches->Get(id);
-		case Op::VarIndirect: {
-			return Main_Data::game_variables->GetIndirect(id);
-		}
-		case Op::SwitchIndirect: {
-			int var = Main_Data::game_variables->GetIndirect(id);
-			return Main_Data::game_switches->Get(var);
-		}
-		default:
-			Output::Warning("Maniac: Expression assignment {} is not a lvalue", static_cast<int>(op));
-			return 0;
-		}
-	}
-
-	int assign(int value) const {
-		if (Player::HasEasyRpgExtensions()) {
-			Output::Warning("Maniac: Inplace assignments are not allowed in expressions when running in EasyRpg Mode");
-			return fetch();
-		}
-
-		switch (op) {
-		case Op::Var:
-			Game_Map::SetNeedRefreshForVarChange(id);
-			return Main_Data::game_variables->Set(id, value);
-		case Op::Switch:
-			Game_Map::SetNeedRefreshForSwitchChange(id);
-			return Main_Data::game_switches->Set(id, value > 0);
-		case Op::VarIndirect: {
-			int var = Main_Data::game_variables->GetIndirect(id);
-			Game_Map::SetNeedRefreshForVarChange(var);
-			return Main_Data::game_variables->Set(var, value);
-		}
-		case Op::SwitchIndirect: {
-			int var = Main_Data::game_variables->GetIndirect(id);
-			Game_Map::SetNeedRefreshForSwitchChange(var);
-			return Main_Data::game_switches->Set(var, value > 0);
-		}
-		default:
-			Output::Warning("Maniac: Expression assignment {} is not a lvalue", static_cast<int>(op));
-			return 0;
-		}
-	}
-};
-
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip);
-
-int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	int value = 0;
-	int imm = 0;
-	int imm2 = 0;
-	int imm3 = 0;
-
-	if (it == end) {
-		return 0;
-	}
-
-	auto op = static_cast<Op>(*it);
-	++it;
-
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Null:
-			it++;
-			return 0;
-		case Op::U8:
-		case Op::UX8:
-			value = *it++;
-			return value;
-		case Op::U16:
-		case Op::UX16:
-			imm = *it++;
-			if (it == end) {
-				return 0;
-			}
-			imm2 = *it++;
-			value = (imm2 << 8) + imm;
-			return value;
-		case Op::S32:
-		case Op::SX32:
-			imm = *it++;
-			if (it == end) {
-				return 0;
-			}
-			imm2 = *it++;
-			if (it == end) {
-				return 0;
-			}
-			imm3 = *it++;
-			if (it == end) {
-				return 0;
-			}
-			value = *it++;
-			value = (value << 24) + (imm3 << 16) + (imm2 << 8) + imm;
-			return value;
-		case Op::Var:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->Get(imm);
-		case Op::Switch:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(imm);
-		case Op::VarIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->GetIndirect(imm);
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(imm));
-		case Op::Negate:
-			imm = Process(it, end, ip);
-			return -imm;
-		case Op::Not:
-			imm = Process(it, end, ip);
-			return !imm ? 0 : 1;
-		case Op::Flip:
-			imm = Process(it, end, ip);
-			return ~imm;
-		case Op::AssignInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(imm2);
-		}
-		case Op::AddInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::SubInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::MulInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::DivInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() / imm2);
-		}
-		case Op::ModInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() % imm2);
-		}
-		case Op::BitOrInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() | imm2);
-		}
-		case Op::BitAndInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() & imm2);
-		}
-		case Op::BitXorInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() ^ imm2);
-		}
-		case Op::BitShiftLeftInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() << imm2);
-		}
-		case Op::BitShiftRightInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() >> imm2);
-		}
-		case Op::Add:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Sub:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Mul:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Div:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
-			}
-			return imm / imm2;
-		case Op::Mod:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
-			}
-			return imm % imm2;
-		case Op::BitOr:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm | imm2;
-		case Op::BitAnd:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm & imm2;
-		case Op::BitXor:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm ^ imm2;
-		case Op::BitShiftLeft:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm << imm2;
-		case Op::BitShiftRight:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >> imm2;
-		case Op::Equal:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm == imm2 ? 1 : 0;
-		case Op::GreaterEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >= imm2 ? 1 : 0;
-		case Op::LessEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm <= imm2 ? 1 : 0;
-		case Op::Greater:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm > imm2 ? 1 : 0;
-		case Op::Less:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm < imm2 ? 1 : 0;
-		case Op::NotEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm != imm2 ? 1 : 0;
-		case Op::Or:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm || !!imm2 ? 1 : 0;
-		case Op::And:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm && !!imm2 ? 1 : 0;
-		case Op::Ternary:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			imm3 = Process(it, end, ip);
-			return imm != 0 ? imm2 : imm3;
-		case Op::Function:
-			imm = *it++; // function
-			imm2 = *it++; // arguments
-
-			if ((imm2 & 0x80) != 0) {
-				// Argument count is 4 bytes, that mode is not supported
-				Output::Warning("Maniac: Expression func long args unsupported");
-				return 0;
-			}
-
-			switch (static_cast<Fn>(imm)) {
-				case Fn::Rand:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression rnd args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Random(Process(it, end, ip), imm3);
-				case Fn::Item:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression item args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Item(Process(it, end, ip), imm3);
-				case Fn::Event:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression event args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Event(Process(it, end, ip), imm3, ip);
-				case Fn::Actor:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression actor args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Actor(Process(it, end, ip), imm3);
-				case Fn::Party:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression member args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Party(Process(it, end, ip), imm3);
-				case Fn::Enemy:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression enemy args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Enemy(Process(it, end, ip), imm3);
-					break;
-				case Fn::Misc:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression misc args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Other(Process(it, end, ip));
-				case Fn::Pow:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression pow args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Pow(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sqrt:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression sqrt args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Sqrt(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sin:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression sin args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Sin(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Cos:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression cos args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Cos(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Atan2:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression atan2 args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Atan2(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Min:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression min args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Min(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Max:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression max args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Max(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Abs:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression abs args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Abs(Process(it, end, ip));
-				case Fn::Clamp:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression clamp args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Clamp(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Muldiv:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression muldiv args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Muldiv(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Divmul:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression divmul args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Divmul(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Between:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression between args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Between(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				default:
-					Output::Warning("Maniac: Expression Unknown Func {}", imm);
-					for (int i = 0; i < imm2; ++i) {
-						Process(it, end, ip);
-					}
-					return 0;
-			}
-		default:
-			Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
-			return 0;
-	}
-}
-
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	// Like process but it remembers the type (Variable or Switch) without evaluating it to allow assignments
-	int imm = 0;
-
-	if (it == end) {
-		return {Op::Null, 0};
-	}
-
-	auto op = static_cast<Op>(*it);
-	++it;
-
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Var:
-		case Op::Switch:
-		case Op::VarIndirect:
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return {op, imm};
-		default:
-			--it; // back on the op as op is fetched again by Process
-			imm = Process(it, end, ip);
-			return {op, imm};
-	}
-}
-
 int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto &o: op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
-	auto beg = ops.begin();
-	return Process(beg, ops.end(), interpreter);
+	return ManiacExpression::Get(op_codes).Evaluate(interpreter);
 }
 
 std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto& o : op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
-
-	if (ops.empty()) {
-		return {};
-	}
-
-	auto it = ops.begin();
-
-	std::vector<int32_t> results;
-
-	while (true) {
-		results.push_back(Process(it, ops.end(), interpreter));
-
-		if (it == ops.end() || static_cast<Op>(*it) == Op::Null) {
-			break;
-		}
-	}
-
-	return results;
+	return ManiacExpression::Get(op_codes).EvaluateAll(interpreter);
 }
 
 std::array<bool, 50> ManiacPatch::GetKeyRange() {
@@ -0,0 +1,275 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "map_preload.h"
+#include "filefinder.h"
+#include "filesystem_stream.h"
+#include "game_map.h"
+#include "input.h"
+#include "instrumentation.h"
+#include "output.h"
+#include "player.h"
+#include "translation.h"
+#include "utils.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <unordered_map>
+#include <lcf/lmu/reader.h>
+
+namespace {
+	struct CacheItem {
+		std::unique_ptr<const lcf::rpg::Map> map;
+		uint32_t crc = 0;
+		size_t size = 0;
+		uint64_t last_use = 0;
+	};
+
+	struct PendingItem {
+		std::future<std::unique_ptr<lcf::rpg::Map>> result;
+		uint32_t crc = 0;
+
+		bool IsReady() const {
+			return result.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+		}
+	};
+
+	std::unordered_map<int, CacheItem> cache;
+	std::unordered_map<int, PendingItem> pending;
+	/** Requested maps whose file was not read yet, highest priority first */
+	std::deque<int> requests;
+	uint64_t use_counter = 0;
+
+	constexpr size_t default_budget = 16 * 1024 * 1024;
+	size_t budget = default_budget;
+	size_t cache_size = 0;
+
+	MapPreload::Stats stats;
+
+	WorkerPool& GetParsePool() {
+		// Maps are parsed one after another, the order of the requests is the priority
+		static WorkerPool pool(std::min(WorkerPool::GetDefaultNumThreads(), 1));
+		return pool;
+	}
+
+	void EvictToBudget(int keep_map_id) {
+		while (cache_size > budget) {
+			auto oldest = cache.end();
+			for (auto it = cache.begin(); it != cache.end(); ++it) {
+				if (it->first != keep_map_id && (oldest == cache.end() || it->second.last_use < oldest->second.last_use)) {
+					oldest = it;
+				}
+			}
+			if (oldest == cache.end()) {
+				break;
+			}
+
+			cache_size -= oldest->second.size;
+			cache.erase(oldest);
+			++stats.evictions;
+		}
+	}
+
+	/** Translates the map on the main thread and adds it to the cache */
+	void AddParsed(int map_id, PendingItem& item) {
+		auto map = item.result.get();
+		if (!map) {
+			// The error is reported when the map is loaded
+			return;
+		}
+
+		if (!Tr::GetCurrentTranslationId().empty()) {
+			Game_Map::TranslateMapMessages(map_id, *map);
+		}
+		MapPreload::Add(map_id, std::move(map), item.crc);
+	}
+
+	/** Reads the map file on the main thread and queues the parsing */
+	void Submit(int map_id) {
+		EP_INSTRUMENT_ZONE("MapPreload::Submit");
+
+		// Same lookup order as Game_Map::LoadMapFile
+		bool is_xml = true;
+		std::string map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, true));
+		if (map_file.empty()) {
+			is_xml = false;
+			map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, false));
+		}
+		if (map_file.empty()) {
+			return;
+		}
+
+		// The filesystem is not thread-safe, only the parsing is done by the worker
+		auto is = FileFinder::Game().OpenInputStream(map_file);
+		if (!is) {
+			return;
+		}
+
+		auto data = std::make_shared<std::vector<uint8_t>>(Utils::ReadStream(is));
+		auto task = std::make_shared<std::packaged_task<std::unique_ptr<lcf::rpg::Map>()>>([data, is_xml, encoding = Player::encoding]() {
+			Filesystem_Stream::InputMemoryStreamBufView buf(Span<uint8_t>(data->data(), data->size()));
+			std::istream stream(&buf);
+			if (is_xml) {
+				return lcf::LMU_Reader::LoadXml(stream);
+			}
+			return lcf::LMU_Reader::Load(stream, encoding);
+		});
+
+		auto& item = pending[map_id];
+		item.result = task->get_future();
+		if (!is_xml && Input::IsRecording()) {
+			Filesystem_Stream::InputMemoryStreamBufView buf(Span<uint8_t>(data->data(), data->size()));
+			std::istream stream(&buf);
+			item.crc = Utils::CRC32(stream);
+		}
+		++stats.preloads;
+
+		GetParsePool().Submit([task]() { (*task)(); });
+	}
+}
+
+void MapPreload::Request(int map_id) {
+	if (GetParsePool().GetNumThreads() == 0 || map_id <= 0) {
+		return;
+	}
+
+	if (auto it = cache.find(map_id); it != cache.end()) {
+		it->second.last_use = ++use_counter;
+		return;
+	}
+	if (pending.find(map_id) != pending.end() || std::find(requests.begin(), requests.end(), map_id) != requests.end()) {
+		return;
+	}
+
+	requests.push_back(map_id);
+}
+
+void MapPreload::CancelRequests() {
+	requests.clear();
+}
+
+std::unique_ptr<lcf::rpg::Map> MapPreload::Get(int map_id) {
+	// Not read yet, the caller loads the map directly
+	requests.erase(std::remove(requests.begin(), requests.end(), map_id), requests.end());
+
+	if (auto it = pending.find(map_id); it != pending.end()) {
+		// Still parsing, block until it is done
+		if (!it->second.IsReady()) {
+			++stats.preload_waits;
+		}
+		AddParsed(map_id, it->second);
+		pending.erase(it);
+	}
+
+	auto it = cache.find(map_id);
+	if (it == cache.end()) {
+		++stats.misses;
+		return nullptr;
+	}
+	++stats.hits;
+
+	auto& item = it->second;
+	item.last_use = ++use_counter;
+
+	if (item.crc != 0 && Input::IsRecording()) {
+		Input::AddRecordingData(Input::RecordingData::Hash,
+			fmt::format("map{:04} {:#08x}", map_id, item.crc));
+	}
+
+	Output::Debug("Loaded Map {} (preloaded)", Game_Map::ConstructMapName(map_id, false));
+
+	// The map is modified while playing, the cache keeps the original
+	return std::make_unique<lcf::rpg::Map>(*item.map);
+}
+
+void MapPreload::Add(int map_id, std::unique_ptr<lcf::rpg::Map> map, uint32_t crc) {
+	if (auto it = cache.find(map_id); it != cache.end()) {
+		cache_size -= it->second.size;
+		cache.erase(it);
+	}
+
+	auto& item = cache[map_id];
+	item.size = EstimateSize(*map);
+	item.map = std::move(map);
+	item.crc = crc;
+	item.last_use = ++use_counter;
+	cache_size += item.size;
+
+	EvictToBudget(map_id);
+}
+
+void MapPreload::Update() {
+	for (auto it = pending.begin(); it != pending.end();) {
+		if (it->second.IsReady()) {
+			AddParsed(it->first, it->second);
+			it = pending.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	// One file read per frame keeps the reads out of the transfer frame
+	if (!requests.empty()) {
+		const int map_id = requests.front();
+		requests.pop_front();
+		if (cache.find(map_id) == cache.end() && pending.find(map_id) == pending.end()) {
+			Submit(map_id);
+		}
+	}
+}
+
+void MapPreload::Clear() {
+	// Running tasks keep their own state, the results are dropped
+	requests.clear();
+	pending.clear();
+	cache.clear();
+	cache_size = 0;
+}
+
+void MapPreload::SetBudget(size_t bytes) {
+	budget = bytes;
+	EvictToBudget(0);
+}
+
+MapPreload::Stats MapPreload::GetStats() {
+	Stats result = stats;
+	result.size = cache_size;
+	result.entries = cache.size();
+	result.budget = budget;
+	return result;
+}
+
+size_t MapPreload::EstimateSize(const lcf::rpg::Map& map) {
+	size_t size = sizeof(lcf::rpg::Map);
+	size += map.lower_layer.size() * sizeof(map.lower_layer[0]);
+	size += map.upper_layer.size() * sizeof(map.upper_layer[0]);
+
+	for (const auto& ev: map.events) {
+		size += sizeof(ev);
+		for (const auto& page: ev.pages) {
+			size += sizeof(page);
+			size += page.move_route.move_commands.size() * sizeof(lcf::rpg::MoveCommand);
+			for (const auto& com: page.event_commands) {
+				size += sizeof(com) + com.string.size() + com.parameters.size() * sizeof(int32_t);
+			}
+		}
+	}
+
+	return size;
+}
@@ -0,0 +1,111 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MAP_PRELOAD_H
+#define EP_MAP_PRELOAD_H
+
+// Headers
+#include <cstdint>
+#include <memory>
+#include <lcf/rpg/map.h>
+
+/**
+ * Cache of parsed and translated maps.
+ *
+ * Maps that are likely entered next are parsed by a worker thread, a map
+ * transfer to such a map only copies the prepared map.
+ */
+namespace MapPreload {
+	struct Stats {
+		/** Map loads served from the cache */
+		uint64_t hits = 0;
+		/** Map loads that were not prepared */
+		uint64_t misses = 0;
+		/** Maps removed from the cache because of the memory budget */
+		uint64_t evictions = 0;
+		/** Maps queued for parsing on a worker thread */
+		uint64_t preloads = 0;
+		/** Map loads that waited for a worker to finish parsing */
+		uint64_t preload_waits = 0;
+		/** Estimated memory used by the cached maps in bytes */
+		size_t size = 0;
+		/** Amount of cached maps */
+		size_t entries = 0;
+		/** Memory budget in bytes */
+		size_t budget = 0;
+	};
+
+	/**
+	 * Queues preparing a map. Update reads one queued map file per frame and
+	 * parses it on a worker thread, in the order of the requests.
+	 * Does nothing when the map is already prepared or the platform has no
+	 * thread support. Missing files are reported when the map is loaded.
+	 *
+	 * @param map_id map to prepare
+	 */
+	void Request(int map_id);
+
+	/** Drops the requests whose map file was not read yet */
+	void CancelRequests();
+
+	/**
+	 * Returns a copy of a prepared map, waits when it is still parsed.
+	 *
+	 * @param map_id map to load
+	 * @return the map or nullptr when it was not prepared
+	 */
+	std::unique_ptr<lcf::rpg::Map> Get(int map_id);
+
+	/**
+	 * Adds a prepared map to the cache.
+	 * Maps that were not used recently are removed when the budget is exceeded.
+	 *
+	 * @param map_id id of the map
+	 * @param map the map, already translated
+	 * @param crc CRC32 of the map file for input recordings, 0 when not known
+	 */
+	void Add(int map_id, std::unique_ptr<lcf::rpg::Map> map, uint32_t crc = 0);
+
+	/**
+	 * Translates and stores the maps the workers finished and reads the file
+	 * of the next requested map. Called every frame.
+	 */
+	void Update();
+
+	/** Removes all maps, e.g. when the game or the language changes */
+	void Clear();
+
+	/**
+	 * Sets the memory budget of the cache.
+	 *
+	 * @param bytes budget in bytes (default 16 MiB)
+	 */
+	void SetBudget(size_t bytes);
+
+	/** @return counters of the cache */
+	Stats GetStats();
+
+	/**
+	 * Estimates the memory used by a parsed map.
+	 *
+	 * @param map the map
+	 * @return size in bytes
+	 */
+	size_t EstimateSize(const lcf::rpg::Map& map);
+}
+
+#endif
@@ -93,6 +93,21 @@ void MessageOverlay::AddMessage(const std::string& message, Color color) {
 	dirty = true;
 }
 
+bool MessageOverlay::GetDamage(DamageInfo& info) const {
+	info.rect = {};
+	if (!IsAnyMessageVisible() && !show_all) {
+		return true;
+	}
+
+	// The bitmap is redrawn after it was blitted, this changes the revision
+	// and the new messages are drawn in the next frame
+	info.rect = { ox, oy, bitmap->GetWidth(), bitmap->GetHeight() };
+	info.Hash(bitmap.get());
+	info.Hash(bitmap->GetRevision());
+	info.Hash(dirty);
+	return true;
+}
+
 void MessageOverlay::Update() {
 	if (!DisplayUi) {
 		return;
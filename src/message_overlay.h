@@ -45,6 +45,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(DamageInfo& info) const override;
+
 	void Update();
 
 	void AddMessage(const std::string& message, Color color);
@@ -23,6 +23,8 @@
 #include <iostream>
 #include <fstream>
 #include <thread>
+#include <mutex>
+#include <vector>
 #include <chrono>
 #include <fmt/color.h>
 #include <fmt/ostream.h>
@@ -71,6 +73,17 @@ namespace {
 		LogLevel lvl = {};
 	} last_message;
 
+	struct ThreadMessage {
+		LogLevel lvl;
+		std::string msg;
+		Color color;
+	};
+
+	// Set on threads that must not write the log directly
+	thread_local bool defer_messages = false;
+	std::mutex thread_messages_mutex;
+	std::vector<ThreadMessage> thread_messages;
+
 	void LogCallback(LogLevel lvl, std::string const& msg, LogCallbackUserData /* userdata */) {
 		// terminal output
 		std::string prefix = Output::LogLevelToString(lvl) + ":";
@@ -136,6 +149,14 @@ void Output::SetLogCallback(LogCallbackFn fn, LogCallbackUserData userdata) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+	if (defer_messages) {
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		thread_messages.push_back({ lvl, msg, c });
+		return;
+	}
+
+	Output::FlushThreadMessages();
+
 // skip writing log file
 #ifndef EMSCRIPTEN
 	std::string prefix = Output::LogLevelToString(lvl) + ": ";
@@ -178,6 +199,9 @@ static void HandleErrorOutput(const std::string& err) {
 	Text::Draw(*surface, 10, 10, *Font::DefaultBitmapFont(), Color(255, 255, 255, 255), error);
 	DisplayUi->UpdateDisplay();
 
+	// The next frame must not only redraw the areas that changed
+	Graphics::Invalidate();
+
 	if (ignore_pause) { return; }
 
 	Input::ResetKeys();
@@ -304,6 +328,25 @@ void Output::ErrorStr(std::string const& err) {
 	exit(Player::exit_code);
 }
 
+void Output::DeferThreadMessages() {
+	defer_messages = true;
+}
+
+void Output::FlushThreadMessages() {
+	std::vector<ThreadMessage> messages;
+	{
+		std::lock_guard<std::mutex> lock(thread_messages_mutex);
+		if (thread_messages.empty()) {
+			return;
+		}
+		messages.swap(thread_messages);
+	}
+
+	for (auto& m: messages) {
+		WriteLog(m.lvl, m.msg, m.color);
+	}
+}
+
 void Output::WarningStr(std::string const& warn) {
 	if (log_level < LogLevel::Warning) {
 		return;
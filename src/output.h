@@ -119,6 +119,19 @@ namespace Output {
 	/** @return the Loglevel as string */
 	std::string LogLevelToString(LogLevel lvl);
 
+	/**
+	 * Queues the messages of the calling thread instead of writing them.
+	 * Called by worker threads because the log file and the overlay are
+	 * owned by the main thread.
+	 */
+	void DeferThreadMessages();
+
+	/**
+	 * Writes the messages queued by worker threads.
+	 * Must be called from the main thread.
+	 */
+	void FlushThreadMessages();
+
 	/**
 	 * Displays an info string with formatted string.
 	 *
@@ -0,0 +1,78 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "pathfinder.h"
+
+void Pathfinder::Reset(const Grid& g) {
+	grid = g;
+	grid.width = std::max(grid.width, 0);
+	grid.height = std::max(grid.height, 0);
+
+	const size_t num_tiles = static_cast<size_t>(grid.width) * static_cast<size_t>(grid.height);
+	if (generation.size() < num_tiles) {
+		generation.resize(num_tiles, 0);
+		cost.resize(num_tiles);
+		parent.resize(num_tiles);
+		direction.resize(num_tiles);
+		closed.resize(num_tiles);
+		remaining_generation.resize(num_tiles, 0);
+		remaining.resize(num_tiles);
+	}
+
+	++current_generation;
+	if (current_generation == 0) {
+		// Counter wrapped around: Stale stamps could match again
+		std::fill(generation.begin(), generation.end(), 0);
+		std::fill(remaining_generation.begin(), remaining_generation.end(), 0);
+		current_generation = 1;
+	}
+
+	for (auto& bucket : open) {
+		bucket.clear();
+	}
+	queue.clear();
+	start_index = -1;
+	target_index = -1;
+	closest_distance = std::numeric_limits<int>::max();
+	expanded = 0;
+	reached = false;
+}
+
+void Pathfinder::Start() {
+	start_index = query.start_y * grid.width + query.start_x;
+	generation[start_index] = current_generation;
+	cost[start_index] = 0;
+	parent[start_index] = -1;
+	direction[start_index] = -1;
+}
+
+void Pathfinder::BuildRoute(int max_nodes, std::vector<Step>& route) const {
+	route.clear();
+
+	int index = target_index;
+	while (index >= 0 && static_cast<int>(route.size()) < max_nodes) {
+		Step step;
+		step.x = index % grid.width;
+		step.y = index / grid.width;
+		step.direction = direction[index];
+		route.push_back(step);
+		index = parent[index];
+	}
+
+	std::reverse(route.begin(), route.end());
+}
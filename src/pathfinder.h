@@ -0,0 +1,457 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PATHFINDER_H
+#define EP_PATHFINDER_H
+
+// Headers
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <vector>
+
+/**
+ * Shortest path search over a tile grid.
+ *
+ * The result is identical to a breadth-first search that visits the
+ * neighbours in the order right, up, left, down and for diagonal searches
+ * down-left, up-right, up-left, down-right.
+ *
+ * When the search_max limit can stop the search early the tiles are visited
+ * in breadth-first order, because the limit counts visited tiles of that
+ * order. Otherwise an A* search finds the route length and a backward search
+ * over the tiles that can be on a shortest route selects the route the
+ * breadth-first search would take. When the destination is unreachable the
+ * breadth-first search is run to pick the same fallback target.
+ *
+ * The per-tile state (cost, parent and direction) is stored in flat arrays
+ * indexed by tile. These arrays and the open list are kept between searches
+ * and only grow when a bigger map is searched, so repeated searches do not
+ * allocate. Tiles are invalidated by bumping a generation counter instead of
+ * clearing the arrays.
+ */
+class Pathfinder {
+public:
+	/** Dimensions of the searched map */
+	struct Grid {
+		int width = 0;
+		int height = 0;
+		bool loop_horizontal = false;
+		bool loop_vertical = false;
+	};
+
+	/** Parameters of a single search */
+	struct Query {
+		int start_x = 0;
+		int start_y = 0;
+		int dest_x = 0;
+		int dest_y = 0;
+		/** Maximum amount of nodes to visit in breadth-first order */
+		int search_max = std::numeric_limits<int>::max();
+		bool allow_diagonal = false;
+	};
+
+	/** One node of a computed route */
+	struct Step {
+		int x = 0;
+		int y = 0;
+		/** Direction used to enter this tile (see Game_Character::Direction), -1 for the start */
+		int direction = -1;
+	};
+
+	/**
+	 * Runs a search.
+	 *
+	 * The callbacks are invoked as fn(from_x, from_y, to_x, to_y). The target
+	 * coordinates are not wrapped on looping maps, the callee must round them.
+	 *
+	 * @param grid map dimensions
+	 * @param query search parameters
+	 * @param can_move returns whether a step between two tiles is possible
+	 * @param can_enter_dest fallback for steps onto the destination tile,
+	 *   allows reaching a destination that is occupied by an event.
+	 * @return true when at least one node was expanded. The route to the
+	 *   destination, or to the expanded node closest to it, can then be
+	 *   retrieved with BuildRoute.
+	 */
+	template <typename F, typename G>
+	bool Search(const Grid& grid, const Query& query, F&& can_move, G&& can_enter_dest);
+
+	/**
+	 * Builds the route found by the last Search.
+	 *
+	 * @param max_nodes maximum amount of nodes in the route, including the start node.
+	 *   When the route is longer only the nodes closest to the target are kept.
+	 * @param route output, cleared first. Ordered from start to target.
+	 */
+	void BuildRoute(int max_nodes, std::vector<Step>& route) const;
+
+	/** @return whether the last search reached the destination */
+	bool ReachedDestination() const;
+
+	/** @return amount of nodes visited by the last search */
+	int GetExpandedNodes() const;
+
+private:
+	struct OpenNode {
+		int g;
+		int index;
+	};
+
+	struct Offset {
+		int dx;
+		int dy;
+		int dir;
+	};
+
+	/** Same order and direction ids as used by the move route commands */
+	static constexpr Offset offsets[] = {
+		{ 1, 0, 1 }, { 0, -1, 0 }, { -1, 0, 3 }, { 0, 1, 2 },
+		{ -1, 1, 6 }, { 1, -1, 4 }, { -1, -1, 7 }, { 1, 1, 5 }
+	};
+
+	void Reset(const Grid& grid);
+	void Start();
+	int Heuristic(int x, int y, int target_x, int target_y) const;
+	bool IsFresh(int index) const;
+	void Visit(int index);
+	void Enter(int index, int from, int i);
+
+	/** @return tile reached by offsets[i] from index, or -1 when outside the map or the start tile */
+	int GetNeighbour(int index, int i) const;
+
+	/** @return whether the step offsets[i] from index onto next is passable */
+	template <typename F, typename G>
+	bool CanStep(int index, int i, int next, F&& can_move, G&& can_enter_dest) const;
+
+	template <typename F, typename G>
+	void SearchBreadthFirst(F&& can_move, G&& can_enter_dest);
+
+	template <typename F, typename G>
+	void SearchAStar(F&& can_move, G&& can_enter_dest);
+
+	/**
+	 * Replaces the route to the reached destination with the route the
+	 * breadth-first search finds: The lexicographically first sequence of
+	 * neighbour offsets among all shortest routes.
+	 */
+	template <typename F, typename G>
+	void SelectBreadthFirstRoute(F&& can_move, G&& can_enter_dest);
+
+	Grid grid;
+	Query query;
+
+	std::vector<uint32_t> generation;
+	std::vector<int> cost;
+	std::vector<int> parent;
+	std::vector<int8_t> direction;
+	std::vector<bool> closed;
+	std::vector<uint32_t> remaining_generation;
+	std::vector<int> remaining;
+	/** Open list of the A* search, one bucket per estimated route length */
+	std::vector<std::vector<OpenNode>> open;
+	std::vector<int> queue;
+	uint32_t current_generation = 0;
+
+	int start_index = -1;
+	int target_index = -1;
+	int closest_distance = 0;
+	int expanded = 0;
+	bool reached = false;
+};
+
+inline bool Pathfinder::ReachedDestination() const {
+	return reached;
+}
+
+inline int Pathfinder::GetExpandedNodes() const {
+	return expanded;
+}
+
+inline bool Pathfinder::IsFresh(int index) const {
+	return generation[index] != current_generation;
+}
+
+inline int Pathfinder::Heuristic(int x, int y, int target_x, int target_y) const {
+	int dx = std::abs(target_x - x);
+	int dy = std::abs(target_y - y);
+	if (grid.loop_horizontal && dx < grid.width) {
+		dx = std::min(dx, grid.width - dx);
+	}
+	if (grid.loop_vertical && dy < grid.height) {
+		dy = std::min(dy, grid.height - dy);
+	}
+	return query.allow_diagonal ? std::max(dx, dy) : dx + dy;
+}
+
+inline int Pathfinder::GetNeighbour(int index, int i) const {
+	const int w = grid.width;
+	const int h = grid.height;
+	int nx = index % w + offsets[i].dx;
+	int ny = index / w + offsets[i].dy;
+	if (grid.loop_horizontal) {
+		nx = (nx + w) % w;
+	}
+	if (grid.loop_vertical) {
+		ny = (ny + h) % h;
+	}
+	if (nx < 0 || nx >= w || ny < 0 || ny >= h) {
+		return -1;
+	}
+
+	const int next = ny * w + nx;
+	return next == start_index ? -1 : next;
+}
+
+template <typename F, typename G>
+bool Pathfinder::CanStep(int index, int i, int next, F&& can_move, G&& can_enter_dest) const {
+	const auto& off = offsets[i];
+	const int x = index % grid.width;
+	const int y = index / grid.width;
+	const int raw_x = x + off.dx;
+	const int raw_y = y + off.dy;
+
+	if (!can_move(x, y, raw_x, raw_y)
+			&& !(next % grid.width == query.dest_x && next / grid.width == query.dest_y
+				&& can_enter_dest(x, y, raw_x, raw_y))) {
+		return false;
+	}
+
+	if (off.dx != 0 && off.dy != 0) {
+		// Diagonal steps are only allowed when one of the corners is free
+		if (!can_move(x, y, raw_x, y) && !can_move(x, y, x, raw_y)) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+inline void Pathfinder::Enter(int index, int from, int i) {
+	generation[index] = current_generation;
+	cost[index] = cost[from] + 1;
+	parent[index] = from;
+	direction[index] = static_cast<int8_t>(offsets[i].dir);
+}
+
+inline void Pathfinder::Visit(int index) {
+	++expanded;
+
+	const int x = index % grid.width;
+	const int y = index / grid.width;
+	if (x == query.dest_x && y == query.dest_y) {
+		target_index = index;
+		reached = true;
+		return;
+	}
+
+	// Remember the first visited node closest to the destination as fallback target
+	const int manhattan_dist = std::abs(query.dest_x - x) + std::abs(query.dest_y - y);
+	if (manhattan_dist < closest_distance) {
+		closest_distance = manhattan_dist;
+		target_index = index;
+	}
+}
+
+template <typename F, typename G>
+void Pathfinder::SearchBreadthFirst(F&& can_move, G&& can_enter_dest) {
+	const int num_offsets = query.allow_diagonal ? 8 : 4;
+
+	queue.push_back(start_index);
+	for (size_t head = 0; head < queue.size() && expanded < query.search_max; ++head) {
+		const int node = queue[head];
+		Visit(node);
+		if (reached) {
+			break;
+		}
+
+		for (int i = 0; i < num_offsets; ++i) {
+			// The first discovery of a tile is final
+			const int next = GetNeighbour(node, i);
+			if (next < 0 || !IsFresh(next) || !CanStep(node, i, next, can_move, can_enter_dest)) {
+				continue;
+			}
+
+			Enter(next, node, i);
+			queue.push_back(next);
+		}
+	}
+}
+
+template <typename F, typename G>
+void Pathfinder::SearchAStar(F&& can_move, G&& can_enter_dest) {
+	const int num_offsets = query.allow_diagonal ? 8 : 4;
+	const int w = grid.width;
+
+	// The heuristic is consistent, so the estimate of the expanded nodes never
+	// decreases and the buckets are processed in order. Each bucket is LIFO,
+	// which prefers the deeper nodes and reaches the destination without
+	// expanding all tiles of equal estimate.
+	const int min_f = Heuristic(query.start_x, query.start_y, query.dest_x, query.dest_y);
+	closed[start_index] = false;
+	open.resize(std::max<size_t>(open.size(), 1));
+	open[0].push_back({ 0, start_index });
+
+	for (size_t bucket = 0; bucket < open.size() && !reached; ++bucket) {
+		while (!open[bucket].empty()) {
+			const OpenNode node = open[bucket].back();
+			open[bucket].pop_back();
+
+			if (closed[node.index] || cost[node.index] != node.g) {
+				// Stale entry, the node was already expanded or queued with a lower cost
+				continue;
+			}
+			closed[node.index] = true;
+
+			Visit(node.index);
+			if (reached) {
+				break;
+			}
+
+			for (int i = 0; i < num_offsets; ++i) {
+				const int next = GetNeighbour(node.index, i);
+				if (next < 0) {
+					continue;
+				}
+				if (!IsFresh(next) && (closed[next] || cost[next] <= node.g + 1)) {
+					continue;
+				}
+				if (!CanStep(node.index, i, next, can_move, can_enter_dest)) {
+					continue;
+				}
+
+				Enter(next, node.index, i);
+				closed[next] = false;
+				const size_t next_bucket = static_cast<size_t>(node.g + 1 + Heuristic(next % w, next / w, query.dest_x, query.dest_y) - min_f);
+				if (next_bucket >= open.size()) {
+					open.resize(next_bucket + 1);
+				}
+				open[next_bucket].push_back({ node.g + 1, next });
+			}
+		}
+	}
+}
+
+template <typename F, typename G>
+void Pathfinder::SelectBreadthFirstRoute(F&& can_move, G&& can_enter_dest) {
+	const int num_offsets = query.allow_diagonal ? 8 : 4;
+	const int w = grid.width;
+	const int h = grid.height;
+	const int dest_index = target_index;
+	const int length = cost[dest_index];
+
+	// Backward breadth-first search from the destination for the remaining
+	// distance of every tile that can be on a shortest route
+	queue.clear();
+	remaining_generation[dest_index] = current_generation;
+	remaining[dest_index] = 0;
+	queue.push_back(dest_index);
+	for (size_t head = 0; head < queue.size(); ++head) {
+		const int node = queue[head];
+		if (node == start_index) {
+			continue;
+		}
+		const int node_remaining = remaining[node] + 1;
+
+		for (int i = 0; i < num_offsets; ++i) {
+			const auto& off = offsets[i];
+			int px = node % w - off.dx;
+			int py = node / w - off.dy;
+			if (grid.loop_horizontal) {
+				px = (px + w) % w;
+			}
+			if (grid.loop_vertical) {
+				py = (py + h) % h;
+			}
+			if (px < 0 || px >= w || py < 0 || py >= h) {
+				continue;
+			}
+
+			const int prev = py * w + px;
+			if (remaining_generation[prev] == current_generation
+					|| node_remaining + Heuristic(px, py, query.start_x, query.start_y) > length) {
+				continue;
+			}
+			if (GetNeighbour(prev, i) != node || !CanStep(prev, i, node, can_move, can_enter_dest)) {
+				continue;
+			}
+
+			remaining_generation[prev] = current_generation;
+			remaining[prev] = node_remaining;
+			queue.push_back(prev);
+		}
+	}
+	expanded += static_cast<int>(queue.size());
+
+	// Walk from the start and always take the first neighbour that stays on a shortest route
+	int node = start_index;
+	for (int step = length - 1; step >= 0; --step) {
+		for (int i = 0; i < num_offsets; ++i) {
+			const int next = GetNeighbour(node, i);
+			if (next < 0 || remaining_generation[next] != current_generation || remaining[next] != step) {
+				continue;
+			}
+			if (!CanStep(node, i, next, can_move, can_enter_dest)) {
+				continue;
+			}
+
+			Enter(next, node, i);
+			node = next;
+			break;
+		}
+	}
+	assert(node == dest_index);
+}
+
+template <typename F, typename G>
+bool Pathfinder::Search(const Grid& g, const Query& q, F&& can_move, G&& can_enter_dest) {
+	Reset(g);
+	query = q;
+
+	const int w = grid.width;
+	const int h = grid.height;
+	if (q.start_x < 0 || q.start_x >= w || q.start_y < 0 || q.start_y >= h) {
+		return false;
+	}
+
+	// Every tile is visited at most once
+	if (static_cast<int64_t>(q.search_max) < static_cast<int64_t>(w) * h) {
+		// The limit counts visited tiles in breadth-first order
+		Start();
+		SearchBreadthFirst(can_move, can_enter_dest);
+	} else {
+		Start();
+		SearchAStar(can_move, can_enter_dest);
+		if (reached) {
+			SelectBreadthFirstRoute(can_move, can_enter_dest);
+		} else {
+			// All reachable tiles were visited. The fallback target is the
+			// first of them in breadth-first order closest to the destination.
+			const int astar_expanded = expanded;
+			Reset(g);
+			Start();
+			SearchBreadthFirst(can_move, can_enter_dest);
+			expanded += astar_expanded;
+		}
+	}
+
+	return target_index >= 0;
+}
+
+#endif
@@ -20,8 +20,14 @@
 #include "filefinder.h"
 #include "utils.h"
 #include <cassert>
+#include <cerrno>
+#include <cstdio>
 #include <utility>
 
+#if !defined(_WIN32) && !defined(__vita__) && !defined(EP_OPENDIR_OPAQUE)
+#  include <fcntl.h>
+#endif
+
 #ifndef DT_UNKNOWN
 #define DT_UNKNOWN 0
 #endif
@@ -123,6 +129,79 @@ int64_t Platform::File::GetSize() const {
 #endif
 }
 
+int64_t Platform::File::GetModificationTime() const {
+#if defined(_WIN32)
+	WIN32_FILE_ATTRIBUTE_DATA data;
+	BOOL res = ::GetFileAttributesExW(filename.c_str(),
+			GetFileExInfoStandard,
+			&data);
+	if (!res) {
+		return -1;
+	}
+
+	return ((int64_t)data.ftLastWriteTime.dwHighDateTime << 32) | (int64_t)data.ftLastWriteTime.dwLowDateTime;
+#elif defined(__vita__)
+	return -1;
+#else
+	struct stat sb = {};
+	int result = ::stat(filename.c_str(), &sb);
+	return (result == 0) ? (int64_t)sb.st_mtime : (int64_t)-1;
+#endif
+}
+
+bool Platform::File::Rename(const std::string& new_name) const {
+#if defined(_WIN32)
+	std::wstring new_wname = Utils::ToWideString(new_name);
+	return ::MoveFileExW(filename.c_str(), new_wname.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+#elif defined(__vita__)
+	// Does not replace existing files
+	::sceIoRemove(new_name.c_str());
+	return ::sceIoRename(filename.c_str(), new_name.c_str()) >= 0;
+#else
+	if (::rename(filename.c_str(), new_name.c_str()) == 0) {
+		return true;
+	}
+	if (errno != EEXIST) {
+		return false;
+	}
+	// Some C libraries of consoles do not replace existing files
+	::remove(new_name.c_str());
+	return ::rename(filename.c_str(), new_name.c_str()) == 0;
+#endif
+}
+
+bool Platform::File::Sync() const {
+#if defined(_WIN32)
+	HANDLE handle = ::CreateFileW(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (handle == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	bool res = ::FlushFileBuffers(handle) != 0;
+	::CloseHandle(handle);
+	return res;
+#elif defined(__vita__) || defined(EP_OPENDIR_OPAQUE)
+	return Exists();
+#else
+	int fd = ::open(filename.c_str(), O_WRONLY);
+	if (fd < 0) {
+		return false;
+	}
+	bool res = ::fsync(fd) == 0;
+	::close(fd);
+	return res;
+#endif
+}
+
+bool Platform::File::Remove() const {
+#if defined(_WIN32)
+	return ::DeleteFileW(filename.c_str()) != 0;
+#elif defined(__vita__)
+	return ::sceIoRemove(filename.c_str()) >= 0;
+#else
+	return ::remove(filename.c_str()) == 0;
+#endif
+}
+
 bool Platform::File::MakeDirectory(bool follow_symlinks) const {
 	if (IsDirectory(follow_symlinks)) {
 		return true;
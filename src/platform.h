@@ -91,6 +91,36 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/**
+		 * @return Time of the last modification in a platform specific unit
+		 *   or -1 on error or when not supported
+		 */
+		int64_t GetModificationTime() const;
+
+		/**
+		 * Renames the file. An existing file at the destination is replaced.
+		 * On most platforms this is atomic.
+		 *
+		 * @param new_name Destination path
+		 * @return true when the file was renamed.
+		 */
+		bool Rename(const std::string& new_name) const;
+
+		/**
+		 * Writes the cached contents of the file to the storage device.
+		 * Does nothing on platforms without such an API.
+		 *
+		 * @return true when the file was flushed
+		 */
+		bool Sync() const;
+
+		/**
+		 * Deletes the file.
+		 *
+		 * @return true when the file was deleted
+		 */
+		bool Remove() const;
+
 		/**
 		 * Creates a directory recursively at the filename path.
 		 * @param follow_symlinks Whether to follow symlinks (if supported on this platform)
@@ -32,6 +32,7 @@
 #include "async_handler.h"
 #include "audio.h"
 #include "cache.h"
+#include "database_snapshot.h"
 #include "rand.h"
 #include "cmdline_parser.h"
 #include "game_dynrpg.h"
@@ -64,6 +65,7 @@
 #include "main_data.h"
 #include "output.h"
 #include "player.h"
+#include "save_writer.h"
 #include <lcf/reader_lcf.h>
 #include <lcf/reader_util.h>
 #include "scene_battle.h"
@@ -83,6 +85,7 @@
 #include "message_overlay.h"
 #include "audio_midi.h"
 #include "maniac_patch.h"
+#include "frame_stats.h"
 
 #if defined(__ANDROID__) && !defined(USE_LIBRETRO)
 #include "platform/android/android.h"
@@ -129,6 +132,9 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	bool headless_flag = false;
+	int headless_frames = 0;
+	std::string frame_hash_log_path;
 	std::string command_line;
 	int rng_seed = -1;
 	Game_ConfigPlayer player_config;
@@ -148,6 +154,9 @@ namespace {
 	FileRequestBinding system_request_id;
 	FileRequestBinding save_request_id;
 	FileRequestBinding map_request_id;
+
+	// Timing of all frames in headless mode
+	std::unique_ptr<FrameStats> frame_stats;
 }
 
 void Player::Init(std::vector<std::string> args) {
@@ -190,6 +199,12 @@ void Player::Init(std::vector<std::string> args) {
 
 	Main_Data::Init();
 
+	if (headless_flag) {
+		// One game step per frame, independent of the real time, so replays are deterministic
+		Game_Clock::SetFixedTimeStep(true);
+		frame_stats = std::make_unique<FrameStats>();
+	}
+
 	DisplayUi.reset();
 
 	if(! DisplayUi) {
@@ -201,6 +216,8 @@ void Player::Init(std::vector<std::string> args) {
 
 	player_config = std::move(cfg.player);
 
+	Cache::SetMemoryBudget(static_cast<size_t>(player_config.image_cache_size.Get()) * 1024 * 1024);
+
 	last_auto_screenshot = Game_Clock::now();
 }
 
@@ -231,6 +248,9 @@ void Player::MainLoop() {
 	const auto frame_time = Game_Clock::now();
 	Game_Clock::OnNextFrame(frame_time);
 
+	Output::FlushThreadMessages();
+	SaveWriter::Update();
+
 	Player::UpdateInput();
 
 	if (!DisplayUi->ProcessEvents()) {
@@ -263,8 +283,17 @@ void Player::MainLoop() {
 		Input::UpdateSystem();
 	}
 
+	const auto draw_time = Game_Clock::now();
+
 	Player::Draw();
 
+	if (frame_stats) {
+		using std::chrono::duration_cast;
+		frame_stats->Add(
+			duration_cast<FrameStats::duration>(draw_time - frame_time),
+			duration_cast<FrameStats::duration>(Game_Clock::now() - draw_time));
+	}
+
 	Scene::old_instances.clear();
 
 	if (!Transition::instance().IsActive() && Scene::instance->type == Scene::Null) {
@@ -405,6 +434,9 @@ int Player::GetFrames() {
 }
 
 void Player::Exit() {
+	// Do not quit before the last save was written
+	SaveWriter::Wait();
+
 	if (player_config.settings_autosave.Get()) {
 		Scene_Settings::SaveConfig(true);
 	}
@@ -420,9 +452,19 @@ void Player::Exit() {
 	auto ret = FileFinder::Root().OpenOutputStream("/tmp/message.png", std::ios_base::binary | std::ios_base::out | std::ios_base::trunc);
 	if (ret) Output::TakeScreenshot(ret);
 #endif
+	// Before the game objects release their images
+	const auto cache_stats = Cache::GetStats();
 	Player::ResetGameObjects();
 	Font::Dispose();
 	Graphics::Quit();
+	if (frame_stats) {
+		Output::Info("Frame timing:\n{}", frame_stats->GetReport());
+		Output::Info("Image cache: {} hits, {} misses, {} evictions, {} prefetches ({} waited), {:.1f} of {:.1f} MiB in {} images",
+			cache_stats.hits, cache_stats.misses, cache_stats.evictions, cache_stats.prefetches, cache_stats.prefetch_waits,
+			cache_stats.size / 1024.0 / 1024.0, cache_stats.budget / 1024.0 / 1024.0, cache_stats.entries);
+		frame_stats.reset();
+	}
+	Instrumentation::Quit();
 	Output::Quit();
 	FileFinder::Quit();
 	DisplayUi.reset();
@@ -633,6 +675,22 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, "--headless")) {
+			headless_flag = true;
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--headless-frames")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				headless_frames = li_value;
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--frame-hash-log")) {
+			if (arg.NumValues() > 0) {
+				frame_hash_log_path = arg.Value(0);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--encoding")) {
 			if (arg.NumValues() > 0) {
 				forced_encoding = arg.Value(0);
@@ -924,6 +982,9 @@ void Player::ResetGameObjects() {
 
 	Main_Data::Cleanup();
 
+	// The counters describe the current game session
+	Cache::ResetStats();
+
 	Main_Data::game_switches = std::make_unique<Game_Switches>();
 	Main_Data::game_switches->SetLowerLimit(lcf::Data::switches.size());
 
@@ -947,6 +1008,8 @@ void Player::ResetGameObjects() {
 	Main_Data::game_variables->SetLowerLimit(lcf::Data::variables.size());
 
 	Main_Data::game_strings = std::make_unique<Game_Strings>();
+	// Patterns of the previous game are not used again
+	Game_Strings::ClearRegExCache();
 
 	// Prevent a crash when Game_Map wants to reset the screen content
 	// because Setup() modified pictures array
@@ -1064,37 +1127,54 @@ void Player::LoadDatabase() {
 			return;
 		}
 
-		auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
-		if (!db) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-			return;
-		} else {
-			lcf::Data::data = std::move(*db);
-		}
-
 		auto lmt_stream = FileFinder::Game().OpenInputStream(lmt);
 		if (!lmt_stream) {
 			Output::Error("Error loading {}", lmt_name);
 			return;
 		}
 
-		auto treemap = lcf::LMT_Reader::Load(lmt_stream, encoding);
-		if (!treemap) {
-			Output::ErrorStr(lcf::LcfReader::GetError());
-			return;
-		} else {
-			lcf::Data::treemap = std::move(*treemap);
+		// Hashing the files is only worth it when the result is used
+		const bool use_snapshot = DatabaseSnapshot::IsEnabled();
+		DatabaseSnapshot::Key snapshot_key;
+		if (use_snapshot || Input::IsRecording()) {
+			snapshot_key.game = FileFinder::Game().GetFullPath();
+			snapshot_key.ldb_crc = Utils::CRC32(ldb_stream);
+			snapshot_key.lmt_crc = Utils::CRC32(lmt_stream);
+			snapshot_key.encoding = encoding;
 		}
 
 		if (Input::IsRecording()) {
+			Input::AddRecordingData(Input::RecordingData::Hash,
+									fmt::format("ldb {:#08x}", snapshot_key.ldb_crc));
+			Input::AddRecordingData(Input::RecordingData::Hash,
+						   fmt::format("lmt {:#08x}", snapshot_key.lmt_crc));
+		}
+
+		if (!use_snapshot || !DatabaseSnapshot::Load(snapshot_key)) {
 			ldb_stream.clear();
 			ldb_stream.seekg(0, std::ios::beg);
 			lmt_stream.clear();
 			lmt_stream.seekg(0, std::ios::beg);
-			Input::AddRecordingData(Input::RecordingData::Hash,
-									fmt::format("ldb {:#08x}", Utils::CRC32(ldb_stream)));
-			Input::AddRecordingData(Input::RecordingData::Hash,
-						   fmt::format("lmt {:#08x}", Utils::CRC32(lmt_stream)));
+
+			auto db = lcf::LDB_Reader::Load(ldb_stream, encoding);
+			if (!db) {
+				Output::ErrorStr(lcf::LcfReader::GetError());
+				return;
+			} else {
+				lcf::Data::data = std::move(*db);
+			}
+
+			auto treemap = lcf::LMT_Reader::Load(lmt_stream, encoding);
+			if (!treemap) {
+				Output::ErrorStr(lcf::LcfReader::GetError());
+				return;
+			} else {
+				lcf::Data::treemap = std::move(*treemap);
+			}
+
+			if (use_snapshot) {
+				DatabaseSnapshot::Save(snapshot_key);
+			}
 		}
 
 		// Override map extension, if needed.
@@ -1130,7 +1210,7 @@ void Player::LoadFonts() {
 }
 
 static void OnMapSaveFileReady(FileRequestResult*, lcf::rpg::Save save) {
-	auto map = Game_Map::LoadMapFile(Main_Data::game_player->GetMapId());
+	auto map = Game_Map::LoadMap(Main_Data::game_player->GetMapId());
 	Game_Map::SetupFromSave(
 			std::move(map),
 			std::move(save.map_info),
@@ -1160,6 +1240,8 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 		static_cast<Scene_Title*>(title_scene.get())->OnGameStart();
 	}
 
+	SaveWriter::Wait();
+
 	auto save_stream = FileFinder::Save().OpenInputStream(save_name);
 	if (!save_stream) {
 		Output::Error("Error loading {}", save_name);
@@ -1458,6 +1540,9 @@ Engine options:
  --font2-size PX      Size of font 2 in pixel. The default is 12.
  --font-path PATH     The path in which the settings scene looks for fonts.
                       The default is config-path/Font.
+ --image-cache-size MB
+                      Memory for keeping unused images loaded in MiB.
+                      The default is 10.
  --language LANG      Load the game translation in language/LANG folder.
  --language-path PATH Use the translations at PATH instead of the translations
                       in the language folder.
@@ -1552,6 +1637,14 @@ Debug options:
                       Providing a single N sets the monster party.
                       Providing four N sets: monster party, formation,
                       condition and terrain ID.
+ --frame-hash-log FILE
+                      In headless mode write a hash of the screen of every
+                      frame to FILE. Used to detect rendering changes.
+ --headless           Run without window and audio and as fast as possible.
+                      Every frame runs exactly one game step, combined with
+                      --replay-input and --seed the run is reproducible.
+                      Prints frame timing statistics on exit.
+ --headless-frames N  In headless mode exit after N frames.
  --hide-title         Hide the title background image and center the command
                       menu.
  --start-map-id N     Overwrite the map used for new games and use MapN.lmu
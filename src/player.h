@@ -400,6 +400,15 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Run without window and audio and without frame limit (see HeadlessUi) */
+	extern bool headless_flag;
+
+	/** In headless mode exit after this amount of frames, 0 to run until the game ends */
+	extern int headless_frames;
+
+	/** Path to log the screen hash of every frame to in headless mode */
+	extern std::string frame_hash_log_path;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
@@ -0,0 +1,150 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "project_type_cache.h"
+#include "game_config.h"
+#include "output.h"
+#include "platform.h"
+#include "utils.h"
+#include <charconv>
+#include <fmt/format.h>
+
+namespace {
+	/** Increment when the layout changes */
+	constexpr std::string_view header = "EasyRPG ProjectTypeCache 1";
+
+	constexpr std::string_view filename = "project_types.txt";
+
+	template <typename T>
+	bool ParseNumber(std::string_view& line, T& value) {
+		auto end = line.data() + line.size();
+		auto res = std::from_chars(line.data(), end, value);
+		if (res.ec != std::errc() || res.ptr == end || *res.ptr != '\t') {
+			return false;
+		}
+		line.remove_prefix(res.ptr - line.data() + 1);
+		return true;
+	}
+}
+
+ProjectTypeCache::Key ProjectTypeCache::MakeKey(std::string path) {
+	Key key;
+	Platform::File file(path);
+	key.size = file.GetSize();
+	key.mtime = file.GetModificationTime();
+	key.path = std::move(path);
+	return key;
+}
+
+bool ProjectTypeCache::Find(const Key& key, FileFinder::ProjectType& type) const {
+	if (!key.IsValid()) {
+		return false;
+	}
+
+	auto it = entries.find(key.path);
+	if (it == entries.end() || it->second.size != key.size || it->second.mtime != key.mtime) {
+		return false;
+	}
+
+	type = it->second.type;
+	return true;
+}
+
+void ProjectTypeCache::Set(const Key& key, FileFinder::ProjectType type) {
+	if (!key.IsValid()) {
+		return;
+	}
+
+	auto it = entries.find(key.path);
+	if (it != entries.end() && it->second.size == key.size && it->second.mtime == key.mtime && it->second.type == type) {
+		return;
+	}
+
+	entries[key.path] = { key.size, key.mtime, type };
+	modified = true;
+}
+
+std::string ProjectTypeCache::Serialize() const {
+	std::string data = ToString(header) + "\n";
+	for (auto& [path, entry]: entries) {
+		data += fmt::format("{}\t{}\t{}\t{}\n", static_cast<int>(entry.type), entry.size, entry.mtime, path);
+	}
+	return data;
+}
+
+bool ProjectTypeCache::Parse(std::string_view data) {
+	entries.clear();
+	modified = false;
+
+	auto nl = data.find('\n');
+	if (data.substr(0, nl) != header) {
+		return false;
+	}
+
+	while (nl != std::string_view::npos) {
+		data.remove_prefix(nl + 1);
+		nl = data.find('\n');
+		auto line = data.substr(0, nl);
+
+		int type;
+		Entry entry;
+		if (!ParseNumber(line, type) || !ParseNumber(line, entry.size) || !ParseNumber(line, entry.mtime) || line.empty()) {
+			continue;
+		}
+		if (type < 0 || type >= static_cast<int>(FileFinder::ProjectType::LAST)) {
+			continue;
+		}
+		entry.type = static_cast<FileFinder::ProjectType>(type);
+		entries[ToString(line)] = entry;
+	}
+
+	return true;
+}
+
+void ProjectTypeCache::Load() {
+	auto fs = Game_Config::GetCacheFilesystem();
+	if (!fs) {
+		return;
+	}
+
+	auto is = fs.OpenInputStream(filename);
+	if (!is) {
+		return;
+	}
+
+	auto data = Utils::ReadStream(is);
+	if (!Parse(std::string_view(reinterpret_cast<const char*>(data.data()), data.size()))) {
+		Output::Debug("Project type cache {} is outdated", filename);
+	}
+}
+
+void ProjectTypeCache::Save() {
+	auto fs = Game_Config::GetCacheFilesystem();
+	if (!fs) {
+		return;
+	}
+
+	auto data = Serialize();
+	auto os = fs.OpenOutputStream(filename);
+	if (!os || !os.write(data.data(), data.size())) {
+		Output::Debug("Could not write project type cache {}", filename);
+		return;
+	}
+
+	modified = false;
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PROJECT_TYPE_CACHE_H
+#define EP_PROJECT_TYPE_CACHE_H
+
+// Headers
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include "filefinder.h"
+
+/**
+ * Persistent cache of the project types detected by the game browser.
+ *
+ * Detecting the type opens every directory and archive. An entry is reused
+ * as long as the size and the modification time of the path are unchanged.
+ */
+class ProjectTypeCache {
+public:
+	/** Identifies the state of a file or directory on the host filesystem */
+	struct Key {
+		std::string path;
+		int64_t size = -1;
+		int64_t mtime = -1;
+
+		/** @return whether the key can be cached, false when the stat failed */
+		bool IsValid() const;
+	};
+
+	/**
+	 * Stats a path of the host filesystem.
+	 *
+	 * @param path native path
+	 * @return key of the path
+	 */
+	static Key MakeKey(std::string path);
+
+	/**
+	 * Looks up the type of a path.
+	 *
+	 * @param key path, size and modification time
+	 * @param type set to the cached type
+	 * @return whether an up-to-date entry was found
+	 */
+	bool Find(const Key& key, FileFinder::ProjectType& type) const;
+
+	/**
+	 * Stores the type of a path, replacing outdated entries.
+	 *
+	 * @param key path, size and modification time
+	 * @param type detected project type
+	 */
+	void Set(const Key& key, FileFinder::ProjectType type);
+
+	/** @return whether entries changed since the last Load or Save */
+	bool IsModified() const;
+
+	/** Reads the cache file from the cache directory */
+	void Load();
+
+	/**
+	 * Writes the cache file to the cache directory.
+	 * Failures are only logged, the cache is an optimization.
+	 */
+	void Save();
+
+	/** @return the entries in the cache file format */
+	std::string Serialize() const;
+
+	/**
+	 * Replaces the entries with the content of a cache file.
+	 * Malformed lines are skipped.
+	 *
+	 * @param data cache file content
+	 * @return false when the format is unknown
+	 */
+	bool Parse(std::string_view data);
+
+private:
+	struct Entry {
+		int64_t size;
+		int64_t mtime;
+		FileFinder::ProjectType type;
+	};
+
+	std::unordered_map<std::string, Entry> entries;
+	bool modified = false;
+};
+
+inline bool ProjectTypeCache::Key::IsValid() const {
+	return mtime != -1;
+}
+
+inline bool ProjectTypeCache::IsModified() const {
+	return modified;
+}
+
+#endif
@@ -17,6 +17,7 @@
 
 // Headers
 #include "rect.h"
+#include <algorithm>
 
 void Rect::Adjust(int max_width, int max_height) {
 	if (x < 0) {
@@ -96,6 +97,24 @@ Rect Rect::GetSubRect(const Rect src_rect) const {
 	return rect;
 }
 
+void Rect::Merge(const Rect& rect) {
+	if (rect.IsEmpty()) {
+		return;
+	}
+
+	if (IsEmpty()) {
+		*this = rect;
+		return;
+	}
+
+	const int right = std::max(x + width, rect.x + rect.width);
+	const int bottom = std::max(y + height, rect.y + rect.height);
+	x = std::min(x, rect.x);
+	y = std::min(y, rect.y);
+	width = right - x;
+	height = bottom - y;
+}
+
 bool Rect::AdjustRectangles(Rect& src, Rect& dst, const Rect& ref) {
 	if (src.x < ref.x) {
 		int dx = ref.x - src.x;
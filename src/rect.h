@@ -89,6 +89,14 @@ public:
 	 */
 	Rect GetSubRect(Rect rect) const;
 
+	/**
+	 * Extends the rect so it also contains the given rect.
+	 * Empty rects are ignored.
+	 *
+	 * @param rect rect to include.
+	 */
+	void Merge(const Rect& rect);
+
 	/** X coordinate. */
 	int x = 0;
 
@@ -19,20 +19,9 @@
 #include <array>
 #include <cassert>
 #include <cstring>
+#include <tuple>
 #include "rtp.h"
-
-static std::pair<int, int> get_table_idx(const char* const lookup_table[16], const int lookup_table_idx[16], std::string_view category) {
-	int i;
-
-	for (i = 0; lookup_table[i] != nullptr; ++i) {
-		if (std::string_view(lookup_table[i]) == category) {
-			return {lookup_table_idx[i], lookup_table_idx[i+1]};
-		}
-	}
-
-	// Points at nullptr (final row) in the rtp table
-	return {lookup_table_idx[i], lookup_table_idx[i]};
-}
+#include "span.h"
 
 template <typename T>
 static void detect_helper(const FilesystemView& fs, std::vector<struct RTP::RtpHitInfo>& hit_list,
@@ -126,18 +115,70 @@ std::vector<RTP::RtpHitInfo> RTP::Detect(const FilesystemView& fs, int version,
 	return hit_list;
 }
 
-template <typename T>
-static std::vector<RTP::Type> lookup_any_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
-		std::string_view src_name, int num_rtps, int offset) {
-	std::vector<RTP::Type> type_hits;
+namespace {
+	/**
+	 * Flat index of one RTP table, sorted by category and name.
+	 * Entries with the same key keep the table order (row, then RTP column).
+	 */
+	struct RtpIndex {
+		struct Entry {
+			std::string_view category;
+			std::string_view name;
+			int row;
+			int column;
+		};
+
+		std::vector<Entry> entries;
+
+		template <typename T>
+		RtpIndex(T rtp_table, const char* const categories[], const int categories_idx[], int num_rtps) {
+			for (int i = 0; categories[i] != nullptr; ++i) {
+				for (int row = categories_idx[i]; row < categories_idx[i + 1]; ++row) {
+					for (int j = 1; j <= num_rtps; ++j) {
+						const char* name = rtp_table[row][j];
+						if (name != nullptr) {
+							entries.push_back({categories[i], name, row, j - 1});
+						}
+					}
+				}
+			}
 
-	for (int i = range.first; i < range.second; ++i) {
-		for (int j = 1; j <= num_rtps; ++j) {
-			const char* name = rtp_table[i][j];
-			if (name != nullptr && src_name == std::string_view(name)) {
-				type_hits.push_back((RTP::Type)(j - 1 + offset));
+			std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+				return std::tie(a.category, a.name) < std::tie(b.category, b.name);
+			});
+		}
+
+		/** @return all entries matching category and name */
+		Span<const Entry> Find(std::string_view category, std::string_view name) const {
+			auto key = std::tie(category, name);
+			auto first = std::lower_bound(entries.begin(), entries.end(), key, [](const Entry& e, const auto& k) {
+				return std::tie(e.category, e.name) < k;
+			});
+			auto last = first;
+			while (last != entries.end() && last->category == category && last->name == name) {
+				++last;
 			}
+			return Span<const Entry>(entries.data() + (first - entries.begin()), last - first);
 		}
+	};
+
+	const RtpIndex& GetIndex2k() {
+		static const RtpIndex index(RTP::rtp_table_2k, RTP::rtp_table_2k_categories, RTP::rtp_table_2k_categories_idx, RTP::num_2k_rtps);
+		return index;
+	}
+
+	const RtpIndex& GetIndex2k3() {
+		static const RtpIndex index(RTP::rtp_table_2k3, RTP::rtp_table_2k3_categories, RTP::rtp_table_2k3_categories_idx, RTP::num_2k3_rtps);
+		return index;
+	}
+}
+
+static std::vector<RTP::Type> lookup_any_to_rtp_helper(const RtpIndex& index, std::string_view src_category,
+		std::string_view src_name, int offset) {
+	std::vector<RTP::Type> type_hits;
+
+	for (const auto& entry: index.Find(src_category, src_name)) {
+		type_hits.push_back((RTP::Type)(entry.column + offset));
 	}
 
 	return type_hits;
@@ -145,22 +186,19 @@ static std::vector<RTP::Type> lookup_any_to_rtp_helper(T rtp_table, const std::p
 
 std::vector<RTP::Type> RTP::LookupAnyToRtp(std::string_view src_category, std::string_view src_name, int version) {
 	if (version == 2000) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, num_2k_rtps, 0);
+		return lookup_any_to_rtp_helper(GetIndex2k(), src_category, src_name, 0);
 	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_any_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, num_2k3_rtps, num_2k_rtps);
+		return lookup_any_to_rtp_helper(GetIndex2k3(), src_category, src_name, num_2k_rtps);
 	}
 }
 
 template <typename T>
-static std::string lookup_rtp_to_rtp_helper(T rtp_table, const std::pair<int, int>& range,
+static std::string lookup_rtp_to_rtp_helper(T rtp_table, const RtpIndex& index, std::string_view src_category,
 		std::string_view src_name, int src_index, int dst_index, bool* is_rtp_asset) {
 
-	for (int i = range.first; i < range.second; ++i) {
-		const char* name = rtp_table[i][src_index + 1];
-		if (name != nullptr && src_name == std::string_view(name)) {
-			const char* dst_name = rtp_table[i][dst_index + 1];
+	for (const auto& entry: index.Find(src_category, src_name)) {
+		if (entry.column == src_index) {
+			const char* dst_name = rtp_table[entry.row][dst_index + 1];
 
 			if (is_rtp_asset) {
 				*is_rtp_asset = true;
@@ -192,10 +230,8 @@ std::string RTP::LookupRtpToRtp(std::string_view src_category, std::string_view
 	}
 
 	if ((int)src_rtp < num_2k_rtps) {
-		auto tbl_idx = get_table_idx(rtp_table_2k_categories, rtp_table_2k_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k, tbl_idx, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k, GetIndex2k(), src_category, src_name, (int)src_rtp, (int)target_rtp, is_rtp_asset);
 	} else {
-		auto tbl_idx = get_table_idx(rtp_table_2k3_categories, rtp_table_2k3_categories_idx, src_category);
-		return lookup_rtp_to_rtp_helper(rtp_table_2k3, tbl_idx, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
+		return lookup_rtp_to_rtp_helper(rtp_table_2k3, GetIndex2k3(), src_category, src_name, (int)src_rtp - num_2k_rtps, (int)target_rtp - num_2k_rtps, is_rtp_asset);
 	}
 }
@@ -0,0 +1,216 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "save_title_loader.h"
+#include "filesystem_native.h"
+#include "filesystem_stream.h"
+#include "instrumentation.h"
+#include "output.h"
+#include "platform.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <cstdlib>
+#include <lcf/lsd/reader.h>
+
+namespace {
+	/** Chunk id of lcf::rpg::Save::title, the first chunk of every save file */
+	constexpr uint32_t title_chunk_id = 0x64;
+
+	/** The title only contains a few names, larger chunks are not a valid title */
+	constexpr uint32_t max_title_chunk_size = 64 * 1024;
+
+	/** Loads in flight, low enough that a moved cursor is handled quickly */
+	constexpr size_t max_in_flight = 2;
+
+	WorkerPool& GetLoadPool() {
+		// Reading from a single thread, parallel reads are slower on SD cards
+		static WorkerPool pool(std::min(WorkerPool::GetDefaultNumThreads(), 1));
+		return pool;
+	}
+
+	/** Reads the bytes of the stream and keeps a copy */
+	class PrefixReader {
+	public:
+		explicit PrefixReader(std::istream& is) : is(is) {}
+
+		bool ReadInt(uint32_t& value) {
+			// Variable length, 7 bits per byte, most significant byte first
+			value = 0;
+			for (int i = 0; i < 5; ++i) {
+				int c = is.get();
+				if (c == EOF) {
+					return false;
+				}
+				data.push_back(static_cast<uint8_t>(c));
+				value = (value << 7) | (c & 0x7F);
+				if ((c & 0x80) == 0) {
+					return true;
+				}
+			}
+			return false;
+		}
+
+		bool Read(size_t size) {
+			size_t pos = data.size();
+			data.resize(pos + size);
+			is.read(reinterpret_cast<char*>(data.data() + pos), size);
+			return static_cast<size_t>(is.gcount()) == size;
+		}
+
+		std::vector<uint8_t> data;
+
+	private:
+		std::istream& is;
+	};
+}
+
+SaveTitleLoader::SaveTitleLoader(FilesystemView fs, std::string encoding) :
+	fs(fs), encoding(std::move(encoding)), cancelled(std::make_shared<std::atomic<bool>>(false)) {
+	// Workers need an own filesystem instance because the directory cache of
+	// fs is not thread-safe. Other filesystems are read on the main thread.
+	is_native = fs && dynamic_cast<const NativeFilesystem*>(&fs.GetOwner()) != nullptr;
+}
+
+SaveTitleLoader::~SaveTitleLoader() {
+	*cancelled = true;
+}
+
+void SaveTitleLoader::Request(int id, std::string file) {
+	queued.push_back({ id, std::move(file) });
+}
+
+std::vector<SaveTitleLoader::Result> SaveTitleLoader::Update(int cursor) {
+	std::vector<Result> results;
+
+	for (auto it = in_flight.begin(); it != in_flight.end();) {
+		if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		results.push_back({ it->id, std::move(it->file), it->result.get() });
+		it = in_flight.erase(it);
+	}
+
+	while (in_flight.size() < max_in_flight && !queued.empty()) {
+		auto next = std::min_element(queued.begin(), queued.end(), [cursor](const Queued& a, const Queued& b) {
+			return std::abs(a.id - cursor) < std::abs(b.id - cursor);
+		});
+		Queued item = std::move(*next);
+		queued.erase(next);
+		Start(std::move(item));
+	}
+
+	return results;
+}
+
+void SaveTitleLoader::Start(Queued item) {
+	EP_INSTRUMENT_ZONE("SaveTitleLoader::Start");
+
+	std::future<std::unique_ptr<lcf::rpg::Save>> result;
+
+	if (is_native) {
+		std::string path = FileFinder::MakePath(fs.GetFullPath(), item.file);
+		auto task = std::make_shared<std::packaged_task<std::unique_ptr<lcf::rpg::Save>()>>(
+				[path = std::move(path), encoding = encoding, cancelled = cancelled]() -> std::unique_ptr<lcf::rpg::Save> {
+			if (*cancelled) {
+				return nullptr;
+			}
+
+			auto native_fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+			auto is = native_fs->OpenInputStream(path);
+			if (!is) {
+				return nullptr;
+			}
+			return LoadTitle(is, encoding);
+		});
+
+		result = task->get_future();
+		GetLoadPool().Submit([task]() { (*task)(); });
+	} else {
+		std::promise<std::unique_ptr<lcf::rpg::Save>> promise;
+		promise.set_value(LoadFile(item.file));
+		result = promise.get_future();
+	}
+
+	in_flight.push_back({ item.id, std::move(item.file), std::move(result) });
+}
+
+int SaveTitleLoader::FindNewest() const {
+	if (!is_native) {
+		return -1;
+	}
+
+	int newest = -1;
+	int64_t newest_time = -1;
+	for (const auto& item: queued) {
+		int64_t time = Platform::File(FileFinder::MakePath(fs.GetFullPath(), item.file)).GetModificationTime();
+		if (newest == -1 || time > newest_time) {
+			newest = item.id;
+			newest_time = time;
+		}
+	}
+	return newest;
+}
+
+SaveTitleLoader::Result SaveTitleLoader::Load(int id) {
+	auto it = std::find_if(queued.begin(), queued.end(), [id](const Queued& item) {
+		return item.id == id;
+	});
+	if (it == queued.end()) {
+		return { id, {}, nullptr };
+	}
+
+	Queued item = std::move(*it);
+	queued.erase(it);
+	auto save = LoadFile(item.file);
+	return { item.id, std::move(item.file), std::move(save) };
+}
+
+std::unique_ptr<lcf::rpg::Save> SaveTitleLoader::LoadFile(std::string_view file) const {
+	auto is = fs.OpenInputStream(file);
+	if (!is) {
+		return nullptr;
+	}
+	return LoadTitle(is, encoding);
+}
+
+std::unique_ptr<lcf::rpg::Save> SaveTitleLoader::LoadTitle(std::istream& is, std::string_view encoding) {
+	// Layout: Length prefixed "LcfSaveData", then the chunks of lcf::rpg::Save
+	PrefixReader reader(is);
+	uint32_t header_size;
+	uint32_t chunk_id;
+	uint32_t chunk_size;
+	bool is_title_file = reader.ReadInt(header_size) && header_size == 11 && reader.Read(header_size) &&
+		reader.ReadInt(chunk_id) && chunk_id == title_chunk_id &&
+		reader.ReadInt(chunk_size) && chunk_size <= max_title_chunk_size && reader.Read(chunk_size);
+
+	if (!is_title_file) {
+		Output::Debug("Save title chunk not found, loading whole save");
+		is.clear();
+		is.seekg(0);
+		return lcf::LSD_Reader::Load(is, ToString(encoding));
+	}
+
+	// End of lcf::rpg::Save, the remaining chunks are skipped
+	reader.data.push_back(0);
+
+	Filesystem_Stream::InputMemoryStreamBufView buf(Span<uint8_t>(reader.data.data(), reader.data.size()));
+	std::istream stream(&buf);
+	return lcf::LSD_Reader::Load(stream, ToString(encoding));
+}
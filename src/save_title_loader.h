@@ -0,0 +1,135 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_TITLE_LOADER_H
+#define EP_SAVE_TITLE_LOADER_H
+
+// Headers
+#include <atomic>
+#include <future>
+#include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <lcf/rpg/save.h>
+#include "filefinder.h"
+
+/**
+ * Loads the title data (party faces, level and timestamp) of save files
+ * for the save slot windows.
+ *
+ * Only the title chunk at the beginning of each file is read. The files are
+ * read by a worker thread, the slots nearest to the cursor are loaded first.
+ */
+class SaveTitleLoader {
+public:
+	struct Result {
+		/** Slot id */
+		int id;
+		/** Filename of the save file */
+		std::string file;
+		/** Save with only the title filled, nullptr when the file is corrupted */
+		std::unique_ptr<lcf::rpg::Save> save;
+	};
+
+	/**
+	 * @param fs Save filesystem
+	 * @param encoding Encoding of the save files
+	 */
+	SaveTitleLoader(FilesystemView fs, std::string encoding);
+
+	/** Drops the requests that were not loaded yet */
+	~SaveTitleLoader();
+
+	SaveTitleLoader(const SaveTitleLoader&) = delete;
+	SaveTitleLoader& operator=(const SaveTitleLoader&) = delete;
+
+	/**
+	 * Queues a save file for loading.
+	 *
+	 * @param id Slot id
+	 * @param file Filename in the save filesystem
+	 */
+	void Request(int id, std::string file);
+
+	/**
+	 * Starts loading the queued slots nearest to the cursor and returns the
+	 * slots that finished loading.
+	 *
+	 * @param cursor Slot id the cursor is on
+	 * @return finished slots
+	 */
+	std::vector<Result> Update(int cursor);
+
+	/** @return whether all requested slots were returned by Update */
+	bool IsDone() const;
+
+	/**
+	 * Finds the queued save file that was written last, using the modification
+	 * time of the files. Only supported for saves on the native filesystem.
+	 *
+	 * @return Slot id or -1 when not supported or nothing is queued
+	 */
+	int FindNewest() const;
+
+	/**
+	 * Loads a queued slot right away on the calling thread.
+	 *
+	 * @param id Slot id
+	 * @return loaded slot, save is nullptr when the slot is not queued or corrupted
+	 */
+	Result Load(int id);
+
+	/**
+	 * Reads the title chunk of a save file.
+	 * Falls back to loading the whole save when the file layout is unexpected.
+	 *
+	 * @param is Stream of the save file
+	 * @param encoding Encoding of the save file
+	 * @return Save with the title filled or nullptr when the file is corrupted
+	 */
+	static std::unique_ptr<lcf::rpg::Save> LoadTitle(std::istream& is, std::string_view encoding);
+
+private:
+	struct Queued {
+		int id;
+		std::string file;
+	};
+
+	struct InFlight {
+		int id;
+		std::string file;
+		std::future<std::unique_ptr<lcf::rpg::Save>> result;
+	};
+
+	void Start(Queued item);
+	std::unique_ptr<lcf::rpg::Save> LoadFile(std::string_view file) const;
+
+	FilesystemView fs;
+	std::string encoding;
+	bool is_native = false;
+	std::vector<Queued> queued;
+	std::vector<InFlight> in_flight;
+	std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+inline bool SaveTitleLoader::IsDone() const {
+	return queued.empty() && in_flight.empty();
+}
+
+#endif
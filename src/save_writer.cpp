@@ -0,0 +1,132 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "save_writer.h"
+#include "async_handler.h"
+#include "filesystem_native.h"
+#include "instrumentation.h"
+#include "output.h"
+#include "platform.h"
+#include "worker_pool.h"
+#include <deque>
+#include <algorithm>
+#include <future>
+#include <memory>
+
+namespace {
+	struct Job {
+		FilesystemView fs;
+		std::string filename;
+		std::future<bool> result;
+		SaveWriter::DoneCallback on_done;
+	};
+
+	std::deque<Job> jobs;
+
+	WorkerPool& GetWritePool() {
+		// One thread: Writes to the same slot must happen in order
+		static WorkerPool pool(std::min(WorkerPool::GetDefaultNumThreads(), 1));
+		return pool;
+	}
+
+	bool WriteAtomic(const std::string& path, const lcf::rpg::Save& save, lcf::EngineVersion engine, const std::string& encoding) {
+		EP_INSTRUMENT_ZONE("SaveWriter::WriteAtomic");
+
+		// Own filesystem instance: The directory cache of the save filesystem is not thread-safe
+		auto native_fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+		std::string tmp_path = path + ".tmp";
+		Platform::File tmp_file(tmp_path);
+
+		bool written = false;
+		{
+			auto os = native_fs->OpenOutputStream(tmp_path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+			if (!os) {
+				return false;
+			}
+
+			written = lcf::LSD_Reader::Save(os, save, engine, encoding) && os.flush();
+		}
+
+		// The data must be on the disk before the rename makes it the save file,
+		// otherwise a crash can leave an empty file behind
+		if (!written || !tmp_file.Sync() || !tmp_file.Rename(path)) {
+			tmp_file.Remove();
+			return false;
+		}
+		return true;
+	}
+
+	void Report(Job& job, bool success) {
+		// Written by a worker, the cache of the main thread is outdated
+		job.fs.ClearCache();
+
+		if (success) {
+			Output::Debug("Saved {}", job.filename);
+			AsyncHandler::SaveFilesystem();
+		} else {
+			Output::Warning("Failed saving to {}", job.filename);
+		}
+
+		if (job.on_done) {
+			job.on_done(success);
+		}
+	}
+}
+
+void SaveWriter::Write(const FilesystemView& fs, std::string filename, lcf::rpg::Save save,
+		lcf::EngineVersion engine, std::string encoding, DoneCallback on_done) {
+	bool is_native = dynamic_cast<const NativeFilesystem*>(&fs.GetOwner()) != nullptr;
+
+	if (!is_native) {
+		Job job = { fs, std::move(filename), {}, std::move(on_done) };
+		auto os = fs.OpenOutputStream(job.filename);
+		bool success = os && lcf::LSD_Reader::Save(os, save, engine, encoding);
+		Report(job, success);
+		return;
+	}
+
+	std::string path = FileFinder::MakePath(fs.GetFullPath(), filename);
+	auto task = std::make_shared<std::packaged_task<bool()>>(
+			[path = std::move(path), save = std::move(save), engine, encoding = std::move(encoding)]() {
+		return WriteAtomic(path, save, engine, encoding);
+	});
+
+	jobs.push_back({ fs, std::move(filename), task->get_future(), std::move(on_done) });
+	GetWritePool().Submit([task]() { (*task)(); });
+}
+
+void SaveWriter::Update() {
+	// In order: A callback can depend on an earlier write
+	while (!jobs.empty() && jobs.front().result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		Report(job, job.result.get());
+	}
+}
+
+void SaveWriter::Wait() {
+	while (!jobs.empty()) {
+		Job job = std::move(jobs.front());
+		jobs.pop_front();
+		Report(job, job.result.get());
+	}
+}
+
+bool SaveWriter::IsPending() {
+	return !jobs.empty();
+}
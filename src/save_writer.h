@@ -0,0 +1,66 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_WRITER_H
+#define EP_SAVE_WRITER_H
+
+// Headers
+#include <functional>
+#include <string>
+#include <lcf/lsd/reader.h>
+#include <lcf/rpg/save.h>
+#include "filefinder.h"
+
+/**
+ * Writes save files on a worker thread.
+ *
+ * The save data is a snapshot that is owned by the writer, the game continues
+ * while it is encoded. The file is written to a temporary file first and then
+ * renamed, an interrupted write never destroys the previous save.
+ */
+namespace SaveWriter {
+	using DoneCallback = std::function<void(bool success)>;
+
+	/**
+	 * Queues writing a save file.
+	 * On filesystems that are not on the host (e.g. Android storage access)
+	 * the file is written immediately.
+	 *
+	 * @param fs Save filesystem
+	 * @param filename Filename in the save filesystem
+	 * @param save Save data, moved to the worker
+	 * @param engine Engine version
+	 * @param encoding Encoding of the strings
+	 * @param on_done Called on the main thread when the file was written, can be empty
+	 */
+	void Write(const FilesystemView& fs, std::string filename, lcf::rpg::Save save,
+		lcf::EngineVersion engine, std::string encoding, DoneCallback on_done = {});
+
+	/** Reports the writes that finished, called every frame */
+	void Update();
+
+	/**
+	 * Waits until all queued writes finished and reports them.
+	 * Must be called before save files are read.
+	 */
+	void Wait();
+
+	/** @return whether a write did not finish yet */
+	bool IsPending();
+}
+
+#endif
@@ -21,6 +21,7 @@
 #include "scene.h"
 #include "graphics.h"
 #include "input.h"
+#include "instrumentation.h"
 #include "player.h"
 #include "output.h"
 #include "audio.h"
@@ -143,6 +144,7 @@ void Scene::ScheduleTransitionIn(Scene::SceneType prev_scene_type) {
 }
 
 void Scene::MainFunction() {
+	EP_INSTRUMENT_ZONE("Scene::MainFunction");
 	static bool init = false;
 
 	if (IsAsyncPending()) {
@@ -324,6 +326,17 @@ void Scene::DrawBackground(Bitmap& dst) {
 	dst.Fill(Main_Data::game_system->GetBackgroundColor());
 }
 
+bool Scene::GetBackgroundDamage(Drawable::DamageInfo& info) const {
+	if (Main_Data::game_system) {
+		Color color = Main_Data::game_system->GetBackgroundColor();
+		info.Hash(color.red);
+		info.Hash(color.green);
+		info.Hash(color.blue);
+		info.Hash(color.alpha);
+	}
+	return true;
+}
+
 bool Scene::CheckSceneExit(AsyncOp aop) {
 	if (aop.GetType() == AsyncOp::eExitGame) {
 		if (Scene::Find(Scene::GameBrowser)) {
@@ -212,6 +212,15 @@ public:
 	 */
 	virtual void DrawBackground(Bitmap& dst);
 
+	/**
+	 * Reports the state of the background for damage tracking (see Drawable::GetDamage).
+	 * The rect of info is ignored, the background always covers the whole screen.
+	 *
+	 * @param info output
+	 * @return false when the background is not tracked and the whole screen must be redrawn every frame
+	 */
+	virtual bool GetBackgroundDamage(Drawable::DamageInfo& info) const;
+
 	DrawableList& GetDrawableList();
 
 	/** @return true if the Scene has been initialized */
@@ -25,8 +25,8 @@
 #include "game_system.h"
 #include "game_party.h"
 #include "input.h"
-#include <lcf/lsd/reader.h>
 #include "player.h"
+#include "save_writer.h"
 #include "scene_file.h"
 #include "bitmap.h"
 #include <lcf/reader_util.h>
@@ -96,23 +96,39 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 	std::string file = fs.FindFile(ss.str());
 
 	if (!file.empty()) {
-		// File found
-		auto save_stream = FileFinder::Save().OpenInputStream(file);
-		if (!save_stream) {
-			Output::Debug("Save {} read error", file);
-			win.SetCorrupted(true);
-			return;
-		}
+		// File found, the party is shown when the title is loaded
+		win.SetHasSave(true);
+		title_loader->Request(id, file);
+	}
+}
+
+void Scene_File::ApplySaveTitle(SaveTitleLoader::Result& result) {
+	auto& win = *file_windows[result.id];
+	if (result.save) {
+		PopulatePartyFaces(win, result.id, *result.save);
+		UpdateLatestTimestamp(result.id, *result.save);
+	} else {
+		Output::Debug("Save {} corrupted", result.file);
+		win.SetHasSave(false);
+		win.SetCorrupted(true);
+	}
+	win.Refresh();
+}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+void Scene_File::UpdateSaveTitles() {
+	if (!title_loader || title_loader->IsDone()) {
+		return;
+	}
 
-		if (savegame) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
-		} else {
-			Output::Debug("Save {} corrupted", file);
-			win.SetCorrupted(true);
-		}
+	for (auto& result: title_loader->Update(index)) {
+		ApplySaveTitle(result);
+	}
+
+	// Only when the timestamps disagree with the modification times
+	if (title_loader->IsDone() && !cursor_moved && index != latest_slot) {
+		index = latest_slot;
+		top_index = std::max(0, index - 2);
+		RefreshWindows();
 	}
 }
 
@@ -121,7 +137,9 @@ void Scene_File::Start() {
 	border_top = Scene_File::MakeBorderSprite(32);
 
 	// Refresh File Finder Save Folder
+	SaveWriter::Wait();
 	fs = FileFinder::Save();
+	title_loader = std::make_unique<SaveTitleLoader>(fs, Player::encoding);
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		std::shared_ptr<Window_SaveFile>
@@ -139,6 +157,21 @@ void Scene_File::Start() {
 	up_arrow = Scene_File::MakeArrowSprite(false);
 	down_arrow = Scene_File::MakeArrowSprite(true);
 
+	// The newest save is loaded first, so the cursor starts on it
+	int newest = title_loader->FindNewest();
+	if (newest >= 0) {
+		auto result = title_loader->Load(newest);
+		ApplySaveTitle(result);
+	} else {
+		// Not on the native filesystem, the titles are read on this thread anyway
+		while (!title_loader->IsDone()) {
+			UpdateSaveTitles();
+		}
+	}
+
+	// The remaining titles are loaded in the background
+	UpdateSaveTitles();
+
 	index = latest_slot;
 	top_index = std::max(0, index - 2);
 
@@ -168,6 +201,9 @@ void Scene_File::RefreshWindows() {
 }
 
 void Scene_File::Refresh() {
+	title_loader = std::make_unique<SaveTitleLoader>(fs, Player::encoding);
+	cursor_moved = true;
+
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		Window_SaveFile *w = file_windows[i].get();
 		PopulateSaveWindow(*w, i);
@@ -177,6 +213,7 @@ void Scene_File::Refresh() {
 
 void Scene_File::vUpdate() {
 	UpdateArrows();
+	UpdateSaveTitles();
 
 	if (IsWindowMoving()) {
 		for (auto& fw: file_windows) {
@@ -253,6 +290,10 @@ void Scene_File::vUpdate() {
 
 	//top_index = std::min(top_index, std::max(top_index, index - 3 + 1));
 
+	if (index != old_index) {
+		cursor_moved = true;
+	}
+
 	if (top_index != old_top_index || index != old_index)
 		RefreshWindows();
 
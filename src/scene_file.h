@@ -26,6 +26,7 @@
 #include "window_help.h"
 #include "window_savefile.h"
 #include "window_command.h"
+#include "save_title_loader.h"
 #include "sprite.h"
 
 
@@ -61,6 +62,10 @@ protected:
 	static std::unique_ptr<Sprite> MakeArrowSprite(bool down);
 
 	void RefreshWindows();
+	/** Fills the slot window of a loaded title */
+	void ApplySaveTitle(SaveTitleLoader::Result& result);
+	/** Fills the slot windows with the titles loaded in the background */
+	void UpdateSaveTitles();
 	void MoveFileWindows(int dy, int dt);
 	void UpdateArrows();
 	bool HandleExtraCommandsWindow();
@@ -77,9 +82,15 @@ protected:
 	std::string message;
 
 	FilesystemView fs;
+	std::unique_ptr<SaveTitleLoader> title_loader;
 
 	double latest_time = 0;
 	int latest_slot = 0;
+	/**
+	 * The cursor starts on the newest file. When the timestamps of the titles
+	 * disagree it moves to the latest slot once all titles are loaded.
+	 */
+	bool cursor_moved = false;
 
 	int arrow_frame = 0;
 
@@ -216,6 +216,11 @@ void Scene_Map::TransitionOut(SceneType next_scene) {
 	Scene::TransitionOut(next_scene);
 }
 
+bool Scene_Map::GetBackgroundDamage(Drawable::DamageInfo&) const {
+	// Whether the screen is cleared depends on the drawables of the map
+	return false;
+}
+
 void Scene_Map::DrawBackground(Bitmap& dst) {
 	if (spriteset->RequireClear(GetDrawableList())) {
 		dst.Clear();
@@ -395,10 +400,13 @@ void Scene_Map::OnAsyncSuspend(F&& f, AsyncOp aop, bool is_preupdate) {
 
 	if (aop.GetType() == AsyncOp::eSave) {
 		auto savefs = FileFinder::Save();
-		bool success = Scene_Save::Save(savefs, aop.GetSaveSlot());
 		if (aop.GetSaveResultVar() > 0) {
+			// The script reads the result immediately, wait for the file
+			bool success = Scene_Save::Save(savefs, aop.GetSaveSlot());
 			Main_Data::game_variables->Set(aop.GetSaveResultVar(), success ? 1 : 0);
 			Game_Map::SetNeedRefresh(true);
+		} else {
+			Scene_Save::SaveAsync(savefs, aop.GetSaveSlot());
 		}
 	}
 
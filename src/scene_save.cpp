@@ -41,6 +41,7 @@
 #include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
+#include "save_writer.h"
 #include "scene_save.h"
 #include "translation.h"
 #include "version.h"
@@ -60,7 +61,7 @@ void Scene_Save::Start() {
 }
 
 void Scene_Save::Action(int index) {
-	Save(fs, index + 1);
+	SaveAsync(fs, index + 1);
 
 	Scene::Pop();
 }
@@ -76,21 +77,46 @@ std::string Scene_Save::GetSaveFilename(const FilesystemView& fs, int slot_id) {
 	return filename;
 }
 
+namespace {
+	lcf::EngineVersion GetLcfEngine() {
+		return Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
+	}
+}
+
 bool Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save) {
 	const auto filename = GetSaveFilename(fs, slot_id);
 	Output::Debug("Saving to {}", filename);
 
-	auto save_stream = FileFinder::Save().OpenOutputStream(filename);
+	bool res = false;
+	SaveWriter::Write(FileFinder::Save(), filename, CreateSave(slot_id, prepare_save), GetLcfEngine(), Player::encoding,
+		[&res](bool success) { res = success; });
+	SaveWriter::Wait();
 
-	if (!save_stream) {
-		Output::Warning("Failed saving to {}", filename);
-		return false;
-	}
+	Main_Data::game_dynrpg->Save(slot_id);
 
-	return Save(save_stream, slot_id, prepare_save);
+	return res;
+}
+
+void Scene_Save::SaveAsync(const FilesystemView& fs, int slot_id, bool prepare_save) {
+	const auto filename = GetSaveFilename(fs, slot_id);
+	Output::Debug("Saving to {}", filename);
+
+	SaveWriter::Write(FileFinder::Save(), filename, CreateSave(slot_id, prepare_save), GetLcfEngine(), Player::encoding);
+
+	Main_Data::game_dynrpg->Save(slot_id);
 }
 
 bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	bool res = lcf::LSD_Reader::Save(os, CreateSave(slot_id, prepare_save), GetLcfEngine(), Player::encoding);
+
+	Main_Data::game_dynrpg->Save(slot_id);
+
+	AsyncHandler::SaveFilesystem();
+
+	return res;
+}
+
+lcf::rpg::Save Scene_Save::CreateSave(int slot_id, bool prepare_save) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -153,14 +179,8 @@ bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 			sme.map_id = 0;
 		}
 	}
-	auto lcf_engine = Player::IsRPG2k3() ? lcf::EngineVersion::e2k3 : lcf::EngineVersion::e2k;
-	bool res = lcf::LSD_Reader::Save(os, save, lcf_engine, Player::encoding);
-
-	Main_Data::game_dynrpg->Save(slot_id);
 
-	AsyncHandler::SaveFilesystem();
-
-	return res;
+	return save;
 }
 
 bool Scene_Save::IsSlotValid(int) {
@@ -20,6 +20,7 @@
 
 // Headers
 #include <vector>
+#include <lcf/rpg/save.h>
 #include "scene.h"
 #include "scene_file.h"
 
@@ -42,6 +43,26 @@ public:
 	static std::string GetSaveFilename(const FilesystemView& tree, int slot_id);
 	static bool Save(const FilesystemView& tree, int slot_id, bool prepare_save = true);
 	static bool Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+	/**
+	 * Saves the game without waiting for the file to be written.
+	 * The game state is captured immediately, the file is written by a worker.
+	 *
+	 * @param tree Save filesystem
+	 * @param slot_id Save slot
+	 * @param prepare_save Whether the save counter and version are updated
+	 */
+	static void SaveAsync(const FilesystemView& tree, int slot_id, bool prepare_save = true);
+
+private:
+	/**
+	 * Captures the current game state.
+	 *
+	 * @param slot_id Save slot
+	 * @param prepare_save Whether the save counter and version are updated
+	 * @return save data
+	 */
+	static lcf::rpg::Save CreateSave(int slot_id, bool prepare_save);
 };
 
 #endif
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <cmath>
 #include <string>
 #include "sprite.h"
 #include "player.h"
@@ -37,6 +38,61 @@ void Sprite::Draw(Bitmap& dst) {
 	BlitScreen(dst);
 }
 
+bool Sprite::GetDamage(DamageInfo& info) const {
+	if (angle_effect != 0.0 || waver_effect_depth != 0) {
+		// The bounds of rotated and wavering sprites are not calculated
+		return false;
+	}
+
+	info.rect = {};
+	if (GetWidth() <= 0 || GetHeight() <= 0 || !bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0)) {
+		return true;
+	}
+
+	const Rect rect = src_rect_effect.GetSubRect(src_rect);
+	const int dst_ox = ox - GetRenderOx();
+	const int dst_oy = oy - GetRenderOy();
+
+	if (zoom_x_effect == 1.0 && zoom_y_effect == 1.0) {
+		info.rect = { x - dst_ox, y - dst_oy, rect.width, rect.height };
+	} else {
+		// Same rounding as ZoomOpacityBlit with one pixel extra for filtering
+		info.rect = {
+			x - static_cast<int>(std::floor(dst_ox * zoom_x_effect)) - 1,
+			y - static_cast<int>(std::floor(dst_oy * zoom_y_effect)) - 1,
+			static_cast<int>(std::ceil(rect.width * zoom_x_effect)) + 2,
+			static_cast<int>(std::ceil(rect.height * zoom_y_effect)) + 2
+		};
+	}
+
+	info.Hash(bitmap.get());
+	info.Hash(bitmap->GetRevision());
+	info.Hash(src_rect);
+	info.Hash(src_rect_effect);
+	info.Hash(x);
+	info.Hash(y);
+	info.Hash(dst_ox);
+	info.Hash(dst_oy);
+	info.Hash(zoom_x_effect);
+	info.Hash(zoom_y_effect);
+	info.Hash(opacity_top_effect);
+	info.Hash(opacity_bottom_effect);
+	info.Hash(bush_effect);
+	info.Hash(blend_type_effect);
+	info.Hash(tone_effect.red);
+	info.Hash(tone_effect.green);
+	info.Hash(tone_effect.blue);
+	info.Hash(tone_effect.gray);
+	info.Hash(flash_effect.red);
+	info.Hash(flash_effect.green);
+	info.Hash(flash_effect.blue);
+	info.Hash(flash_effect.alpha);
+	info.Hash(flipx_effect);
+	info.Hash(flipy_effect);
+
+	return true;
+}
+
 void Sprite::BlitScreen(Bitmap& dst) {
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
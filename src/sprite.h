@@ -34,6 +34,8 @@ public:
 
 	void Draw(Bitmap& dst) override;
 
+	bool GetDamage(DamageInfo& info) const override;
+
 	virtual int GetWidth() const;
 	virtual int GetHeight() const;
 
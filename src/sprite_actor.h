@@ -90,6 +90,8 @@ public:
 	int GetHeight() const override;
 
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 	Game_Actor* GetBattler() const;
 
@@ -33,6 +33,8 @@ class Sprite_AirshipShadow : public Sprite {
 public:
 	Sprite_AirshipShadow(int x_offset = 0, int y_offset = 0);
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 	void Update();
 	void RecreateShadow();
 
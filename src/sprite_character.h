@@ -42,6 +42,8 @@ public:
 	Sprite_Character(Game_Character* character, int x_offset = 0, int y_offset = 0);
 
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 	/**
 	 * Updates sprite state.
@@ -41,6 +41,8 @@ public:
 	~Sprite_Enemy() override;
 
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 	Game_Enemy* GetBattler() const;
 
@@ -35,6 +35,8 @@ public:
 	Sprite_Picture(int pic_id, Drawable::Flags flags = Drawable::Flags::Default);
 
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 	void OnPictureShow();
 
@@ -37,6 +37,8 @@ public:
 
 protected:
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 	int which = 0;
 
@@ -53,6 +53,8 @@ public:
 	void StopAttack();
 
 	void Draw(Bitmap& dst) override;
+	/** The state is updated in Draw, the sprite is not damage tracked */
+	bool GetDamage(DamageInfo&) const override { return false; }
 
 protected:
 	void CreateSprite();
@@ -16,6 +16,7 @@
  */
 
 // Headers
+#include <algorithm>
 #include <cstring>
 #include <cmath>
 #include "tilemap_layer.h"
@@ -209,11 +210,12 @@ TilemapLayer::TilemapLayer(int ilayer) :
 // was created intentionally. Inlining the transparency check was measured and shown
 // to provide a performance improvement
 EP_ALWAYS_INLINE
-void TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit) {
+ImageOpacity TilemapLayer::DrawTile(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit) {
 	auto op = tileset.GetTileOpacity(col, row);
 	if (op != ImageOpacity::Transparent) {
 		DrawTileImpl(dst, tileset, tone_tileset, x, y, row, col, tone_hash, op, allow_fast_blit);
 	}
+	return op;
 }
 
 void TilemapLayer::DrawTileImpl(Bitmap& dst, Bitmap& tileset, Bitmap& tone_tileset, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit) {
@@ -258,6 +260,109 @@ static uint32_t MakeAbTileHash(int id, int anim_step) {
 	return static_cast<uint32_t>((id + (anim_step << 12)) | (4 << 24));
 }
 
+static int DivRoundingDown(int n, int m) {
+	if (n >= 0) return n / m;
+	return (n - m + 1) / m;
+}
+
+static int Mod(int n, int m) {
+	int rem = n % m;
+	return rem >= 0 ? rem : m + rem;
+}
+
+static uint32_t GetFrameCounter() {
+	// FIXME: When Game_Map singleton is made an object we can remove this null check
+	return Main_Data::game_system ? static_cast<uint32_t>(Main_Data::game_system->GetFrameCounter()) : 0u;
+}
+
+ImageOpacity TilemapLayer::DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab) {
+	if (layer == 0) {
+		// If lower layer
+		bool allow_fast_blit = (tile.z == TileBelow);
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			auto tone_hash = MakeETileHash(id);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			// Create tone changed tile
+			auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
+			return DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			auto tone_hash = MakeDTileHash(tile.ID);
+			return DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			auto tone_hash = MakeFTileHash(id);
+			return DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash);
+		}
+	}
+	return ImageOpacity::Transparent;
+}
+
+bool TilemapLayer::IsAnimatedTile(const TileData& tile) const {
+	// Blocks A1, A2, B and C are animated, they only exist in the lower layer
+	return layer == 0 && tile.ID < BLOCK_D;
+}
+
 void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy) {
 	// Get the number of tiles that can be displayed on window
 	int tiles_x = (int)ceil(Player::screen_width / (float)TILE_SIZE);
@@ -272,22 +377,9 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 		++tiles_y;
 	}
 
-	const bool loop_h = Game_Map::LoopHorizontal();
-	const bool loop_v = Game_Map::LoopVertical();
-
-	auto div_rounding_down = [](int n, int m) {
-		if (n >= 0) return n / m;
-		return (n - m + 1) / m;
-	};
-	auto mod = [](int n, int m) {
-		int rem = n % m;
-		return rem >= 0 ? rem : m + rem;
-	};
-
-	// FIXME: When Game_Map singleton is made an object we can remove this null check
-	const auto frames = Main_Data::game_system ? static_cast<uint32_t>(Main_Data::game_system->GetFrameCounter()) : 0u;
-	auto animation_step_c = (frames / 6) % 4;
-	auto animation_step_ab = frames / animation_speed;
+	const auto frames = GetFrameCounter();
+	int animation_step_c = (frames / 6) % 4;
+	int animation_step_ab = frames / animation_speed;
 	if (animation_type) {
 		animation_step_ab %= 3;
 	} else {
@@ -297,11 +389,23 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 		}
 	}
 
-	const int div_ox = div_rounding_down(ox - render_ox, TILE_SIZE);
-	const int div_oy = div_rounding_down(oy - render_oy, TILE_SIZE);
+	const int div_ox = DivRoundingDown(ox - render_ox, TILE_SIZE);
+	const int div_oy = DivRoundingDown(oy - render_oy, TILE_SIZE);
 
-	const int mod_ox = mod(ox - render_ox, TILE_SIZE);
-	const int mod_oy = mod(oy - render_oy, TILE_SIZE);
+	const int mod_ox = Mod(ox - render_ox, TILE_SIZE);
+	const int mod_oy = Mod(oy - render_oy, TILE_SIZE);
+
+	// While the tone fades the chunks would be rendered again in every frame
+	if (frames == tone_change_frame) {
+		DrawTiles(dst, z_order, div_ox, div_oy, mod_ox, mod_oy, tiles_x, tiles_y, animation_step_c, animation_step_ab);
+	} else {
+		DrawChunks(dst, z_order, div_ox, div_oy, mod_ox, mod_oy, tiles_x, tiles_y, animation_step_c, animation_step_ab);
+	}
+}
+
+void TilemapLayer::DrawTiles(Bitmap& dst, uint8_t z_order, int div_ox, int div_oy, int mod_ox, int mod_oy, int tiles_x, int tiles_y, int animation_step_c, int animation_step_ab) {
+	const bool loop_h = Game_Map::LoopHorizontal();
+	const bool loop_v = Game_Map::LoopVertical();
 
 	for (int y = 0; y < tiles_y; y++) {
 		for (int x = 0; x < tiles_x; x++) {
@@ -309,8 +413,8 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 			// Get the real maps tile coordinates
 			int map_x = div_ox + x;
 			int map_y = div_oy + y;
-			if (loop_h) map_x = mod(map_x, width);
-			if (loop_v) map_y = mod(map_y, height);
+			if (loop_h) map_x = Mod(map_x, width);
+			if (loop_v) map_y = Mod(map_y, height);
 
 			bool out_of_bounds =
 				map_x < 0 || map_x >= width ||
@@ -328,88 +432,171 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 
 			// Draw the sublayer if its z is being draw now
 			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-					bool allow_fast_blit = (tile.z == TileBelow);
-
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
-
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
-
-						auto tone_hash = MakeETileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
-
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
-
-						auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						// Create tone changed tile
-						auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
-						DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else {
-						// If blocks D1-D12
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						auto tone_hash = MakeDTileHash(tile.ID);
-						DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					}
+				DrawTileData(dst, tile, map_draw_x, map_draw_y, animation_step_c, animation_step_ab);
+			}
+		}
+	}
+}
+
+void TilemapLayer::DrawChunks(Bitmap& dst, uint8_t z_order, int div_ox, int div_oy, int mod_ox, int mod_oy, int tiles_x, int tiles_y, int animation_step_c, int animation_step_ab) {
+	const bool loop_h = Game_Map::LoopHorizontal();
+	const bool loop_v = Game_Map::LoopVertical();
+	const int sublayer = z_order >= TileAbove ? 1 : 0;
+	const uint32_t animation_key = static_cast<uint32_t>(animation_step_c | (animation_step_ab << 8));
+	// Fast blit is only allowed for the lower sublayer of the lower layer, see DrawTileData
+	const bool allow_fast_blit = fast_blit && layer == 0 && sublayer == 0;
+
+	if (chunks.size() != static_cast<size_t>(2 * GetChunksX() * GetChunksY())) {
+		// The map size changed
+		InvalidateChunks();
+	}
+
+	++draw_count;
+
+	// The screen is split at the chunk borders and at the map borders of looping maps,
+	// every part is drawn with one blit from a chunk
+	for (int y = 0; y < tiles_y;) {
+		int map_y = div_oy + y;
+		if (loop_v) map_y = Mod(map_y, height);
+		if (map_y < 0) {
+			y -= map_y;
+			continue;
+		}
+		if (map_y >= height) {
+			break;
+		}
+
+		const int chunk_y = map_y / CHUNK_SIZE;
+		const int span_y = std::min({ tiles_y - y, (chunk_y + 1) * CHUNK_SIZE - map_y, height - map_y });
+
+		for (int x = 0; x < tiles_x;) {
+			int map_x = div_ox + x;
+			if (loop_h) map_x = Mod(map_x, width);
+			if (map_x < 0) {
+				x -= map_x;
+				continue;
+			}
+			if (map_x >= width) {
+				break;
+			}
+
+			const int chunk_x = map_x / CHUNK_SIZE;
+			const int span_x = std::min({ tiles_x - x, (chunk_x + 1) * CHUNK_SIZE - map_x, width - map_x });
+
+			auto& chunk = GetChunk(sublayer, chunk_x, chunk_y);
+			if (!chunk.valid || (chunk.animated && chunk.animation_key != animation_key)) {
+				RenderChunk(chunk, z_order, chunk_x, chunk_y, animation_step_c, animation_step_ab);
+				chunk.animation_key = animation_key;
+			}
+
+			if (chunk.bitmap) {
+				if (chunk.last_used == 0) {
+					used_chunks.push_back(&chunk);
+				}
+				chunk.last_used = draw_count;
+
+				Rect src_rect {
+					(map_x - chunk_x * CHUNK_SIZE) * TILE_SIZE,
+					(map_y - chunk_y * CHUNK_SIZE) * TILE_SIZE,
+					span_x * TILE_SIZE,
+					span_y * TILE_SIZE
+				};
+				const int draw_x = x * TILE_SIZE - mod_ox;
+				const int draw_y = y * TILE_SIZE - mod_oy;
+
+				if (chunk.opaque || (allow_fast_blit && chunk.covered)) {
+					dst.BlitFast(draw_x, draw_y, *chunk.bitmap, src_rect, 255);
+				} else {
+					dst.Blit(draw_x, draw_y, *chunk.bitmap, src_rect, 255);
+				}
+			}
+
+			x += span_x;
+		}
+
+		y += span_y;
+	}
+
+	// Release the memory of chunks that were not visible for a while
+	for (size_t i = 0; i < used_chunks.size();) {
+		auto* chunk = used_chunks[i];
+		if (draw_count - chunk->last_used > CHUNK_LIFETIME) {
+			chunk->bitmap.reset();
+			chunk->valid = false;
+			chunk->last_used = 0;
+			used_chunks[i] = used_chunks.back();
+			used_chunks.pop_back();
+		} else {
+			++i;
+		}
+	}
+}
+
+void TilemapLayer::RenderChunk(TileChunk& chunk, uint8_t z_order, int chunk_x, int chunk_y, int animation_step_c, int animation_step_ab) {
+	const int first_x = chunk_x * CHUNK_SIZE;
+	const int first_y = chunk_y * CHUNK_SIZE;
+	const int chunk_width = std::min(CHUNK_SIZE, width - first_x);
+	const int chunk_height = std::min(CHUNK_SIZE, height - first_y);
+
+	chunk.valid = true;
+	chunk.animated = false;
+	chunk.opaque = true;
+	chunk.covered = true;
+
+	bool empty = true;
+	for (int y = 0; y < chunk_height; ++y) {
+		for (int x = 0; x < chunk_width; ++x) {
+			const TileData& tile = GetDataCache(first_x + x, first_y + y);
+			if (tile.z != z_order) {
+				chunk.opaque = false;
+				chunk.covered = false;
+				continue;
+			}
+
+			if (empty) {
+				// The bitmap is only allocated when the chunk contains a tile of this sublayer
+				if (!chunk.bitmap) {
+					chunk.bitmap = Bitmap::Create(chunk_width * TILE_SIZE, chunk_height * TILE_SIZE, true);
 				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
-						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
-						}
-
-						auto tone_hash = MakeFTileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash);
-					}
+					chunk.bitmap->Clear();
 				}
+				empty = false;
+			}
+
+			chunk.animated |= IsAnimatedTile(tile);
+
+			auto op = DrawTileData(*chunk.bitmap, tile, x * TILE_SIZE, y * TILE_SIZE, animation_step_c, animation_step_ab);
+			if (op != ImageOpacity::Opaque) {
+				chunk.opaque = false;
+			}
+			if (op == ImageOpacity::Transparent) {
+				chunk.covered = false;
 			}
 		}
 	}
+
+	if (empty && chunk.bitmap) {
+		chunk.bitmap.reset();
+		chunk.last_used = 0;
+		used_chunks.erase(std::remove(used_chunks.begin(), used_chunks.end(), &chunk), used_chunks.end());
+	}
+}
+
+void TilemapLayer::InvalidateChunks() {
+	used_chunks.clear();
+	chunks.clear();
+	chunks.resize(2 * GetChunksX() * GetChunksY());
+}
+
+void TilemapLayer::InvalidateChunkAt(int x, int y) {
+	if (chunks.size() != static_cast<size_t>(2 * GetChunksX() * GetChunksY())) {
+		return;
+	}
+
+	const int chunk_x = x / CHUNK_SIZE;
+	const int chunk_y = y / CHUNK_SIZE;
+	GetChunk(0, chunk_x, chunk_y).valid = false;
+	GetChunk(1, chunk_x, chunk_y).valid = false;
 }
 
 TilemapLayer::TileXY TilemapLayer::GetCachedAutotileAB(short ID, short animID) {
@@ -427,6 +614,7 @@ TilemapLayer::TileXY TilemapLayer::GetCachedAutotileD(short ID) {
 
 void TilemapLayer::CreateTileCache(const std::vector<short>& nmap_data) {
 	data_cache_vec.resize(width * height);
+	InvalidateChunks();
 	for (int x = 0; x < width; x++) {
 		for (int y = 0; y < height; y++) {
 			auto tile_id = nmap_data[x + y * width];
@@ -468,6 +656,7 @@ void TilemapLayer::RecreateTileDataAt(int x, int y, int tile_id) {
 	map_data[x + y * width] = static_cast<short>(tile_id);
 	Game_Map::ReplaceTileAt(x, y, tile_id, layer);
 	CreateTileCacheAt(x, y, tile_id);
+	InvalidateChunkAt(x, y);
 }
 
 void TilemapLayer::GenerateAutotileAB(short ID, short animID) {
@@ -673,6 +862,7 @@ void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
 	chipset = nchipset;
 	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
 	chipset_tone_tiles.clear();
+	InvalidateChunks();
 
 	if (autotiles_ab_next != 0 && autotiles_d_screen != nullptr && layer == 0) {
 		autotiles_ab_screen = GenerateAutotiles(autotiles_ab_next, autotiles_ab_map);
@@ -686,6 +876,12 @@ void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
 void TilemapLayer::SetMapData(std::vector<short> nmap_data) {
 	// Create the tiles data cache
 	CreateTileCache(nmap_data);
+	CreateAutotileCache();
+
+	map_data = std::move(nmap_data);
+}
+
+void TilemapLayer::CreateAutotileCache() {
 	memset(autotiles_ab, 0, sizeof(autotiles_ab));
 	memset(autotiles_d, 0, sizeof(autotiles_d));
 
@@ -718,8 +914,6 @@ void TilemapLayer::SetMapData(std::vector<short> nmap_data) {
 
 		chipset_tone_tiles.clear();
 	}
-
-	map_data = std::move(nmap_data);
 }
 
 static inline bool IsTileFromBlock(int tile_id, int block) {
@@ -764,7 +958,9 @@ void TilemapLayer::SetMapTileDataAt(int x, int y, int tile_id, bool disable_auto
 		}
 	}
 
-	SetMapData(map_data);
+	// The tile data was updated by RecreateTileDataAt, only the chunks of the
+	// changed tiles are rendered again
+	CreateAutotileCache();
 }
 
 static inline bool IsAutotileD(int tile_id) {
@@ -893,6 +1089,10 @@ void TilemapLayer::SetTone(Tone tone) {
 	}
 
 	this->tone = tone;
+	tone_change_frame = GetFrameCounter();
+	for (auto& chunk: chunks) {
+		chunk.valid = false;
+	}
 
 	if (autotiles_d_screen_effect) {
 		autotiles_d_screen_effect->Clear();
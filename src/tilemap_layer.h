@@ -20,6 +20,7 @@
 
 // Headers
 #include <cstdint>
+#include <limits>
 #include <vector>
 #include <map>
 #include <unordered_set>
@@ -120,7 +121,7 @@ private:
 	void RecreateTileDataAt(int x, int y, int tile_id);
 	void GenerateAutotileAB(short ID, short animID);
 	void GenerateAutotileD(short ID);
-	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
+	ImageOpacity DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
 	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
 	void RecalculateAutotile(int x, int y, int tile_id);
 
@@ -161,6 +162,64 @@ private:
 
 	std::vector<TileData> data_cache_vec;
 
+	void CreateAutotileCache();
+
+	/**
+	 * Draws a single tile.
+	 *
+	 * @return opacity of the drawn tile, Transparent when nothing was drawn
+	 */
+	ImageOpacity DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab);
+	bool IsAnimatedTile(const TileData& tile) const;
+
+	/** Draws the visible tiles one by one */
+	void DrawTiles(Bitmap& dst, uint8_t z_order, int div_ox, int div_oy, int mod_ox, int mod_oy, int tiles_x, int tiles_y, int animation_step_c, int animation_step_ab);
+	/** Draws the visible tiles from the pre-rendered chunks */
+	void DrawChunks(Bitmap& dst, uint8_t z_order, int div_ox, int div_oy, int mod_ox, int mod_oy, int tiles_x, int tiles_y, int animation_step_c, int animation_step_ab);
+
+	/** Width and height of a chunk in tiles */
+	static constexpr int CHUNK_SIZE = 16;
+	/** Chunks that were not drawn for this amount of draw calls are released */
+	static constexpr uint32_t CHUNK_LIFETIME = 120;
+
+	/**
+	 * A block of CHUNK_SIZE * CHUNK_SIZE tiles of one sublayer that is rendered
+	 * into a bitmap. The bitmap is rendered again when a tile changes or the
+	 * animation step of an animated tile in the chunk changes.
+	 */
+	struct TileChunk {
+		/** Rendered tiles, nullptr when the chunk contains no tile of the sublayer */
+		BitmapRef bitmap;
+		/** Animation steps of block A, B and C the chunk was rendered with */
+		uint32_t animation_key = 0;
+		/** Value of draw_count when the chunk was drawn, 0 when not in used_chunks */
+		uint32_t last_used = 0;
+		bool valid = false;
+		/** Chunk contains tiles of block A, B or C */
+		bool animated = false;
+		/** All tiles are opaque */
+		bool opaque = false;
+		/** Every tile of the chunk was drawn */
+		bool covered = false;
+	};
+
+	void RenderChunk(TileChunk& chunk, uint8_t z_order, int chunk_x, int chunk_y, int animation_step_c, int animation_step_ab);
+	TileChunk& GetChunk(int sublayer, int chunk_x, int chunk_y);
+	int GetChunksX() const;
+	int GetChunksY() const;
+	/** Releases all chunks */
+	void InvalidateChunks();
+	/** Renders the chunks containing the tile again when they are drawn next time */
+	void InvalidateChunkAt(int x, int y);
+
+	/** Chunks of both sublayers, ordered by sublayer, row and column */
+	std::vector<TileChunk> chunks;
+	/** Chunks that have a bitmap */
+	std::vector<TileChunk*> used_chunks;
+	uint32_t draw_count = 0;
+	/** Frame of the last tone change, chunks are not used while the tone changes */
+	uint32_t tone_change_frame = std::numeric_limits<uint32_t>::max();
+
 	TilemapSubLayer lower_layer;
 	TilemapSubLayer upper_layer;
 
@@ -265,6 +324,18 @@ inline TilemapLayer::TileData& TilemapLayer::GetDataCache(int x, int y) {
 	return data_cache_vec[x + y * width];
 }
 
+inline int TilemapLayer::GetChunksX() const {
+	return (width + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+inline int TilemapLayer::GetChunksY() const {
+	return (height + CHUNK_SIZE - 1) / CHUNK_SIZE;
+}
+
+inline TilemapLayer::TileChunk& TilemapLayer::GetChunk(int sublayer, int chunk_x, int chunk_y) {
+	return chunks[(sublayer * GetChunksY() + chunk_y) * GetChunksX() + chunk_x];
+}
+
 inline bool TilemapLayer::IsInMapBounds(int x, int y) const {
 	return x >= 0 && x < width && y >= 0 && y < height;
 }
@@ -185,6 +185,12 @@ void Transition::SetAttributesTransitions() {
 	}
 }
 
+bool Transition::GetDamage(DamageInfo& info) const {
+	// A running transition covers the whole screen and is not tracked
+	info.rect = {};
+	return !IsActive();
+}
+
 void Transition::Draw(Bitmap& dst) {
 	if (!IsActive())
 		return;
@@ -108,6 +108,7 @@ public:
 	void PrependFlashes(int r, int g, int b, int power, int duration, int iterations);
 
 	void Draw(Bitmap& dst) override;
+	bool GetDamage(DamageInfo& info) const override;
 	void Update();
 
 	bool IsActive() const;
@@ -192,6 +192,55 @@ void Window::Draw(Bitmap& dst) {
 	}
 }
 
+bool Window::GetDamage(DamageInfo& info) const {
+	info.rect = {};
+	if (width <= 0 || height <= 0) {
+		return true;
+	}
+
+	info.rect = { x, y, width, height };
+
+	const bool cursor_visible = windowskin && width >= 16 && height > 16 && cursor_rect.width > 4 && cursor_rect.height > 4 && animation_frames == 0;
+	if (cursor_visible) {
+		// The cursor can extend past the window border
+		info.rect.Merge({
+			x + cursor_rect.x + border_x,
+			y + cursor_rect.y + border_y,
+			min(cursor_rect.width, width - cursor_rect.x + border_x),
+			min(cursor_rect.height, height - cursor_rect.y + border_y)
+		});
+	}
+
+	info.Hash(windowskin.get());
+	info.Hash(windowskin ? windowskin->GetRevision() : 0);
+	info.Hash(contents.get());
+	info.Hash(contents ? contents->GetRevision() : 0);
+	info.Hash(stretch);
+	info.Hash(cursor_rect);
+	info.Hash(cursor_visible && cursor_frame <= 10);
+	info.Hash(pause);
+	info.Hash(up_arrow);
+	info.Hash(down_arrow);
+	info.Hash(left_arrow);
+	info.Hash(right_arrow);
+	info.Hash(animate_arrows);
+	info.Hash(arrow_animation_frame < arrow_animation_frames);
+	info.Hash(info.rect);
+	info.Hash(ox);
+	info.Hash(oy);
+	info.Hash(border_x);
+	info.Hash(border_y);
+	info.Hash(opacity);
+	info.Hash(frame_opacity);
+	info.Hash(back_opacity);
+	info.Hash(contents_opacity);
+	info.Hash(background_alpha);
+	info.Hash(animation_frames);
+	info.Hash(static_cast<int>(animation_count));
+
+	return true;
+}
+
 void Window::RefreshBackground() {
 	background_needs_refresh = false;
 
@@ -16,23 +16,49 @@
  */
 
 // Headers
+#include <algorithm>
 #include "window_gamelist.h"
 #include "filefinder.h"
+#include "filesystem_native.h"
 #include "bitmap.h"
 #include "font.h"
+#include "instrumentation.h"
 #include "system.h"
+#include "worker_pool.h"
+
+namespace {
+	WorkerPool& GetDetectionPool() {
+		// Detection is mostly waiting for file IO, archives are parsed in parallel
+		static WorkerPool pool(WorkerPool::GetDefaultNumThreads());
+		return pool;
+	}
+
+	ProjectTypeCache& GetProjectTypeCache() {
+		static ProjectTypeCache cache = []() {
+			ProjectTypeCache c;
+			c.Load();
+			return c;
+		}();
+		return cache;
+	}
+}
 
 Window_GameList::Window_GameList(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
 	column_max = 1;
 }
 
+Window_GameList::~Window_GameList() {
+	CancelDetection();
+}
+
 bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot) {
 	base_fs = filesystem_base;
 	if (!base_fs) {
 		return false;
 	}
 
+	CancelDetection();
 	game_entries.clear();
 
 	this->show_dotdot = show_dotdot;
@@ -65,22 +91,10 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		}
 		if (dir.second.type == DirectoryTree::FileType::Regular) {
 			if (FileFinder::IsSupportedArchiveExtension(dir.second.name)) {
-				// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
-				// A platform is considered "fast" when it does not require our custom IO buffer
-#ifndef USE_CUSTOM_FILEBUF
-				auto fs = base_fs.Create(dir.second.name);
-				game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 				game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 			}
 		} else if (dir.second.type == DirectoryTree::FileType::Directory) {
-#ifndef USE_CUSTOM_FILEBUF
-			auto fs = base_fs.Create(dir.second.name);
-			game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 			game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 		}
 	}
 
@@ -95,6 +109,12 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		game_entries.insert(game_entries.begin(), { "..", FileFinder::ProjectType::Unknown });
 	}
 
+	// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
+	// A platform is considered "fast" when it does not require our custom IO buffer
+#ifndef USE_CUSTOM_FILEBUF
+	DetectProjectTypes();
+#endif
+
 	if (HasValidEntry()) {
 		item_max = game_entries.size();
 
@@ -121,6 +141,84 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 	return true;
 }
 
+void Window_GameList::Update() {
+	Window_Selectable::Update();
+
+	if (pending_detections.empty()) {
+		return;
+	}
+
+	auto& cache = GetProjectTypeCache();
+	for (auto it = pending_detections.begin(); it != pending_detections.end();) {
+		if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+			++it;
+			continue;
+		}
+
+		auto type = it->result.get();
+		cache.Set(it->key, type);
+		game_entries[it->index].type = type;
+		size_t index = it->index;
+		it = pending_detections.erase(it);
+		if (HasValidEntry()) {
+			DrawItem(index);
+		}
+	}
+
+	if (pending_detections.empty() && cache.IsModified()) {
+		cache.Save();
+	}
+}
+
+void Window_GameList::DetectProjectTypes() {
+	EP_INSTRUMENT_ZONE("Window_GameList::DetectProjectTypes");
+
+	// Workers need an own filesystem instance because the directory cache of
+	// base_fs is not thread-safe. This is only possible for the host filesystem,
+	// entries inside archives are detected here.
+	bool is_native = dynamic_cast<const NativeFilesystem*>(&base_fs.GetOwner()) != nullptr;
+	std::string base_path = base_fs.GetFullPath();
+
+	auto& cache = GetProjectTypeCache();
+	auto& pool = GetDetectionPool();
+	detection_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+	for (size_t i = show_dotdot ? 1 : 0; i < game_entries.size(); ++i) {
+		auto& ge = game_entries[i];
+
+		if (!is_native) {
+			auto fs = base_fs.Create(ge.dir_name);
+			ge.type = fs ? FileFinder::GetProjectType(fs) : FileFinder::ProjectType::Unknown;
+			continue;
+		}
+
+		auto key = ProjectTypeCache::MakeKey(FileFinder::MakePath(base_path, ge.dir_name));
+		if (cache.Find(key, ge.type)) {
+			continue;
+		}
+
+		auto task = std::make_shared<std::packaged_task<FileFinder::ProjectType()>>([path = key.path, cancelled = detection_cancelled]() {
+			if (*cancelled) {
+				return FileFinder::ProjectType::Unknown;
+			}
+
+			auto native_fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+			auto fs = native_fs->Create(path);
+			return fs ? FileFinder::GetProjectType(fs) : FileFinder::ProjectType::Unknown;
+		});
+
+		pending_detections.push_back({ i, std::move(key), task->get_future() });
+		pool.Submit([task]() { (*task)(); });
+	}
+}
+
+void Window_GameList::CancelDetection() {
+	if (detection_cancelled) {
+		*detection_cancelled = true;
+	}
+	pending_detections.clear();
+}
+
 void Window_GameList::DrawItem(int index) {
 	Rect rect = GetItemRect(index);
 	contents->ClearRect(rect);
@@ -128,8 +226,14 @@ void Window_GameList::DrawItem(int index) {
 	auto& ge = game_entries[index];
 
 #ifndef USE_CUSTOM_FILEBUF
+	bool is_pending = std::any_of(pending_detections.begin(), pending_detections.end(), [&](const auto& pd) {
+		return pd.index == static_cast<size_t>(index);
+	});
+
 	auto color = Font::ColorDefault;
-	if (ge.type == FileFinder::ProjectType::Unknown) {
+	if (is_pending) {
+		color = Font::ColorDisabled;
+	} else if (ge.type == FileFinder::ProjectType::Unknown) {
 		color = Font::ColorHeal;
 	} else if (ge.type > FileFinder::ProjectType::Supported) {
 		color = Font::ColorKnockout;
@@ -19,9 +19,13 @@
 #define EP_WINDOW_GAMELIST_H
 
 // Headers
+#include <atomic>
+#include <future>
+#include <memory>
 #include <vector>
 #include "window_selectable.h"
 #include "filefinder.h"
+#include "project_type_cache.h"
 
 /**
  * Window_GameList class.
@@ -34,11 +38,21 @@ public:
 	 */
 	Window_GameList(int ix, int iy, int iwidth, int iheight);
 
+	/** Cancels the project type detection that did not start yet */
+	~Window_GameList() override;
+
 	/**
 	 * Refreshes the game list.
+	 * The project types are detected in the background, entries are redrawn
+	 * when their type is known.
 	 */
 	bool Refresh(FilesystemView filesystem_base, bool show_dotdot);
 
+	/**
+	 * Updates the window and applies the detected project types.
+	 */
+	void Update() override;
+
 	/**
 	 * Draws an item together with the quantity.
 	 *
@@ -59,8 +73,22 @@ public:
 	FileFinder::FsEntry GetFilesystemEntry() const;
 
 private:
+	/** Detects the project types, from the cache or on worker threads */
+	void DetectProjectTypes();
+
+	/** Stops waiting for the detection results of the previous directory */
+	void CancelDetection();
+
+	struct PendingDetection {
+		size_t index;
+		ProjectTypeCache::Key key;
+		std::future<FileFinder::ProjectType> result;
+	};
+
 	FilesystemView base_fs;
 	std::vector<FileFinder::GameEntry> game_entries;
+	std::vector<PendingDetection> pending_detections;
+	std::shared_ptr<std::atomic<bool>> detection_cancelled;
 
 	bool show_dotdot = false;
 };
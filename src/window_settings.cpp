@@ -29,6 +29,7 @@
 #include "output.h"
 #include "baseui.h"
 #include "bitmap.h"
+#include "cache.h"
 #include "player.h"
 #include "system.h"
 #include "audio.h"
@@ -452,6 +453,10 @@ void Window_Settings::RefreshEngine() {
 		GetFrame().options.back().help2 = fmt::format("Sample name: {}", fmt_sample_name(true));
 	}
 	AddOption(cfg.automatic_screenshots_interval, [this, &cfg]() { cfg.automatic_screenshots_interval.Set(GetCurrentOption().current_value); });
+	AddOption(cfg.image_cache_size, [this, &cfg]() {
+		cfg.image_cache_size.Set(GetCurrentOption().current_value);
+		Cache::SetMemoryBudget(static_cast<size_t>(cfg.image_cache_size.Get()) * 1024 * 1024);
+	});
 }
 
 void Window_Settings::RefreshEngineFont(bool mincho) {
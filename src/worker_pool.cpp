@@ -0,0 +1,82 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "worker_pool.h"
+#include "output.h"
+#include <algorithm>
+
+WorkerPool::WorkerPool(int num_threads) {
+	for (int i = 0; i < num_threads; ++i) {
+		threads.emplace_back(&WorkerPool::ThreadFunction, this);
+	}
+}
+
+WorkerPool::~WorkerPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+	}
+	cv.notify_all();
+
+	for (auto& thread: threads) {
+		thread.join();
+	}
+}
+
+void WorkerPool::Submit(Task task) {
+	if (threads.empty()) {
+		task();
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		tasks.push_back(std::move(task));
+	}
+	cv.notify_one();
+}
+
+int WorkerPool::GetDefaultNumThreads() {
+#if defined(EMSCRIPTEN) || defined(PSP) || defined(__3DS__) || defined(__wii__)
+	// No threads or too few cores to gain anything
+	return 0;
+#else
+	// Keep one core for the main thread and one for audio
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	return std::clamp(cores - 2, 1, 4);
+#endif
+}
+
+void WorkerPool::ThreadFunction() {
+	Output::DeferThreadMessages();
+
+	for (;;) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this]() { return quit || !tasks.empty(); });
+			if (tasks.empty()) {
+				// quit is only honoured after the queue is drained
+				return;
+			}
+			task = std::move(tasks.front());
+			tasks.pop_front();
+		}
+		task();
+	}
+}
@@ -0,0 +1,83 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_WORKER_POOL_H
+#define EP_WORKER_POOL_H
+
+// Headers
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A fixed amount of threads processing tasks in submission order.
+ *
+ * Tasks must not touch state that is owned by the main thread.
+ * With zero threads the tasks run immediately in Submit, this is used on
+ * platforms without thread support.
+ */
+class WorkerPool {
+public:
+	using Task = std::function<void()>;
+
+	/**
+	 * Starts the worker threads.
+	 *
+	 * @param num_threads amount of threads, 0 runs the tasks synchronously
+	 */
+	explicit WorkerPool(int num_threads);
+
+	/** Finishes the queued tasks and joins the threads */
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	/**
+	 * Queues a task.
+	 *
+	 * @param task task to run on a worker thread
+	 */
+	void Submit(Task task);
+
+	/** @return amount of worker threads */
+	int GetNumThreads() const;
+
+	/**
+	 * @return recommended amount of threads for background work on this
+	 * system, 0 when threads are not supported
+	 */
+	static int GetDefaultNumThreads();
+
+private:
+	void ThreadFunction();
+
+	std::vector<std::thread> threads;
+	std::deque<Task> tasks;
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool quit = false;
+};
+
+inline int WorkerPool::GetNumThreads() const {
+	return static_cast<int>(threads.size());
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include "audio_decoder_prefetch.h"
+#include "doctest.h"
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+TEST_SUITE_BEGIN("AudioDecoderPrefetch");
+
+namespace {
+
+// Writes increasing 32 bit counters, the position is the counter of the next frame
+class CountingDecoder : public AudioDecoder {
+public:
+	explicit CountingDecoder(uint32_t length) : length(length) {}
+
+	bool Open(Filesystem_Stream::InputStream) override { return true; }
+	bool IsFinished() const override { return counter >= length; }
+	void GetFormat(int& frequency, Format& format, int& channels) const override {
+		frequency = 44100;
+		format = Format::S32;
+		channels = 1;
+	}
+	bool Seek(std::streamoff offset, std::ios_base::seekdir origin) override {
+		if (origin != std::ios_base::beg) {
+			return false;
+		}
+		counter = static_cast<uint32_t>(offset);
+		return true;
+	}
+	std::streampos Tell() const override { return counter; }
+	int GetTicks() const override { return static_cast<int>(counter / 100); }
+
+private:
+	int FillBuffer(uint8_t* buffer, int size) override {
+		int frames = 0;
+		for (; frames < size / 4 && counter < length; ++frames) {
+			memcpy(buffer + frames * 4, &counter, 4);
+			++counter;
+		}
+		return frames * 4;
+	}
+
+	uint32_t counter = 0;
+	uint32_t length;
+};
+
+std::vector<uint32_t> Read(AudioDecoderBase& decoder, int frames) {
+	std::vector<uint32_t> result(frames);
+	int read = decoder.Decode(reinterpret_cast<uint8_t*>(result.data()), frames * 4);
+	result.resize(read / 4);
+	return result;
+}
+
+}
+
+TEST_CASE("Sequence") {
+	AudioPrefetchThread thread;
+	AudioDecoderPrefetch decoder(std::make_unique<CountingDecoder>(100000), thread);
+	REQUIRE(decoder.Open(Filesystem_Stream::InputStream()));
+
+	uint32_t expected = 0;
+	while (!decoder.IsFinished()) {
+		auto frames = Read(decoder, 1000);
+		for (auto frame: frames) {
+			REQUIRE_EQ(frame, expected);
+			++expected;
+		}
+	}
+	REQUIRE_EQ(expected, 100000);
+	CHECK_EQ(decoder.GetLoopCount(), 0);
+}
+
+TEST_CASE("Looping") {
+	AudioPrefetchThread thread;
+	AudioDecoderPrefetch decoder(std::make_unique<CountingDecoder>(5000), thread);
+	REQUIRE(decoder.Open(Filesystem_Stream::InputStream()));
+	decoder.SetLooping(true);
+	CHECK(decoder.GetLooping());
+
+	for (int i = 0; i < 20; ++i) {
+		auto frames = Read(decoder, 1000);
+		REQUIRE_EQ(frames.size(), 1000);
+		REQUIRE_EQ(frames[0], (i * 1000) % 5000);
+		REQUIRE_EQ(frames[999], (i * 1000 + 999) % 5000);
+	}
+	CHECK_FALSE(decoder.IsFinished());
+	CHECK_GE(decoder.GetLoopCount(), 3);
+}
+
+TEST_CASE("Seek") {
+	AudioPrefetchThread thread;
+	AudioDecoderPrefetch decoder(std::make_unique<CountingDecoder>(100000), thread);
+	REQUIRE(decoder.Open(Filesystem_Stream::InputStream()));
+
+	Read(decoder, 1000);
+	// The position is the one of the played data, not of the decoded data
+	CHECK_EQ(decoder.Tell(), 1000);
+
+	// Half of the first block, the ticks are interpolated as well
+	Read(decoder, 1048);
+	CHECK_EQ(decoder.Tell(), 2048);
+	CHECK_EQ(decoder.GetTicks(), 20);
+
+	REQUIRE(decoder.Seek(50000, std::ios_base::beg));
+	CHECK_EQ(decoder.Tell(), 50000);
+	CHECK_EQ(decoder.GetTicks(), 500);
+
+	auto frames = Read(decoder, 10);
+	REQUIRE_EQ(frames[0], 50000);
+	REQUIRE_EQ(frames[9], 50009);
+}
+
+TEST_CASE("Underruns") {
+	AudioPrefetchThread thread;
+	{
+		AudioDecoderPrefetch decoder(std::make_unique<CountingDecoder>(1000000), thread);
+		REQUIRE(decoder.Open(Filesystem_Stream::InputStream()));
+
+		// Consumes faster than one decoding round, data must stay continuous
+		uint32_t expected = 0;
+		for (int i = 0; i < 100; ++i) {
+			auto frames = Read(decoder, 8000);
+			REQUIRE_EQ(frames.front(), expected);
+			REQUIRE_EQ(frames.back(), expected + 7999);
+			expected += 8000;
+		}
+		CHECK_EQ(decoder.GetUnderruns(), thread.GetUnderruns());
+	}
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,131 @@
+#include "audio_mixer.h"
+#include "doctest.h"
+#include <cstdint>
+#include <vector>
+
+using Format = AudioDecoderBase::Format;
+
+TEST_SUITE_BEGIN("AudioMixer");
+
+TEST_CASE("ToFloatSigned") {
+	// More values than one vector to cover the scalar tail
+	std::vector<int16_t> s16 = { 0, 16384, -16384, -32768, 32767, 0, 0, 0, 8192, -8192 };
+	std::vector<float> out(s16.size());
+	AudioMixer::ToFloat(out.data(), s16.data(), Format::S16, s16.size());
+	CHECK_EQ(out[0], 0.0f);
+	CHECK_EQ(out[1], 0.5f);
+	CHECK_EQ(out[2], -0.5f);
+	CHECK_EQ(out[3], -1.0f);
+	CHECK_EQ(out[8], 0.25f);
+	CHECK_EQ(out[9], -0.25f);
+
+	std::vector<int8_t> s8(20, 64);
+	s8[19] = -128;
+	out.resize(s8.size());
+	AudioMixer::ToFloat(out.data(), s8.data(), Format::S8, s8.size());
+	CHECK_EQ(out[0], 0.5f);
+	CHECK_EQ(out[15], 0.5f);
+	CHECK_EQ(out[18], 0.5f);
+	CHECK_EQ(out[19], -1.0f);
+
+	std::vector<int32_t> s32 = { 1 << 30, -(1 << 30), 0, INT32_MIN, 1 << 29 };
+	out.resize(s32.size());
+	AudioMixer::ToFloat(out.data(), s32.data(), Format::S32, s32.size());
+	CHECK_EQ(out[0], 0.5f);
+	CHECK_EQ(out[1], -0.5f);
+	CHECK_EQ(out[3], -1.0f);
+	CHECK_EQ(out[4], 0.25f);
+}
+
+TEST_CASE("ToFloatUnsigned") {
+	std::vector<uint8_t> u8(17, 192);
+	u8[0] = 0;
+	u8[16] = 128;
+	std::vector<float> out(u8.size());
+	AudioMixer::ToFloat(out.data(), u8.data(), Format::U8, u8.size());
+	CHECK_EQ(out[0], -1.0f);
+	CHECK_EQ(out[1], 0.5f);
+	CHECK_EQ(out[16], 0.0f);
+
+	std::vector<uint16_t> u16 = { 0, 32768, 49152, 16384, 0, 0, 0, 0, 49152 };
+	out.resize(u16.size());
+	AudioMixer::ToFloat(out.data(), u16.data(), Format::U16, u16.size());
+	CHECK_EQ(out[0], -1.0f);
+	CHECK_EQ(out[1], 0.0f);
+	CHECK_EQ(out[2], 0.5f);
+	CHECK_EQ(out[3], -0.5f);
+	CHECK_EQ(out[8], 0.5f);
+
+	std::vector<uint32_t> u32 = { 0, 0x80000000u, 0xC0000000u, 0x40000000u, 0xC0000000u };
+	out.resize(u32.size());
+	AudioMixer::ToFloat(out.data(), u32.data(), Format::U32, u32.size());
+	CHECK_EQ(out[0], -1.0f);
+	CHECK_EQ(out[1], 0.0f);
+	CHECK_EQ(out[2], 0.5f);
+	CHECK_EQ(out[3], -0.5f);
+	CHECK_EQ(out[4], 0.5f);
+}
+
+TEST_CASE("MixStereo") {
+	std::vector<float> src = { 1.0f, 0.5f, 1.0f, 0.5f, 1.0f, 0.5f };
+	std::vector<float> dst = { 0.25f, 0.25f, 0.25f, 0.25f, 0.25f, 0.25f };
+	AudioMixer::MixStereo(dst.data(), src.data(), 3, 2, { 0.5f, 1.0f }, { 0.5f, 1.0f });
+	for (int i = 0; i < 3; ++i) {
+		CHECK_EQ(dst[i * 2], 0.75f);
+		CHECK_EQ(dst[i * 2 + 1], 0.75f);
+	}
+}
+
+TEST_CASE("MixMono") {
+	std::vector<float> src(5, 0.5f);
+	std::vector<float> dst(10, 0.0f);
+	AudioMixer::MixStereo(dst.data(), src.data(), 5, 1, { 1.0f, 0.5f }, { 1.0f, 0.5f });
+	for (int i = 0; i < 5; ++i) {
+		CHECK_EQ(dst[i * 2], 0.5f);
+		CHECK_EQ(dst[i * 2 + 1], 0.25f);
+	}
+}
+
+TEST_CASE("MixRamp") {
+	std::vector<float> src(8, 1.0f);
+	std::vector<float> dst(8, 0.0f);
+	AudioMixer::MixStereo(dst.data(), src.data(), 4, 2, { 0.0f, 1.0f }, { 1.0f, 0.0f });
+	CHECK_EQ(dst[0], doctest::Approx(0.0f));
+	CHECK_EQ(dst[1], doctest::Approx(1.0f));
+	CHECK_EQ(dst[2], doctest::Approx(0.25f));
+	CHECK_EQ(dst[3], doctest::Approx(0.75f));
+	CHECK_EQ(dst[6], doctest::Approx(0.75f));
+	CHECK_EQ(dst[7], doctest::Approx(0.25f));
+}
+
+TEST_CASE("ToS16") {
+	std::vector<float> src = { 0.0f, 0.5f, -0.5f, -1.0f, 1.0f, 2.0f, -2.0f, 0.25f, -0.25f };
+	std::vector<int16_t> out(src.size());
+	AudioMixer::ToS16(out.data(), src.data(), src.size(), 1.0f);
+	CHECK_EQ(out[0], 0);
+	CHECK_EQ(out[1], 16384);
+	CHECK_EQ(out[2], -16384);
+	CHECK_EQ(out[3], -32768);
+	// Saturates instead of wrapping around
+	CHECK_EQ(out[4], 32767);
+	CHECK_EQ(out[5], 32767);
+	CHECK_EQ(out[6], -32768);
+	CHECK_EQ(out[7], 8192);
+	CHECK_EQ(out[8], -8192);
+}
+
+TEST_CASE("ToS16Compression") {
+	std::vector<float> src = { 0.5f, 2.0f, -2.0f, 1.4f, 0.5f, 2.0f, -2.0f, 1.4f, -1.4f };
+	std::vector<int16_t> out(src.size());
+	AudioMixer::ToS16(out.data(), src.data(), src.size(), 2.0f);
+	for (int i = 0; i < 8; i += 4) {
+		// Below the threshold the samples are unchanged, the peak is mapped to 1.0
+		CHECK_EQ(out[i], 16384);
+		CHECK_EQ(out[i + 1], 32767);
+		CHECK_EQ(out[i + 2], -32768);
+		CHECK_EQ(out[i + 3], 29491);
+	}
+	CHECK_EQ(out[8], -29491);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,127 @@
+#include "bitmap_kernels.h"
+#include "bitmap_hslrgb.h"
+#include "doctest.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+TEST_SUITE_BEGIN("BitmapKernels");
+
+namespace {
+
+// Channel layouts of the 32 bit formats and one the kernels are not specialized for
+const BitmapKernels::ChannelShifts layouts[] = {
+	{ 16, 8, 0, 24 },
+	{ 0, 8, 16, 24 },
+	{ 24, 16, 8, 0 },
+	{ 8, 16, 24, 0 },
+	{ 24, 0, 8, 16 }
+};
+
+const ImageOpacity opacities[] = { ImageOpacity::Opaque, ImageOpacity::Alpha_1Bit, ImageOpacity::Alpha_8Bit };
+
+std::vector<uint32_t> RandomPixels(int count) {
+	std::mt19937 rng(1234);
+	std::vector<uint32_t> pixels(count);
+	for (auto& p: pixels) {
+		p = rng();
+	}
+	// Transparent pixels
+	for (int i = 0; i < count; i += 7) {
+		pixels[i] &= 0xFFFFFF;
+		pixels[i + 1] &= 0xFFFFFF00;
+	}
+	return pixels;
+}
+
+}
+
+TEST_CASE("ToneTable") {
+	const BitmapKernels::ToneTable identity(Tone(128, 128, 128, 128));
+	CHECK_FALSE(identity.apply_sat);
+	CHECK_FALSE(identity.apply_color);
+
+	const BitmapKernels::ToneTable table(Tone(0, 128, 255, 0));
+	CHECK(table.apply_sat);
+	CHECK(table.apply_color);
+	CHECK_EQ(table.saturation, 0);
+	CHECK_EQ(table.hard_light[0][200], 0);
+	CHECK_EQ(table.hard_light[1][200], 200);
+	CHECK_EQ(table.hard_light[1][255], 255);
+	CHECK_EQ(table.hard_light[2][10], 255);
+}
+
+TEST_CASE("ToneMatchesScalar") {
+	const Tone tones[] = {
+		Tone(255, 255, 255, 128),
+		Tone(0, 64, 200, 128),
+		Tone(128, 128, 128, 0),
+		Tone(128, 128, 128, 255),
+		Tone(30, 128, 220, 60),
+		Tone(255, 0, 129, 200)
+	};
+
+	// Width is not a multiple of the vector size to cover the scalar tail
+	const int width = 37;
+	const int height = 5;
+	const int stride = 40;
+	const auto source = RandomPixels(stride * height);
+
+	for (const auto& tone: tones) {
+		const BitmapKernels::ToneTable table(tone);
+		for (const auto& shifts: layouts) {
+			for (auto opacity: opacities) {
+				auto expected = source;
+				auto pixels = source;
+				BitmapKernels::ApplyToneScalar(expected.data(), stride, width, height, table, opacity, shifts);
+				BitmapKernels::ApplyTone(pixels.data(), stride, width, height, table, opacity, shifts);
+				REQUIRE_EQ(pixels, expected);
+			}
+		}
+	}
+}
+
+TEST_CASE("ToneOpacity") {
+	const BitmapKernels::ToneTable table(Tone(255, 255, 255, 128));
+	const BitmapKernels::ChannelShifts shifts = { 0, 8, 16, 24 };
+
+	// transparent, half transparent, opaque
+	std::vector<uint32_t> pixels = { 0x00102030, 0x80102030, 0xFF102030 };
+
+	auto opaque = pixels;
+	BitmapKernels::ApplyTone(opaque.data(), 3, 3, 1, table, ImageOpacity::Opaque, shifts);
+	CHECK_EQ(opaque[0], 0x00FFFFFF);
+
+	auto alpha = pixels;
+	BitmapKernels::ApplyTone(alpha.data(), 3, 3, 1, table, ImageOpacity::Alpha_8Bit, shifts);
+	CHECK_EQ(alpha[0], pixels[0]);
+	CHECK_EQ(alpha[1], 0x80808080);
+	CHECK_EQ(alpha[2], 0xFFFFFFFF);
+}
+
+TEST_CASE("Hue") {
+	auto pixels = RandomPixels(300);
+	// Repeated colors are served from the cache
+	for (int i = 0; i < 100; ++i) {
+		pixels[200 + i] = pixels[i] | 0xFF;
+	}
+
+	for (int hue: { 0, 0x100, 0x333, 0x5FF }) {
+		auto result = pixels;
+		BitmapKernels::ApplyHue(result.data(), static_cast<int>(result.size()), hue);
+
+		for (size_t i = 0; i < pixels.size(); ++i) {
+			uint32_t expected = pixels[i];
+			if ((expected & 0xFF) != 0) {
+				uint8_t r = expected >> 24;
+				uint8_t g = expected >> 16;
+				uint8_t b = expected >> 8;
+				RGB_adjust_HSL(r, g, b, hue);
+				expected = ((uint32_t)r << 24) | ((uint32_t)g << 16) | ((uint32_t)b << 8) | (expected & 0xFF);
+			}
+			REQUIRE_EQ(result[i], expected);
+		}
+	}
+}
+
+TEST_SUITE_END();
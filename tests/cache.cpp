@@ -0,0 +1,137 @@
+#include "cache.h"
+#include "bitmap.h"
+#include "filefinder.h"
+#include "game_clock.h"
+#include "doctest.h"
+
+using namespace std::chrono_literals;
+
+TEST_SUITE_BEGIN("Cache");
+
+namespace {
+
+// Missing pictures are replaced by a checkerboard of the same size
+struct CacheFixture {
+	CacheFixture() {
+		FileFinder::SetGameFilesystem(FileFinder::Root().Create(EP_TEST_PATH "/game"));
+		Cache::ClearAll();
+		Cache::ResetStats();
+		Game_Clock::ResetFrame(now);
+
+		picture_size = Cache::Picture("size", true)->GetSize();
+		Cache::Clear();
+		Cache::ResetStats();
+	}
+
+	~CacheFixture() {
+		Cache::ClearAll();
+		Cache::ResetStats();
+		Cache::SetMemoryBudget(10 * 1024 * 1024);
+		FileFinder::SetGameFilesystem({});
+	}
+
+	void Advance(Game_Clock::duration d) {
+		now += d;
+		Game_Clock::ResetFrame(now);
+	}
+
+	Game_Clock::time_point now = Game_Clock::now();
+	size_t picture_size = 0;
+};
+
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "Hits") {
+	auto a = Cache::Picture("a", true);
+	CHECK_EQ(Cache::Picture("a", true), a);
+
+	auto stats = Cache::GetStats();
+	CHECK_EQ(stats.misses, 1);
+	CHECK_EQ(stats.hits, 1);
+	CHECK_EQ(stats.entries, 1);
+	CHECK_EQ(stats.size, picture_size);
+
+	// Transparency is part of the key
+	CHECK_NE(Cache::Picture("a", false), a);
+	CHECK_EQ(Cache::GetStats().entries, 2);
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "EvictsLeastRecentlyUsed") {
+	Cache::SetMemoryBudget(3 * picture_size);
+
+	Cache::Picture("a", true);
+	Cache::Picture("b", true);
+	Cache::Picture("c", true);
+
+	// Moves "a" to the front of the list
+	Advance(1s);
+	Cache::Picture("a", true);
+
+	// Within the budget nothing newer than 3s is freed
+	Advance(1s);
+	Cache::Picture("d", true);
+	CHECK_EQ(Cache::GetStats().evictions, 0);
+	CHECK_EQ(Cache::GetStats().entries, 4);
+
+	// Over budget the least recently used bitmap is freed until it fits again
+	Advance(100ms);
+	Cache::Picture("e", true);
+	auto stats = Cache::GetStats();
+	CHECK_EQ(stats.evictions, 1);
+	CHECK_EQ(stats.entries, 4);
+
+	Cache::ResetStats();
+	Cache::Picture("a", true);
+	Cache::Picture("c", true);
+	CHECK_EQ(Cache::GetStats().hits, 2);
+	Cache::Picture("b", true);
+	CHECK_EQ(Cache::GetStats().misses, 1);
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "KeepsReferencedBitmaps") {
+	Cache::SetMemoryBudget(2 * picture_size);
+
+	auto a = Cache::Picture("a", true);
+	Cache::Picture("b", true);
+	Cache::Picture("c", true);
+
+	// "a" is in use and stays, "b" is freed
+	Advance(100ms);
+	Cache::Picture("d", true);
+	CHECK_EQ(Cache::GetStats().evictions, 1);
+
+	// Bitmaps in use keep their position, "a" is the oldest once released
+	a.reset();
+	Advance(100ms);
+	Cache::Picture("e", true);
+	CHECK_EQ(Cache::GetStats().evictions, 2);
+
+	Cache::ResetStats();
+	Cache::Picture("c", true);
+	Cache::Picture("d", true);
+	CHECK_EQ(Cache::GetStats().hits, 2);
+	Cache::Picture("a", true);
+	CHECK_EQ(Cache::GetStats().misses, 1);
+}
+
+TEST_CASE_FIXTURE(CacheFixture, "HashCollision") {
+	// Both names have the same 64 bit key as a picture
+	const char* first = "1f35qqmvAxN";
+	const char* second = "m32CmENVcJE";
+
+	auto a = Cache::Picture(first, true);
+	auto b = Cache::Picture(second, true);
+	CHECK_NE(a, b);
+
+	// The newer image replaces the colliding entry
+	auto stats = Cache::GetStats();
+	CHECK_EQ(stats.misses, 2);
+	CHECK_EQ(stats.entries, 1);
+	CHECK_EQ(stats.size, picture_size);
+
+	CHECK_EQ(Cache::Picture(second, true), b);
+	CHECK_NE(Cache::Picture(first, true), a);
+	CHECK_EQ(Cache::GetStats().misses, 3);
+}
+
+TEST_SUITE_END();
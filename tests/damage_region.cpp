@@ -0,0 +1,92 @@
+#include "damage_region.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("DamageRegion");
+
+static DamageRegion MakeRegion() {
+	DamageRegion region;
+	region.Reset({ 0, 0, 320, 240 });
+	return region;
+}
+
+TEST_CASE("Empty") {
+	auto region = MakeRegion();
+
+	REQUIRE(region.IsEmpty());
+	REQUIRE_FALSE(region.IsFull());
+	REQUIRE(region.GetRects().empty());
+}
+
+TEST_CASE("AddEmptyRect") {
+	auto region = MakeRegion();
+	region.Add({ 10, 10, 0, 5 });
+	region.Add({ 400, 10, 10, 10 });
+
+	REQUIRE(region.IsEmpty());
+}
+
+TEST_CASE("AddClipsToBounds") {
+	auto region = MakeRegion();
+	region.Add({ -10, -5, 20, 10 });
+
+	REQUIRE_EQ(region.GetRects().size(), 1);
+	REQUIRE_EQ(region.GetRects()[0], Rect(0, 0, 10, 5));
+}
+
+TEST_CASE("SeparateRects") {
+	auto region = MakeRegion();
+	region.Add({ 0, 0, 10, 10 });
+	region.Add({ 10, 0, 10, 10 });
+	region.Add({ 100, 100, 16, 16 });
+
+	REQUIRE_EQ(region.GetRects().size(), 3);
+	REQUIRE_FALSE(region.IsFull());
+}
+
+TEST_CASE("MergeOverlapping") {
+	auto region = MakeRegion();
+	region.Add({ 0, 0, 10, 10 });
+	region.Add({ 20, 0, 10, 10 });
+	// Overlaps both, the merged rect covers all three
+	region.Add({ 5, 5, 20, 2 });
+
+	REQUIRE_EQ(region.GetRects().size(), 1);
+	REQUIRE_EQ(region.GetRects()[0], Rect(0, 0, 30, 10));
+}
+
+TEST_CASE("TooManyRects") {
+	auto region = MakeRegion();
+	for (int i = 0; i <= DamageRegion::max_rects; ++i) {
+		region.Add({ i * 20, 0, 10, 10 });
+	}
+
+	REQUIRE_EQ(region.GetRects().size(), 1);
+	REQUIRE_EQ(region.GetRects()[0], Rect(0, 0, DamageRegion::max_rects * 20 + 10, 10));
+	REQUIRE_FALSE(region.IsFull());
+}
+
+TEST_CASE("LargeAreaIsFull") {
+	auto region = MakeRegion();
+	region.Add({ 0, 0, 320, 100 });
+	REQUIRE_FALSE(region.IsFull());
+
+	region.Add({ 0, 200, 320, 40 });
+	REQUIRE(region.IsFull());
+	REQUIRE_EQ(region.GetRects().size(), 1);
+	REQUIRE_EQ(region.GetRects()[0], Rect(0, 0, 320, 240));
+
+	region.Add({ 5, 5, 5, 5 });
+	REQUIRE_EQ(region.GetRects().size(), 1);
+}
+
+TEST_CASE("AddAllAndReset") {
+	auto region = MakeRegion();
+	region.AddAll();
+	REQUIRE(region.IsFull());
+
+	region.Reset({ 0, 0, 640, 480 });
+	REQUIRE(region.IsEmpty());
+	REQUIRE_FALSE(region.IsFull());
+}
+
+TEST_SUITE_END();
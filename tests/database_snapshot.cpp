@@ -0,0 +1,88 @@
+#include "database_snapshot.h"
+#include "string_view.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("DatabaseSnapshot");
+
+namespace {
+
+DatabaseSnapshot::Key MakeKey() {
+	DatabaseSnapshot::Key key;
+	key.ldb_crc = 0x12345678;
+	key.lmt_crc = 0x9ABCDEF0;
+	key.encoding = "932";
+	return key;
+}
+
+void MakeData(lcf::rpg::Database& db, lcf::rpg::TreeMap& treemap) {
+	db.system.ldb_id = 2003;
+	db.actors.resize(2);
+	db.actors[0].ID = 1;
+	db.actors[0].name = "Alex";
+	db.actors[1].ID = 2;
+	db.actors[1].name = "アレックス";
+	db.actors[1].initial_level = 42;
+
+	treemap.maps.resize(2);
+	treemap.maps[0].type = lcf::rpg::TreeMap::MapType_root;
+	treemap.maps[1].ID = 1;
+	treemap.maps[1].name = "Überwelt";
+	treemap.maps[1].type = lcf::rpg::TreeMap::MapType_map;
+}
+
+}
+
+TEST_CASE("RoundTrip") {
+	lcf::rpg::Database db;
+	lcf::rpg::TreeMap treemap;
+	MakeData(db, treemap);
+
+	auto key = MakeKey();
+	auto data = DatabaseSnapshot::Create(key, db, treemap);
+
+	lcf::rpg::Database loaded_db;
+	lcf::rpg::TreeMap loaded_treemap;
+	REQUIRE(DatabaseSnapshot::Parse(data, key, loaded_db, loaded_treemap));
+
+	REQUIRE_EQ(loaded_db.actors.size(), 2);
+	CHECK_EQ(ToString(loaded_db.actors[0].name), "Alex");
+	CHECK_EQ(ToString(loaded_db.actors[1].name), "アレックス");
+	CHECK_EQ(loaded_db.actors[1].initial_level, 42);
+	CHECK_EQ(loaded_db.system.ldb_id, 2003);
+
+	REQUIRE_EQ(loaded_treemap.maps.size(), 2);
+	CHECK_EQ(ToString(loaded_treemap.maps[1].name), "Überwelt");
+}
+
+TEST_CASE("Mismatch") {
+	lcf::rpg::Database db;
+	lcf::rpg::TreeMap treemap;
+	MakeData(db, treemap);
+
+	auto key = MakeKey();
+	auto data = DatabaseSnapshot::Create(key, db, treemap);
+
+	lcf::rpg::Database loaded_db;
+	lcf::rpg::TreeMap loaded_treemap;
+
+	auto other = key;
+	other.ldb_crc ^= 1;
+	CHECK_FALSE(DatabaseSnapshot::Parse(data, other, loaded_db, loaded_treemap));
+
+	other = key;
+	other.lmt_crc ^= 1;
+	CHECK_FALSE(DatabaseSnapshot::Parse(data, other, loaded_db, loaded_treemap));
+
+	other = key;
+	other.encoding = "1252";
+	CHECK_FALSE(DatabaseSnapshot::Parse(data, other, loaded_db, loaded_treemap));
+
+	// Truncated file
+	data.pop_back();
+	CHECK_FALSE(DatabaseSnapshot::Parse(data, key, loaded_db, loaded_treemap));
+
+	CHECK_FALSE(DatabaseSnapshot::Parse({}, key, loaded_db, loaded_treemap));
+	CHECK(loaded_db.actors.empty());
+}
+
+TEST_SUITE_END();
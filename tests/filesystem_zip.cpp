@@ -1,11 +1,32 @@
 #include "filesystem.h"
+#include "filesystem_stream.h"
 #include "filefinder.h"
 #include "main_data.h"
 #include "doctest.h"
 #include "player.h"
+#include <vector>
 
 #define ZIP_PATH EP_TEST_PATH "/filesystem/test.zip"
 #define ZIP_FOLDER_PATH EP_TEST_PATH "/filesystem/folder.zip"
+#define ZIP_STREAM_PATH EP_TEST_PATH "/filesystem/stream.zip"
+#define ZIP64_PATH EP_TEST_PATH "/filesystem/zip64.zip"
+
+// The files in stream.zip contain the byte sequence 0, 1, ..., 250, 0, 1, ...
+static bool CheckPattern(Filesystem_Stream::InputStream& is, std::streamoff pos, size_t len) {
+	is.clear();
+	is.seekg(pos);
+	std::vector<char> buf(len);
+	is.read(buf.data(), buf.size());
+	if (static_cast<size_t>(is.gcount()) != len) {
+		return false;
+	}
+	for (size_t i = 0; i < len; ++i) {
+		if (static_cast<uint8_t>(buf[i]) != (pos + i) % 251) {
+			return false;
+		}
+	}
+	return true;
+}
 
 TEST_SUITE_BEGIN("Filesystem ZIP");
 
@@ -60,6 +81,64 @@ TEST_CASE("File reading") {
 	CHECK(line_out == "lo");
 }
 
+TEST_CASE("File reading: Streamed deflate") {
+	auto fs = FileFinder::Root().Create(ZIP_STREAM_PATH);
+	constexpr std::streamoff size = 3 * 1024 * 1024;
+	CHECK(fs.GetFilesize("deflate") == size);
+
+	auto is = fs.OpenInputStream("deflate");
+	REQUIRE(is);
+	CHECK(is.GetSize() == size);
+
+	CHECK(CheckPattern(is, 0, 1000));
+	CHECK(CheckPattern(is, 2500000, 70000));
+	// Backwards
+	CHECK(CheckPattern(is, 1200000, 100));
+	CHECK(CheckPattern(is, 1199990, 10));
+
+	is.seekg(5, std::ios_base::cur);
+	CHECK(is.tellg() == 1200005);
+	CHECK(static_cast<uint8_t>(is.get()) == 1200005 % 251);
+
+	is.seekg(-10, std::ios_base::end);
+	std::vector<char> buf(20);
+	is.read(buf.data(), buf.size());
+	CHECK(is.gcount() == 10);
+	CHECK(is.eof());
+}
+
+TEST_CASE("File reading: Stored") {
+	auto fs = FileFinder::Root().Create(ZIP_STREAM_PATH);
+	auto is = fs.OpenInputStream("stored");
+	REQUIRE(is);
+	CHECK(is.GetSize() == 40000);
+
+	CHECK(CheckPattern(is, 0, 40000));
+	CHECK(CheckPattern(is, 30000, 5));
+	CHECK(CheckPattern(is, 12345, 20000));
+}
+
+TEST_CASE("Zip64") {
+	auto fs = FileFinder::Root().Create(ZIP64_PATH);
+	CHECK(fs.GetFilesize("deflate") == 3000);
+
+	auto is = fs.OpenInputStream("text");
+	REQUIRE(is);
+
+	std::string line_out;
+	CHECK(Utils::ReadLine(is, line_out));
+	CHECK(line_out == "hello");
+	CHECK(Utils::ReadLine(is, line_out));
+	CHECK(line_out == "world");
+
+	is = fs.OpenInputStream("deflate");
+	REQUIRE(is);
+	std::string data(3000, '\0');
+	is.read(data.data(), data.size());
+	CHECK(is.gcount() == 3000);
+	CHECK(data.substr(0, 6) == "abcabc");
+}
+
 TEST_CASE("File IO error") {
 	auto fs = FileFinder::Root().Create(ZIP_PATH);
 	CHECK(!fs.OpenInputStream("game"));
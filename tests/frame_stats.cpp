@@ -0,0 +1,57 @@
+#include "frame_stats.h"
+#include "doctest.h"
+
+using ms = std::chrono::milliseconds;
+
+TEST_SUITE_BEGIN("FrameStats");
+
+TEST_CASE("Empty") {
+	FrameStats stats;
+
+	REQUIRE_EQ(stats.GetFrames(), 0);
+
+	auto s = stats.GetUpdateSummary();
+	REQUIRE_EQ(s.min.count(), 0);
+	REQUIRE_EQ(s.max.count(), 0);
+	REQUIRE_EQ(s.total.count(), 0);
+}
+
+TEST_CASE("Summarize") {
+	std::vector<FrameStats::duration> times;
+	// 100 to 1 ms, unsorted
+	for (int i = 100; i > 0; --i) {
+		times.push_back(ms(i));
+	}
+
+	auto s = FrameStats::Summarize(times);
+	REQUIRE_EQ(s.min, ms(1));
+	REQUIRE_EQ(s.max, ms(100));
+	REQUIRE_EQ(s.total, ms(5050));
+	REQUIRE_EQ(s.mean, std::chrono::microseconds(50500));
+	REQUIRE_EQ(s.p50, ms(50));
+	REQUIRE_EQ(s.p95, ms(95));
+	REQUIRE_EQ(s.p99, ms(99));
+}
+
+TEST_CASE("SummarizeSingle") {
+	auto s = FrameStats::Summarize({ ms(7) });
+	REQUIRE_EQ(s.min, ms(7));
+	REQUIRE_EQ(s.p50, ms(7));
+	REQUIRE_EQ(s.p99, ms(7));
+	REQUIRE_EQ(s.max, ms(7));
+}
+
+TEST_CASE("UpdateAndDraw") {
+	FrameStats stats;
+	stats.Add(ms(2), ms(5));
+	stats.Add(ms(4), ms(1));
+
+	REQUIRE_EQ(stats.GetFrames(), 2);
+	REQUIRE_EQ(stats.GetUpdateSummary().total, ms(6));
+	REQUIRE_EQ(stats.GetDrawSummary().max, ms(5));
+	REQUIRE_EQ(stats.GetTotalSummary().min, ms(5));
+	REQUIRE_EQ(stats.GetTotalSummary().max, ms(7));
+	REQUIRE_NE(stats.GetReport().find("Frames: 2"), std::string::npos);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,143 @@
+#include "doctest.h"
+#include "game_interpreter_jump_table.h"
+#include <algorithm>
+#include <vector>
+
+TEST_SUITE_BEGIN("Game_Interpreter_JumpTable");
+
+using Cmd = lcf::rpg::EventCommand::Code;
+using List = std::vector<lcf::rpg::EventCommand>;
+
+static lcf::rpg::EventCommand MakeCommand(Cmd code, int indent, std::vector<int32_t> params = {}) {
+	lcf::rpg::EventCommand cmd;
+	cmd.code = static_cast<int32_t>(code);
+	cmd.indent = indent;
+	cmd.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return cmd;
+}
+
+// Linear scan like Game_Interpreter did before the jump tables
+static int ScanNextConditional(const List& list, int index, std::initializer_list<Cmd> codes, int indent) {
+	for (++index; index < static_cast<int>(list.size()); ++index) {
+		const auto& com = list[index];
+		if (com.indent > indent) {
+			continue;
+		}
+		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+			break;
+		}
+	}
+	return index;
+}
+
+static List MakeBranches() {
+	return {
+		MakeCommand(Cmd::ConditionalBranch, 0),  // 0
+		MakeCommand(Cmd::ConditionalBranch, 1),  // 1
+		MakeCommand(Cmd::Wait, 2),               // 2
+		MakeCommand(Cmd::ElseBranch, 1),         // 3
+		MakeCommand(Cmd::Wait, 2),               // 4
+		MakeCommand(Cmd::EndBranch, 1),          // 5
+		MakeCommand(Cmd::Wait, 1),               // 6
+		MakeCommand(Cmd::ElseBranch, 0),         // 7
+		MakeCommand(Cmd::Label, 1, {2}),         // 8
+		MakeCommand(Cmd::EndBranch, 0),          // 9
+		MakeCommand(Cmd::Loop, 0),               // 10
+		MakeCommand(Cmd::Label, 1, {1}),         // 11
+		MakeCommand(Cmd::ConditionalBranch, 1),  // 12
+		MakeCommand(Cmd::BreakLoop, 2),          // 13
+		MakeCommand(Cmd::EndBranch, 1),          // 14
+		MakeCommand(Cmd::Label, 1, {2}),         // 15
+		MakeCommand(Cmd::EndLoop, 0),            // 16
+		MakeCommand(Cmd::Wait, 0),               // 17
+	};
+}
+
+TEST_CASE("Labels") {
+	const auto list = MakeBranches();
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE(table.Matches(list));
+	// Stack frames run a copy of the list the table was built from
+	const auto copy = list;
+	REQUIRE(table.Matches(copy));
+	REQUIRE_EQ(table.FindLabel(1), 11);
+	REQUIRE_EQ(table.FindLabel(2), 8);
+	REQUIRE_EQ(table.FindLabel(3), -1);
+}
+
+TEST_CASE("NextConditional") {
+	const auto list = MakeBranches();
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindNextConditional(list, 0, {Cmd::ElseBranch, Cmd::EndBranch}, 0), 7);
+	REQUIRE_EQ(table.FindNextConditional(list, 1, {Cmd::ElseBranch, Cmd::EndBranch}, 1), 3);
+	REQUIRE_EQ(table.FindNextConditional(list, 3, {Cmd::EndBranch}, 1), 5);
+	REQUIRE_EQ(table.FindNextConditional(list, 7, {Cmd::EndBranch}, 0), 9);
+	REQUIRE_EQ(table.FindNextConditional(list, 13, {Cmd::EndLoop}, 1), 16);
+	REQUIRE_EQ(table.FindNextConditional(list, 10, {Cmd::EndLoop}, 0), 16);
+	REQUIRE_EQ(table.FindNextConditional(list, 0, {Cmd::ShowChoiceEnd}, 0), 18);
+}
+
+TEST_CASE("NextConditionalMatchesScan") {
+	const auto list = MakeBranches();
+	Game_Interpreter_JumpTable table(list);
+
+	for (int index = 0; index < static_cast<int>(list.size()); ++index) {
+		for (int indent = -1; indent <= 3; ++indent) {
+			for (auto code: {Cmd::ElseBranch, Cmd::EndBranch, Cmd::EndLoop, Cmd::Wait}) {
+				CAPTURE(index);
+				CAPTURE(indent);
+				REQUIRE_EQ(table.FindNextConditional(list, index, {code}, indent), ScanNextConditional(list, index, {code}, indent));
+			}
+		}
+	}
+}
+
+TEST_CASE("BrokenIndent") {
+	// Branch without end, deeper commands after the outer block ended
+	const List list = {
+		MakeCommand(Cmd::ConditionalBranch, 1),
+		MakeCommand(Cmd::Wait, 2),
+		MakeCommand(Cmd::Wait, 0),
+		MakeCommand(Cmd::Wait, 3),
+		MakeCommand(Cmd::ElseBranch, 1),
+		MakeCommand(Cmd::EndBranch, 2),
+	};
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindNextConditional(list, 0, {Cmd::ElseBranch}, 1), 4);
+	for (int index = 0; index < static_cast<int>(list.size()); ++index) {
+		for (int indent = 0; indent <= 3; ++indent) {
+			CAPTURE(index);
+			CAPTURE(indent);
+			REQUIRE_EQ(table.FindNextConditional(list, index, {Cmd::ElseBranch, Cmd::EndBranch}, indent),
+				ScanNextConditional(list, index, {Cmd::ElseBranch, Cmd::EndBranch}, indent));
+		}
+	}
+}
+
+TEST_CASE("Loops") {
+	const auto list = MakeBranches();
+	Game_Interpreter_JumpTable table(list);
+
+	REQUIRE_EQ(table.FindLoopBegin(list, 16), 10);
+	REQUIRE_EQ(table.FindNextEndLoop(13), 16);
+	REQUIRE_EQ(table.FindNextEndLoop(16), 18);
+
+	const List unmatched = {
+		MakeCommand(Cmd::Wait, 0),
+		MakeCommand(Cmd::Loop, 1),
+		MakeCommand(Cmd::Wait, 0),
+		MakeCommand(Cmd::EndLoop, 1),
+		MakeCommand(Cmd::EndLoop, 0),
+	};
+	Game_Interpreter_JumpTable unmatched_table(unmatched);
+
+	// Lower indent before the loop
+	REQUIRE_EQ(unmatched_table.FindLoopBegin(unmatched, 3), -1);
+	// No loop at all
+	REQUIRE_EQ(unmatched_table.FindLoopBegin(unmatched, 4), 4);
+}
+
+TEST_SUITE_END();
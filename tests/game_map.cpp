@@ -0,0 +1,110 @@
+#include "game_map.h"
+#include "doctest.h"
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Map");
+
+constexpr int all_dirs = Passable::Down | Passable::Left | Passable::Right | Passable::Up;
+
+static bool IsLowerPassable(int x, int y) {
+	return Game_Map::IsPassableLowerTile(all_dirs, x + y * Game_Map::GetTilesX());
+}
+
+TEST_CASE("PassabilityFromSetup") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	REQUIRE(IsLowerPassable(0, 0));
+	REQUIRE(IsLowerPassable(9, 14));
+	REQUIRE_FALSE(IsLowerPassable(10, 0));
+	REQUIRE_FALSE(IsLowerPassable(19, 14));
+
+	REQUIRE(Game_Map::IsPassableTile(nullptr, all_dirs, 19, 14, false, true));
+}
+
+TEST_CASE("PassabilityReplaceTile") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	Game_Map::ReplaceTileAt(0, 0, BLOCK_E + 1, 0);
+	REQUIRE_FALSE(IsLowerPassable(0, 0));
+
+	Game_Map::ReplaceTileAt(10, 0, BLOCK_E, 0);
+	REQUIRE(IsLowerPassable(10, 0));
+	REQUIRE_FALSE(IsLowerPassable(11, 0));
+}
+
+TEST_CASE("PassabilitySubstitute") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	REQUIRE_EQ(Game_Map::SubstituteDown(1, 0), 1);
+	REQUIRE(IsLowerPassable(10, 0));
+
+	REQUIRE_EQ(Game_Map::SubstituteDown(0, 1), 2);
+	REQUIRE_FALSE(IsLowerPassable(0, 0));
+	REQUIRE_FALSE(IsLowerPassable(10, 0));
+}
+
+TEST_CASE("EventAtPosition") {
+	const MockGame mg(MockMap::ePassBlock20x15);
+
+	auto* ev = MockGame::GetEvent(1);
+	REQUIRE(ev);
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), ev);
+	REQUIRE_EQ(Game_Map::CheckEvent(0, 0), 1);
+
+	ev->SetX(5);
+	ev->SetY(7);
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), nullptr);
+	REQUIRE_EQ(Game_Map::CheckEvent(0, 0), 0);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 7, false), ev);
+	REQUIRE_EQ(Game_Map::CheckEvent(5, 7), 1);
+
+	ev->SetX(-1);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 7, false), nullptr);
+	REQUIRE_EQ(Game_Map::GetEventAt(-1, 7, false), ev);
+	REQUIRE_EQ(Game_Map::GetEventAt(-1, 6, false), nullptr);
+}
+
+TEST_CASE("EventAtPositionAfterDestroy") {
+	const MockGame mg(MockMap::eSwitchPages20x15);
+	REQUIRE_EQ(Game_Map::GetEventAt(2, 0, false), MockGame::GetEvent(3));
+
+	// Done by CloneMapEvent and when loading a save, the references are updated later
+	REQUIRE(Game_Map::DestroyMapEvent(1, true));
+	REQUIRE_EQ(Game_Map::GetEventAt(0, 0, false), nullptr);
+	REQUIRE_EQ(Game_Map::GetEventAt(1, 0, false), MockGame::GetEvent(2));
+	REQUIRE_EQ(Game_Map::GetEventAt(2, 0, false), MockGame::GetEvent(3));
+
+	Game_Map::UpdateUnderlyingEventReferences();
+	REQUIRE_EQ(Game_Map::GetEventAt(2, 0, false), MockGame::GetEvent(3));
+}
+
+TEST_CASE("RefreshObservingEvents") {
+	const MockGame mg(MockMap::eSwitchPages20x15);
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+
+	auto* ev2 = MockGame::GetEvent(2);
+	auto* ev3 = MockGame::GetEvent(3);
+	REQUIRE_EQ(ev2->GetActivePage()->ID, 1);
+	REQUIRE_EQ(ev3->GetActivePage()->ID, 1);
+
+	// Switch 1 is only observed by event 2
+	Main_Data::game_switches->Set(1, true);
+	Main_Data::game_switches->Set(2, true);
+	Game_Map::SetNeedRefreshForSwitchChange(1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	REQUIRE_EQ(ev2->GetActivePage()->ID, 2);
+	REQUIRE_EQ(ev3->GetActivePage()->ID, 1);
+
+	// Switch 3 is not observed
+	Game_Map::SetNeedRefreshForSwitchChange(3);
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+
+	Game_Map::SetNeedRefresh(true);
+	Game_Map::Refresh();
+	REQUIRE_EQ(ev3->GetActivePage()->ID, 2);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,52 @@
+#include "game_strings.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Strings");
+
+TEST_CASE("RegExMatchAscii") {
+	std::string match;
+	CHECK_EQ(Game_Strings::RegExMatch("Hello World 42", "[0-9]+", match), 12);
+	CHECK_EQ(match, "42");
+
+	CHECK_EQ(Game_Strings::RegExMatch("Hello World 42", "o W", match), 4);
+	CHECK_EQ(match, "o W");
+
+	// Served from the cache
+	CHECK_EQ(Game_Strings::RegExMatch("Answer 42", "[0-9]+", match), 7);
+	CHECK_EQ(match, "42");
+}
+
+TEST_CASE("RegExMatchNonAscii") {
+	std::string match;
+
+	// Positions are in codepoints, not in bytes
+	CHECK_EQ(Game_Strings::RegExMatch(u8"Grüße 42", "[0-9]+", match), 6);
+	CHECK_EQ(match, "42");
+
+	CHECK_EQ(Game_Strings::RegExMatch(u8"アレックス", u8"ック", match), 2);
+	CHECK_EQ(match, u8"ック");
+
+	// "." matches a whole codepoint
+	CHECK_EQ(Game_Strings::RegExMatch(u8"aäb", "a.b", match), 0);
+	CHECK_EQ(match, u8"aäb");
+}
+
+TEST_CASE("RegExReplace") {
+	CHECK_EQ(Game_Strings::RegExReplace("a1b22c333", "[0-9]+", "#"), "a#b#c#");
+	CHECK_EQ(Game_Strings::RegExReplace(u8"ä1ö22", "[0-9]+", "#"), u8"ä#ö#");
+	CHECK_EQ(Game_Strings::RegExReplace("a1b22", "[0-9]+", "#", std::regex_constants::format_first_only), "a#b22");
+}
+
+TEST_CASE("ClearRegExCache") {
+	std::string match;
+	CHECK_EQ(Game_Strings::RegExMatch("abc", "b", match), 1);
+
+	Game_Strings::ClearRegExCache();
+
+	CHECK_EQ(Game_Strings::RegExMatch("abc", "c", match), 2);
+	CHECK_EQ(match, "c");
+	CHECK_EQ(Game_Strings::RegExMatch(u8"äbc", "b", match), 1);
+	CHECK_EQ(match, "b");
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,196 @@
+#include "doctest.h"
+#include "maniac_expression.h"
+#include "game_interpreter_shared.h"
+#include "mock_game.h"
+#include <cstdint>
+#include <vector>
+
+TEST_SUITE_BEGIN("ManiacExpression");
+
+namespace {
+
+enum : uint8_t {
+	Null = 0,
+	U8 = 1,
+	U16 = 2,
+	S32 = 3,
+	Var = 8,
+	Switch = 9,
+	Array = 19,
+	Negate = 24,
+	Add = 48,
+	Sub = 49,
+	Mul = 50,
+	Div = 51,
+	Less = 62,
+	Ternary = 72,
+	Function = 78
+};
+
+constexpr uint8_t FnMax = 13;
+constexpr uint8_t FnMuldiv = 16;
+
+class Context : public Game_BaseInterpreterContext {
+public:
+	int GetThisEventId() const override { return 0; }
+	Game_Character* GetCharacter(int, std::string_view) const override { return nullptr; }
+	const lcf::rpg::SaveEventExecState& GetState() const override { return state; }
+	const lcf::rpg::SaveEventExecFrame& GetFrame() const override { return frame; }
+
+private:
+	lcf::rpg::SaveEventExecState state;
+	lcf::rpg::SaveEventExecFrame frame;
+};
+
+// Packs the bytes into op-codes, the padding is a Null terminator
+std::vector<int32_t> Encode(const std::vector<uint8_t>& bytes) {
+	std::vector<int32_t> op_codes((bytes.size() + 3) / 4);
+	for (size_t i = 0; i < bytes.size(); ++i) {
+		op_codes[i / 4] = static_cast<int32_t>(static_cast<uint32_t>(op_codes[i / 4]) | (static_cast<uint32_t>(bytes[i]) << ((i % 4) * 8)));
+	}
+	return op_codes;
+}
+
+}
+
+TEST_CASE("ConstantFolding") {
+	const Context ctx;
+	// (1 + 2) * -3
+	const auto op_codes = Encode({Mul, Add, U8, 1, U8, 2, Negate, U8, 3});
+	ManiacExpression expr(op_codes);
+
+	REQUIRE(expr.IsCompiled());
+	REQUIRE_EQ(expr.GetNumInstructions(), 1);
+	REQUIRE_EQ(expr.Evaluate(ctx), -9);
+	REQUIRE_EQ(ManiacExpression::Interpret(op_codes, ctx), -9);
+}
+
+TEST_CASE("Immediates") {
+	const Context ctx;
+
+	REQUIRE_EQ(ManiacExpression(Encode({U16, 0x34, 0x12})).Evaluate(ctx), 0x1234);
+	REQUIRE_EQ(ManiacExpression(Encode({S32, 0xFE, 0xFF, 0xFF, 0xFF})).Evaluate(ctx), -2);
+	REQUIRE_EQ(ManiacExpression(Encode({Div, U8, 7, U8, 0})).Evaluate(ctx), 7);
+	REQUIRE_EQ(ManiacExpression(Encode({Ternary, U8, 0, U8, 1, U8, 2})).Evaluate(ctx), 2);
+}
+
+TEST_CASE("Variables") {
+	const MockGame mg(MockMap::eNone);
+	const Context ctx;
+
+	Main_Data::game_variables->Set(5, 10);
+	Main_Data::game_variables->Set(6, 5);
+	Main_Data::game_switches->Set(3, true);
+
+	// v[5] + 3
+	auto op_codes = Encode({Add, Var, U8, 5, U8, 3});
+	ManiacExpression expr(op_codes);
+	REQUIRE(expr.IsCompiled());
+	REQUIRE_EQ(expr.GetNumInstructions(), 3);
+	REQUIRE_EQ(expr.Evaluate(ctx), 13);
+
+	// v[v[6]] < 20 ? s[3] : 7
+	op_codes = Encode({Ternary, Less, Var, Var, U8, 6, U8, 20, Switch, U8, 3, U8, 7});
+	REQUIRE_EQ(ManiacExpression(op_codes).Evaluate(ctx), 1);
+	REQUIRE_EQ(ManiacExpression::Interpret(op_codes, ctx), 1);
+
+	Main_Data::game_variables->Set(5, 30);
+	REQUIRE_EQ(expr.Evaluate(ctx), 33);
+	REQUIRE_EQ(ManiacExpression(op_codes).Evaluate(ctx), 7);
+}
+
+TEST_CASE("Functions") {
+	const MockGame mg(MockMap::eNone);
+	const Context ctx;
+
+	Main_Data::game_variables->Set(1, 4);
+
+	// The arguments are stored last to first
+	auto op_codes = Encode({Function, FnMuldiv, 3, U8, 2, U8, 3, Var, U8, 1});
+	ManiacExpression expr(op_codes);
+	REQUIRE(expr.IsCompiled());
+	REQUIRE_EQ(expr.Evaluate(ctx), 6);
+	REQUIRE_EQ(ManiacExpression::Interpret(op_codes, ctx), 6);
+
+	// Wrong argument count is interpreted
+	op_codes = Encode({Function, FnMax, 3, U8, 2, U8, 3, U8, 4});
+	REQUIRE_FALSE(ManiacExpression(op_codes).IsCompiled());
+	REQUIRE_EQ(ManiacExpression(op_codes).Evaluate(ctx), 0);
+}
+
+TEST_CASE("Unsupported") {
+	const Context ctx;
+
+	const auto op_codes = Encode({Add, Array, U8, 1, U8, 2});
+	ManiacExpression expr(op_codes);
+
+	REQUIRE_FALSE(expr.IsCompiled());
+	REQUIRE_EQ(expr.Evaluate(ctx), ManiacExpression::Interpret(op_codes, ctx));
+}
+
+TEST_CASE("MultipleExpressions") {
+	const MockGame mg(MockMap::eNone);
+	const Context ctx;
+
+	Main_Data::game_variables->Set(2, 8);
+
+	const auto op_codes = Encode({U8, 1, Sub, Var, U8, 2, U8, 3, U16, 0, 1, Null, Null});
+	ManiacExpression expr(op_codes);
+	const std::vector<int32_t> expected = {1, 5, 256};
+
+	REQUIRE_EQ(expr.EvaluateAll(ctx), expected);
+	REQUIRE_EQ(ManiacExpression::InterpretAll(op_codes, ctx), expected);
+	REQUIRE(ManiacExpression(std::vector<int32_t>{}).EvaluateAll(ctx).empty());
+}
+
+TEST_CASE("DeepNesting") {
+	const MockGame mg(MockMap::eNone);
+	const Context ctx;
+
+	Main_Data::game_variables->Set(1, 1);
+
+	// v[1] + (v[1] + (v[1] + ...)), deeper than the stack of the evaluator
+	std::vector<uint8_t> bytes;
+	for (int i = 0; i < 100; ++i) {
+		bytes.insert(bytes.end(), {Add, Var, U8, 1});
+	}
+	bytes.insert(bytes.end(), {U8, 1});
+
+	ManiacExpression expr(Encode(bytes));
+	REQUIRE(expr.IsCompiled());
+	REQUIRE_EQ(expr.Evaluate(ctx), 101);
+}
+
+TEST_CASE("Cache") {
+	const Context ctx;
+
+	auto op_codes = Encode({Add, U8, 1, U8, 2});
+	const auto* expr = &ManiacExpression::Get(op_codes);
+	REQUIRE_EQ(&ManiacExpression::Get(op_codes), expr);
+	REQUIRE_EQ(expr->Evaluate(ctx), 3);
+
+	// Same storage, different content
+	op_codes[0] = Encode({Sub, U8, 1, U8})[0];
+	REQUIRE_EQ(ManiacExpression::Get(op_codes).Evaluate(ctx), -1);
+
+	ManiacExpression::ClearCache();
+}
+
+TEST_CASE("CacheCopiedCommands") {
+	const Context ctx;
+	ManiacExpression::ClearCache();
+
+	// The interpreter pushes a copy of the command list for every run
+	const auto op_codes = Encode({Mul, U8, 6, U8, 7});
+	const std::vector<int32_t> first_push = op_codes;
+	const std::vector<int32_t> second_push = op_codes;
+
+	const auto* expr = &ManiacExpression::Get(first_push);
+	REQUIRE_EQ(&ManiacExpression::Get(second_push), expr);
+	REQUIRE_EQ(ManiacExpression::GetCacheSize(), 1);
+	REQUIRE_EQ(expr->Evaluate(ctx), 42);
+
+	ManiacExpression::ClearCache();
+}
+
+TEST_SUITE_END();
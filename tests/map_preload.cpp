@@ -0,0 +1,84 @@
+#include "map_preload.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("MapPreload");
+
+namespace {
+
+std::unique_ptr<lcf::rpg::Map> MakeMap(int width, int height) {
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = width;
+	map->height = height;
+	map->lower_layer.resize(width * height);
+	map->upper_layer.resize(width * height);
+	return map;
+}
+
+}
+
+TEST_CASE("Copies") {
+	MapPreload::Clear();
+
+	MapPreload::Add(1, MakeMap(20, 15));
+
+	auto map = MapPreload::Get(1);
+	REQUIRE(map);
+	CHECK_EQ(map->width, 20);
+
+	// Modifying the returned map does not change the cache
+	map->width = 100;
+	CHECK_EQ(MapPreload::Get(1)->width, 20);
+
+	CHECK_FALSE(MapPreload::Get(2));
+
+	MapPreload::Clear();
+	CHECK_FALSE(MapPreload::Get(1));
+}
+
+TEST_CASE("Budget") {
+	MapPreload::Clear();
+
+	const size_t map_size = MapPreload::EstimateSize(*MakeMap(100, 100));
+	CHECK_GE(map_size, 100 * 100 * 2 * sizeof(int16_t));
+
+	MapPreload::SetBudget(map_size * 3);
+	auto evictions = MapPreload::GetStats().evictions;
+
+	MapPreload::Add(1, MakeMap(100, 100));
+	MapPreload::Add(2, MakeMap(100, 100));
+	MapPreload::Add(3, MakeMap(100, 100));
+	CHECK_EQ(MapPreload::GetStats().entries, 3);
+
+	// Map 1 was used last, map 2 is the oldest
+	CHECK(MapPreload::Get(1));
+	MapPreload::Add(4, MakeMap(100, 100));
+
+	auto stats = MapPreload::GetStats();
+	CHECK_EQ(stats.entries, 3);
+	CHECK_EQ(stats.evictions, evictions + 1);
+	CHECK_LE(stats.size, stats.budget);
+	CHECK_FALSE(MapPreload::Get(2));
+	CHECK(MapPreload::Get(1));
+	CHECK(MapPreload::Get(4));
+
+	MapPreload::SetBudget(16 * 1024 * 1024);
+	MapPreload::Clear();
+}
+
+TEST_CASE("RequestsAreDeferred") {
+	MapPreload::Clear();
+	const auto preloads = MapPreload::GetStats().preloads;
+
+	// The file is read by a later Update, not during the transfer
+	MapPreload::Request(7);
+	CHECK_EQ(MapPreload::GetStats().preloads, preloads);
+
+	// A load before the file was read does not wait and drops the request
+	CHECK_FALSE(MapPreload::Get(7));
+	MapPreload::Update();
+	CHECK_EQ(MapPreload::GetStats().preloads, preloads);
+
+	MapPreload::Clear();
+}
+
+TEST_SUITE_END();
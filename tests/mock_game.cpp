@@ -111,6 +111,18 @@ std::unique_ptr<lcf::rpg::Map> MakeMockMap(MockMap maptag) {
 		case MockMap::eMapCount:
 		case MockMap::ePass40x30:
 			break;
+		case MockMap::eSwitchPages20x15:
+			for (int switch_id = 1; switch_id <= 2; ++switch_id) {
+				map->events.push_back(map->events.front());
+				auto& ev = map->events.back();
+				ev.ID = switch_id + 1;
+				ev.x = switch_id;
+				ev.pages.push_back(ev.pages.front());
+				ev.pages.back().ID = 2;
+				ev.pages.back().condition.flags.switch_a = true;
+				ev.pages.back().condition.switch_a_id = switch_id;
+			}
+			break;
 		case MockMap::ePassBlock20x15:
 			for (int y = 0; y < h; ++y) {
 				for (int x = 0; x < w; ++x) {
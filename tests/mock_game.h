@@ -22,6 +22,7 @@ enum class MockMap {
 	eNone,
 	ePassBlock20x15, // Left half is passable, right half is blocked
 	ePass40x30,
+	eSwitchPages20x15, // Events 2 and 3 have a second page for switch 1 and 2
 	eMapCount
 };
 
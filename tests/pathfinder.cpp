@@ -0,0 +1,438 @@
+#include "pathfinder.h"
+#include "doctest.h"
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TestMap {
+	/** '#' is a wall, everything else is passable */
+	std::vector<std::string> rows;
+	bool loop_horizontal = false;
+	bool loop_vertical = false;
+
+	Pathfinder::Grid GetGrid() const {
+		Pathfinder::Grid grid;
+		grid.width = static_cast<int>(rows[0].size());
+		grid.height = static_cast<int>(rows.size());
+		grid.loop_horizontal = loop_horizontal;
+		grid.loop_vertical = loop_vertical;
+		return grid;
+	}
+
+	bool IsFree(int x, int y) const {
+		const int w = static_cast<int>(rows[0].size());
+		const int h = static_cast<int>(rows.size());
+		if (loop_horizontal) {
+			x = (x + w) % w;
+		}
+		if (loop_vertical) {
+			y = (y + h) % h;
+		}
+		if (x < 0 || x >= w || y < 0 || y >= h) {
+			return false;
+		}
+		return rows[y][x] != '#';
+	}
+};
+
+std::vector<Pathfinder::Step> Search(const TestMap& map, Pathfinder::Query query, Pathfinder& pf, int max_nodes = 1000) {
+	auto can_move = [&](int, int, int to_x, int to_y) { return map.IsFree(to_x, to_y); };
+	auto can_enter_dest = [](int, int, int, int) { return false; };
+
+	std::vector<Pathfinder::Step> route;
+	if (pf.Search(map.GetGrid(), query, can_move, can_enter_dest)) {
+		pf.BuildRoute(max_nodes, route);
+	}
+	return route;
+}
+
+std::vector<int> Directions(const std::vector<Pathfinder::Step>& route) {
+	std::vector<int> dirs;
+	for (auto& step: route) {
+		if (step.direction >= 0) {
+			dirs.push_back(step.direction);
+		}
+	}
+	return dirs;
+}
+
+struct RouteResult {
+	bool found = false;
+	bool reached = false;
+	std::vector<std::vector<int>> route;
+
+	bool operator==(const RouteResult& o) const {
+		return found == o.found && reached == o.reached && route == o.route;
+	}
+};
+
+/** The breadth-first search of Game_Character::CalculateMoveRoute before the Pathfinder class */
+template <typename F, typename G>
+RouteResult SearchReference(const TestMap& map, const Pathfinder::Query& q, F&& can_move, G&& can_enter_dest, int max_nodes) {
+	struct Node {
+		int x;
+		int y;
+		int direction;
+		int parent_x;
+		int parent_y;
+	};
+
+	const auto grid = map.GetGrid();
+	std::deque<Node> queue = { { q.start_x, q.start_y, -1, -1, -1 } };
+	std::set<std::pair<int, int>> seen;
+	std::map<std::pair<int, int>, Node> graph_by_coord;
+	Node closest_node = {};
+	int closest_distance = std::numeric_limits<int>::max();
+	int steps_taken = 0;
+
+	while (!queue.empty() && steps_taken < q.search_max) {
+		Node n = queue.front();
+		queue.pop_front();
+		steps_taken++;
+		graph_by_coord.insert({ { n.x, n.y }, n });
+
+		if (n.x == q.dest_x && n.y == q.dest_y) {
+			closest_node = n;
+			closest_distance = 0;
+			break;
+		}
+
+		std::vector<Node> neighbour = {
+			{ n.x + 1, n.y, 1 }, { n.x, n.y - 1, 0 }, { n.x - 1, n.y, 3 }, { n.x, n.y + 1, 2 }
+		};
+		if (q.allow_diagonal) {
+			neighbour.insert(neighbour.end(), {
+				{ n.x - 1, n.y + 1, 6 }, { n.x + 1, n.y - 1, 4 }, { n.x - 1, n.y - 1, 7 }, { n.x + 1, n.y + 1, 5 }
+			});
+		}
+
+		for (Node a: neighbour) {
+			const int raw_x = a.x;
+			const int raw_y = a.y;
+			a.parent_x = n.x;
+			a.parent_y = n.y;
+			if (grid.loop_horizontal) {
+				a.x = (a.x + grid.width) % grid.width;
+			}
+			if (grid.loop_vertical) {
+				a.y = (a.y + grid.height) % grid.height;
+			}
+			if (a.x < 0 || a.x >= grid.width || a.y < 0 || a.y >= grid.height) {
+				continue;
+			}
+			if (seen.count({ a.x, a.y }) || (a.x == q.start_x && a.y == q.start_y)) {
+				continue;
+			}
+			if (!can_move(n.x, n.y, raw_x, raw_y) && !(a.x == q.dest_x && a.y == q.dest_y && can_enter_dest(n.x, n.y, raw_x, raw_y))) {
+				continue;
+			}
+			const int dx = raw_x - n.x;
+			const int dy = raw_y - n.y;
+			if (dx != 0 && dy != 0 && !can_move(n.x, n.y, n.x + dx, n.y) && !can_move(n.x, n.y, n.x, n.y + dy)) {
+				continue;
+			}
+			queue.push_back(a);
+			seen.insert({ a.x, a.y });
+		}
+
+		const int manhattan_dist = std::abs(q.dest_x - n.x) + std::abs(q.dest_y - n.y);
+		if (manhattan_dist < closest_distance) {
+			closest_node = n;
+			closest_distance = manhattan_dist;
+		}
+	}
+
+	RouteResult result;
+	if (closest_distance == std::numeric_limits<int>::max()) {
+		return result;
+	}
+	result.found = true;
+	result.reached = closest_distance == 0;
+
+	Node node = closest_node;
+	while (static_cast<int>(result.route.size()) < max_nodes) {
+		result.route.push_back({ node.x, node.y, node.direction });
+		auto it = graph_by_coord.find({ node.parent_x, node.parent_y });
+		if (it == graph_by_coord.end()) {
+			break;
+		}
+		node = it->second;
+	}
+	std::reverse(result.route.begin(), result.route.end());
+	return result;
+}
+
+template <typename F, typename G>
+RouteResult SearchPathfinder(const TestMap& map, const Pathfinder::Query& q, F&& can_move, G&& can_enter_dest, int max_nodes, Pathfinder& pf) {
+	RouteResult result;
+	result.found = pf.Search(map.GetGrid(), q, can_move, can_enter_dest);
+	if (result.found) {
+		result.reached = pf.ReachedDestination();
+		std::vector<Pathfinder::Step> route;
+		pf.BuildRoute(max_nodes, route);
+		for (auto& step: route) {
+			result.route.push_back({ step.x, step.y, step.direction });
+		}
+	}
+	return result;
+}
+
+/** Map with walls at pseudo random positions, the same for every run */
+TestMap MakeRandomMap(int width, int height, int wall_percent, uint32_t seed) {
+	TestMap map;
+	map.rows.assign(height, std::string(width, '.'));
+	for (auto& row: map.rows) {
+		for (auto& c: row) {
+			seed = seed * 1103515245 + 12345;
+			if (static_cast<int>((seed >> 16) % 100) < wall_percent) {
+				c = '#';
+			}
+		}
+	}
+	return map;
+}
+
+}
+
+TEST_SUITE_BEGIN("Pathfinder");
+
+TEST_CASE("StraightLine") {
+	TestMap map = { { ".....", ".....", "....." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 1;
+	q.dest_x = 4;
+	q.dest_y = 1;
+
+	auto route = Search(map, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 1, 1, 1, 1 });
+	REQUIRE_EQ(route.front().x, 0);
+	REQUIRE_EQ(route.back().x, 4);
+}
+
+TEST_CASE("Detour") {
+	TestMap map = { {
+		".#...",
+		".#.#.",
+		"...#.",
+	} };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 4;
+	q.dest_y = 2;
+
+	auto route = Search(map, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	// down, down, right, right, up, up, right, right, down, down
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 2, 2, 1, 1, 0, 0, 1, 1, 2, 2 });
+}
+
+TEST_CASE("Diagonal") {
+	TestMap map = { { "....", "....", "...." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 2;
+	q.dest_y = 2;
+	q.allow_diagonal = true;
+
+	auto route = Search(map, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 5, 5 });
+}
+
+TEST_CASE("DiagonalBlockedCorners") {
+	TestMap map = { { ".#", "#." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 1;
+	q.dest_y = 1;
+	q.allow_diagonal = true;
+
+	Search(map, q, pf);
+	REQUIRE_FALSE(pf.ReachedDestination());
+}
+
+TEST_CASE("LoopHorizontal") {
+	TestMap map = { { "......" }, true, false };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 5;
+	q.dest_y = 0;
+
+	auto route = Search(map, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 3 });
+	REQUIRE_EQ(route.back().x, 5);
+}
+
+TEST_CASE("ClosestNode") {
+	TestMap map = { { "..#." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 3;
+	q.dest_y = 0;
+
+	auto route = Search(map, q, pf);
+	REQUIRE_FALSE(pf.ReachedDestination());
+	REQUIRE_EQ(route.back().x, 1);
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 1 });
+}
+
+TEST_CASE("MaxNodes") {
+	TestMap map = { { "......" } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 5;
+	q.dest_y = 0;
+
+	auto route = Search(map, q, pf, 3);
+	REQUIRE_EQ(route.size(), 3);
+	REQUIRE_EQ(route.back().x, 5);
+}
+
+TEST_CASE("SearchMax") {
+	TestMap map = { { "......" } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 5;
+	q.dest_y = 0;
+	q.search_max = 3;
+
+	auto route = Search(map, q, pf);
+	REQUIRE_FALSE(pf.ReachedDestination());
+	REQUIRE_EQ(pf.GetExpandedNodes(), 3);
+	REQUIRE_EQ(route.back().x, 2);
+}
+
+TEST_CASE("Reuse") {
+	TestMap big = { std::vector<std::string>(20, std::string(20, '.')) };
+	TestMap small = { { "...", "...", "..." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.dest_x = 19;
+	q.dest_y = 19;
+
+	auto route = Search(big, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	REQUIRE_EQ(Directions(route).size(), 38);
+
+	q.dest_x = 2;
+	q.dest_y = 0;
+	route = Search(small, q, pf);
+	REQUIRE(pf.ReachedDestination());
+	REQUIRE_EQ(Directions(route), std::vector<int>{ 1, 1 });
+}
+
+TEST_CASE("DestinationFallback") {
+	TestMap map = { { "..." } };
+	Pathfinder pf;
+	Pathfinder::Query q;
+	q.start_x = 0;
+	q.start_y = 0;
+	q.dest_x = 2;
+	q.dest_y = 0;
+
+	auto blocked = [](int, int, int to_x, int) { return to_x != 2; };
+	auto dest_ok = [](int, int, int, int) { return true; };
+	REQUIRE(pf.Search(map.GetGrid(), q, blocked, dest_ok));
+	REQUIRE(pf.ReachedDestination());
+}
+
+TEST_CASE("MatchesBreadthFirstSearch") {
+	// Open maps and maps with few walls have many shortest routes
+	std::vector<TestMap> maps;
+	maps.push_back({ std::vector<std::string>(9, std::string(12, '.')) });
+	maps.push_back({ std::vector<std::string>(9, std::string(12, '.')), true, true });
+	for (uint32_t seed = 1; seed <= 6; ++seed) {
+		maps.push_back(MakeRandomMap(16, 12, 20, seed));
+		auto looping = MakeRandomMap(11, 7, 25, seed * 7);
+		looping.loop_horizontal = seed % 2 == 0;
+		looping.loop_vertical = seed % 3 != 0;
+		maps.push_back(looping);
+	}
+	// Unreachable destination: Fallback to the closest tile
+	maps.push_back({ {
+		"..........",
+		"......###.",
+		"......#.#.",
+		"......###.",
+		"..........",
+	} });
+
+	Pathfinder pf;
+	int compared = 0;
+	for (auto& map: maps) {
+		const auto grid = map.GetGrid();
+		const int tiles = grid.width * grid.height;
+		auto can_move = [&](int, int, int to_x, int to_y) { return map.IsFree(to_x, to_y); };
+		auto can_enter_dest = [](int, int, int, int) { return true; };
+
+		const int search_maxes[] = { std::numeric_limits<int>::max(), tiles, tiles - 1, 1, 5, 17, tiles / 3 };
+		const std::pair<int, int> points[] = {
+			{ 0, 0 }, { grid.width - 1, grid.height - 1 }, { grid.width / 2, grid.height / 2 }, { 7, 2 }, { 1, grid.height - 2 }
+		};
+
+		for (auto [start_x, start_y]: points) {
+			if (!map.IsFree(start_x, start_y)) {
+				continue;
+			}
+			for (auto [dest_x, dest_y]: points) {
+				for (int search_max: search_maxes) {
+					for (bool diagonal: { false, true }) {
+						Pathfinder::Query q;
+						q.start_x = start_x;
+						q.start_y = start_y;
+						q.dest_x = dest_x;
+						q.dest_y = dest_y;
+						q.search_max = search_max;
+						q.allow_diagonal = diagonal;
+
+						for (int max_nodes: { 1000, 4 }) {
+							auto expected = SearchReference(map, q, can_move, can_enter_dest, max_nodes);
+							auto actual = SearchPathfinder(map, q, can_move, can_enter_dest, max_nodes, pf);
+							INFO("map ", compared, " start ", start_x, ",", start_y, " dest ", dest_x, ",", dest_y,
+								" search_max ", search_max, " diagonal ", diagonal);
+							REQUIRE(actual == expected);
+						}
+					}
+				}
+			}
+		}
+		++compared;
+	}
+
+	// The unreachable destination is inside the wall ring of the last map
+	Pathfinder::Query q;
+	q.dest_x = 7;
+	q.dest_y = 2;
+	auto blocked = [&](int, int, int to_x, int to_y) { return maps.back().IsFree(to_x, to_y) && !(to_x == 7 && to_y == 2); };
+	auto no_dest = [](int, int, int, int) { return false; };
+	auto expected = SearchReference(maps.back(), q, blocked, no_dest, 1000);
+	REQUIRE(expected.found);
+	REQUIRE_FALSE(expected.reached);
+	REQUIRE(SearchPathfinder(maps.back(), q, blocked, no_dest, 1000, pf) == expected);
+}
+
+TEST_SUITE_END();
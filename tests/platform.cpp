@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cstdlib>
+#include <fstream>
 #include "platform.h"
 #include "doctest.h"
 
@@ -10,6 +11,12 @@ namespace {
 	const std::string empty = EP_TEST_PATH "/platform/empty";
 	const std::string folder = EP_TEST_PATH "/platform/folder";
 	const std::string bad = EP_TEST_PATH "/platform/!!!nonexistant!!!";
+
+	// Written to the working directory, the asset directory is read-only
+	void WriteFile(const std::string& name, const std::string& content) {
+		std::ofstream os(name, std::ios_base::binary | std::ios_base::trunc);
+		os << content;
+	}
 }
 
 TEST_CASE("Exists") {
@@ -42,6 +49,58 @@ TEST_CASE("GetSize") {
 	CHECK(Platform::File(bad).GetSize() == -1);
 }
 
+TEST_CASE("GetModificationTime") {
+	CHECK(Platform::File(empty).GetModificationTime() != -1);
+	CHECK(Platform::File(folder).GetModificationTime() != -1);
+	CHECK(Platform::File(bad).GetModificationTime() == -1);
+}
+
+TEST_CASE("Rename") {
+	const std::string from = "platform_rename_from";
+	const std::string to = "platform_rename_to";
+	WriteFile(from, "abc");
+	std::remove(to.c_str());
+
+	CHECK(Platform::File(from).Rename(to));
+	CHECK(!Platform::File(from).Exists());
+	CHECK(Platform::File(to).GetSize() == 3);
+
+	CHECK(!Platform::File(bad).Rename(to));
+	CHECK(Platform::File(to).Exists());
+
+	CHECK(Platform::File(to).Remove());
+}
+
+TEST_CASE("RenameReplaces") {
+	const std::string from = "platform_replace_from";
+	const std::string to = "platform_replace_to";
+	WriteFile(from, "new");
+	WriteFile(to, "old content");
+
+	CHECK(Platform::File(from).Rename(to));
+	CHECK(!Platform::File(from).Exists());
+	CHECK(Platform::File(to).GetSize() == 3);
+
+	std::ifstream is(to, std::ios_base::binary);
+	std::string content((std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+	CHECK(content == "new");
+	is.close();
+
+	CHECK(Platform::File(to).Remove());
+}
+
+TEST_CASE("SyncAndRemove") {
+	const std::string name = "platform_sync";
+	WriteFile(name, "data");
+
+	CHECK(Platform::File(name).Sync());
+	CHECK(Platform::File(name).Remove());
+	CHECK(!Platform::File(name).Exists());
+
+	CHECK(!Platform::File(bad).Sync());
+	CHECK(!Platform::File(bad).Remove());
+}
+
 TEST_CASE("ReadDirectory") {
 	Platform::Directory dir(EP_TEST_PATH "/platform");
 
@@ -0,0 +1,86 @@
+#include "project_type_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("ProjectTypeCache");
+
+namespace {
+
+ProjectTypeCache::Key MakeKey(std::string path, int64_t size, int64_t mtime) {
+	ProjectTypeCache::Key key;
+	key.path = std::move(path);
+	key.size = size;
+	key.mtime = mtime;
+	return key;
+}
+
+}
+
+TEST_CASE("Find") {
+	ProjectTypeCache cache;
+	auto key = MakeKey("games/Game.zip", 1024, 42);
+	auto type = FileFinder::ProjectType::Unknown;
+
+	CHECK_FALSE(cache.Find(key, type));
+
+	cache.Set(key, FileFinder::ProjectType::Supported);
+	CHECK(cache.IsModified());
+	REQUIRE(cache.Find(key, type));
+	CHECK(type == FileFinder::ProjectType::Supported);
+
+	// Changed on disk
+	CHECK_FALSE(cache.Find(MakeKey("games/Game.zip", 1025, 42), type));
+	CHECK_FALSE(cache.Find(MakeKey("games/Game.zip", 1024, 43), type));
+	CHECK_FALSE(cache.Find(MakeKey("games/Other.zip", 1024, 42), type));
+}
+
+TEST_CASE("Stat failed") {
+	ProjectTypeCache cache;
+	auto key = MakeKey("games/Game.zip", -1, -1);
+	auto type = FileFinder::ProjectType::Unknown;
+
+	cache.Set(key, FileFinder::ProjectType::Supported);
+	CHECK_FALSE(cache.IsModified());
+	CHECK_FALSE(cache.Find(key, type));
+}
+
+TEST_CASE("RoundTrip") {
+	ProjectTypeCache cache;
+	cache.Set(MakeKey("games/Game.zip", 1024, 42), FileFinder::ProjectType::Supported);
+	cache.Set(MakeKey("games/Folder with spaces", 0, 1700000000), FileFinder::ProjectType::Unknown);
+	cache.Set(MakeKey("games/VX", 4096, 7), FileFinder::ProjectType::RpgMakerVx);
+
+	ProjectTypeCache loaded;
+	REQUIRE(loaded.Parse(cache.Serialize()));
+	CHECK_FALSE(loaded.IsModified());
+
+	auto type = FileFinder::ProjectType::Unknown;
+	REQUIRE(loaded.Find(MakeKey("games/Game.zip", 1024, 42), type));
+	CHECK(type == FileFinder::ProjectType::Supported);
+	REQUIRE(loaded.Find(MakeKey("games/Folder with spaces", 0, 1700000000), type));
+	CHECK(type == FileFinder::ProjectType::Unknown);
+	REQUIRE(loaded.Find(MakeKey("games/VX", 4096, 7), type));
+	CHECK(type == FileFinder::ProjectType::RpgMakerVx);
+
+	// Unchanged entries do not require saving
+	loaded.Set(MakeKey("games/VX", 4096, 7), FileFinder::ProjectType::RpgMakerVx);
+	CHECK_FALSE(loaded.IsModified());
+}
+
+TEST_CASE("Parse invalid") {
+	ProjectTypeCache cache;
+	CHECK_FALSE(cache.Parse(""));
+	CHECK_FALSE(cache.Parse("EasyRPG ProjectTypeCache 0\n1\t2\t3\tgame\n"));
+
+	REQUIRE(cache.Parse("EasyRPG ProjectTypeCache 1\n"
+		"1\t2\t3\tgood\n"
+		"1\t2\tbroken\n"
+		"999\t2\t3\tbadtype\n"
+		"1\t2\t3\t\n"));
+
+	auto type = FileFinder::ProjectType::Unknown;
+	CHECK(cache.Find(MakeKey("good", 2, 3), type));
+	CHECK_FALSE(cache.Find(MakeKey("broken", 2, 3), type));
+	CHECK_FALSE(cache.Find(MakeKey("badtype", 2, 3), type));
+}
+
+TEST_SUITE_END();
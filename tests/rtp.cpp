@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <limits>
 #include <ostream>
 #include "filefinder.h"
@@ -126,4 +127,37 @@ TEST_CASE("RTP 2000: Lookup RTP to RTP (Same RTP)") {
 	REQUIRE(!is_rtp_asset);
 }
 
+TEST_CASE("RTP 2003: Lookup matches every table entry") {
+	for (int i = 0; RTP::rtp_table_2k3_categories[i] != nullptr; ++i) {
+		const char* category = RTP::rtp_table_2k3_categories[i];
+
+		for (int row = RTP::rtp_table_2k3_categories_idx[i]; row < RTP::rtp_table_2k3_categories_idx[i+1]; ++row) {
+			for (int j = 1; j <= RTP::num_2k3_rtps; ++j) {
+				const char* name = RTP::rtp_table_2k3[row][j];
+				if (name == nullptr) {
+					continue;
+				}
+
+				auto src_type = (RTP::Type)(RTP::num_2k_rtps + j - 1);
+				auto types = RTP::LookupAnyToRtp(category, name, 2003);
+				REQUIRE(std::find(types.begin(), types.end(), src_type) != types.end());
+
+				bool is_rtp_asset = false;
+				auto target_type = j == 1 ? RTP::Type::RPG2003_OfficialEnglish : RTP::Type::RPG2003_OfficialJapanese;
+				RTP::LookupRtpToRtp(category, name, src_type, target_type, &is_rtp_asset);
+				REQUIRE(is_rtp_asset);
+			}
+		}
+	}
+}
+
+TEST_CASE("RTP 2000: Lookup with unknown category") {
+	REQUIRE(RTP::LookupAnyToRtp("nocategory", "actor1", 2000).empty());
+
+	bool is_rtp_asset = true;
+	std::string name = RTP::LookupRtpToRtp("nocategory", "主人公2", RTP::Type::RPG2000_OfficialJapanese, RTP::Type::RPG2000_OfficialEnglish, &is_rtp_asset);
+	REQUIRE(name.empty());
+	REQUIRE(!is_rtp_asset);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,53 @@
+#include <sstream>
+#include "save_title_loader.h"
+#include "doctest.h"
+#include <lcf/lsd/reader.h>
+
+TEST_SUITE_BEGIN("SaveTitleLoader");
+
+namespace {
+
+std::string MakeSave() {
+	lcf::rpg::Save save;
+	save.title.timestamp = 45000.5;
+	save.title.hero_name = "Alex";
+	save.title.hero_level = 42;
+	save.title.face1_name = "Actor1";
+	save.title.face1_id = 3;
+	save.inventory.party = { 1, 2 };
+	save.system.save_count = 7;
+
+	std::stringstream ss;
+	REQUIRE(lcf::LSD_Reader::Save(ss, save, lcf::EngineVersion::e2k3, "1252"));
+	return ss.str();
+}
+
+}
+
+TEST_CASE("Title only") {
+	std::stringstream ss(MakeSave());
+	auto save = SaveTitleLoader::LoadTitle(ss, "1252");
+
+	REQUIRE(save);
+	CHECK_EQ(save->title.timestamp, 45000.5);
+	CHECK_EQ(save->title.hero_name, "Alex");
+	CHECK_EQ(save->title.hero_level, 42);
+	CHECK_EQ(save->title.face1_name, "Actor1");
+	CHECK_EQ(save->title.face1_id, 3);
+
+	// The remaining chunks are not read
+	CHECK(save->inventory.party.empty());
+	CHECK_EQ(save->system.save_count, 0);
+}
+
+TEST_CASE("Empty") {
+	std::stringstream ss;
+	CHECK_FALSE(SaveTitleLoader::LoadTitle(ss, "1252"));
+}
+
+TEST_CASE("Not a save") {
+	std::stringstream ss("This is not a save file");
+	CHECK_FALSE(SaveTitleLoader::LoadTitle(ss, "1252"));
+}
+
+TEST_SUITE_END();
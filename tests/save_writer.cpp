@@ -0,0 +1,93 @@
+#include "save_writer.h"
+#include "filefinder.h"
+#include "filesystem_stream.h"
+#include "platform.h"
+#include "doctest.h"
+#include <vector>
+
+TEST_SUITE_BEGIN("SaveWriter");
+
+namespace {
+	// Written to the working directory, the asset directory is read-only
+	const std::string save_dir = "save_writer_test";
+
+	FilesystemView GetSaveFilesystem() {
+		Platform::File(save_dir).MakeDirectory(false);
+		return FileFinder::Root().Create(save_dir);
+	}
+
+	lcf::rpg::Save MakeSave(int level) {
+		lcf::rpg::Save save;
+		save.title.hero_level = level;
+		return save;
+	}
+
+	int ReadLevel(const FilesystemView& fs, const std::string& filename) {
+		auto is = fs.OpenInputStream(filename);
+		REQUIRE(is);
+		auto save = lcf::LSD_Reader::Load(is, "");
+		REQUIRE(save);
+		return save->title.hero_level;
+	}
+}
+
+TEST_CASE("WritesInOrder") {
+	auto fs = GetSaveFilesystem();
+	REQUIRE(fs);
+
+	std::vector<int> done;
+	for (int level = 1; level <= 3; ++level) {
+		SaveWriter::Write(fs, "Save01.lsd", MakeSave(level), lcf::EngineVersion::e2k, "", [&done, level](bool success) {
+			CHECK(success);
+			done.push_back(level);
+		});
+	}
+
+	SaveWriter::Wait();
+	CHECK(!SaveWriter::IsPending());
+	CHECK(done == std::vector<int>{1, 2, 3});
+
+	// The last write wins
+	fs.ClearCache();
+	CHECK(ReadLevel(fs, "Save01.lsd") == 3);
+	CHECK(!Platform::File(FileFinder::MakePath(save_dir, "Save01.lsd.tmp")).Exists());
+
+	Platform::File(FileFinder::MakePath(save_dir, "Save01.lsd")).Remove();
+}
+
+TEST_CASE("UpdateReportsFinishedWrites") {
+	auto fs = GetSaveFilesystem();
+	REQUIRE(fs);
+
+	bool done = false;
+	SaveWriter::Write(fs, "Save02.lsd", MakeSave(7), lcf::EngineVersion::e2k, "", [&done](bool) {
+		done = true;
+	});
+
+	// Reported on the main thread only
+	while (SaveWriter::IsPending()) {
+		SaveWriter::Update();
+	}
+	CHECK(done);
+
+	Platform::File(FileFinder::MakePath(save_dir, "Save02.lsd")).Remove();
+}
+
+TEST_CASE("FailureCallback") {
+	auto fs = GetSaveFilesystem();
+	REQUIRE(fs);
+
+	int calls = 0;
+	bool result = true;
+	SaveWriter::Write(fs, "!!!missing_dir/Save03.lsd", MakeSave(1), lcf::EngineVersion::e2k, "", [&](bool success) {
+		++calls;
+		result = success;
+	});
+
+	SaveWriter::Wait();
+	CHECK(calls == 1);
+	CHECK(!result);
+	CHECK(!Platform::File(FileFinder::MakePath(save_dir, "!!!missing_dir/Save03.lsd.tmp")).Exists());
+}
+
+TEST_SUITE_END();
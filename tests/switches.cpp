@@ -123,6 +123,74 @@ TEST_CASE("FlipRange") {
 	REQUIRE_FALSE(s.Get(n + 1));
 }
 
+TEST_CASE("CountRange") {
+	constexpr int n = max_switches * 2;
+	auto s = make();
+
+	REQUIRE_EQ(s.CountRange(1, n), 0);
+
+	s.SetRange(2, 4, true);
+	REQUIRE_EQ(s.CountRange(1, n), 3);
+	REQUIRE_EQ(s.CountRange(-1, 2), 1);
+	REQUIRE_EQ(s.CountRange(3, 3), 1);
+	REQUIRE_EQ(s.CountRange(5, n * 2), 0);
+	REQUIRE_EQ(s.CountRange(4, 2), 0);
+}
+
+TEST_CASE("RangeWordBoundaries") {
+	// Compare with a bit by bit reference for ranges that start and end in different words
+	constexpr int n = 200;
+	const int bounds[] = { -1, 1, 2, 63, 64, 65, 66, 127, 128, 129, 192, n };
+
+	for (int first: bounds) {
+		for (int last: bounds) {
+			auto s = make();
+			std::vector<bool> ref(n);
+
+			for (int i = 1; i <= n; i += 3) {
+				s.Set(i, true);
+				ref[i - 1] = true;
+			}
+
+			s.FlipRange(first, last);
+			for (int i = std::max(1, first); i <= last; ++i) {
+				ref[i - 1] = !ref[i - 1];
+			}
+
+			int count = 0;
+			for (int i = 1; i <= n; ++i) {
+				REQUIRE_EQ(s.Get(i), ref[i - 1]);
+				count += ref[i - 1];
+			}
+			REQUIRE_EQ(s.CountRange(1, n), count);
+
+			s.SetRange(first, last, false);
+			for (int i = std::max(1, first); i <= last; ++i) {
+				REQUIRE_FALSE(s.Get(i));
+			}
+		}
+	}
+}
+
+TEST_CASE("GetData") {
+	auto s = make();
+	Game_Switches::Switches_t data = { true, false, false, true, true };
+	data.resize(70, false);
+	data[68] = true;
+
+	s.SetData(data);
+	REQUIRE_EQ(s.GetSize(), 70);
+	REQUIRE(s.Get(1));
+	REQUIRE_FALSE(s.Get(2));
+	REQUIRE(s.Get(69));
+	REQUIRE_FALSE(s.Get(70));
+	REQUIRE(s.GetData() == data);
+
+	s.Set(75, false);
+	data.resize(75, false);
+	REQUIRE(s.GetData() == data);
+}
+
 TEST_CASE("GetSize") {
 	auto s = make();
 	REQUIRE_EQ(s.GetSizeWithLimit(), max_switches);
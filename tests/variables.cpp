@@ -555,6 +555,66 @@ TEST_CASE("Overflow/Underflow") {
 	REQUIRE(v.Get(1) == _min);
 }
 
+TEST_CASE("RangeMatchesScalar") {
+	// The range operations process multiple variables at once, compare with the single variable operations
+	lcf::Data::variables.resize(max_vars);
+
+	constexpr auto _min = std::numeric_limits<Game_Variables::Var_t>::min();
+	constexpr auto _max = std::numeric_limits<Game_Variables::Var_t>::max();
+	constexpr int n = 37;
+	const Game_Variables::Var_t operands[] = { 0, 1, -1, 7, -13, 999999, -9999999, _max, _min };
+
+	using RangeFn = void (Game_Variables::*)(int, int, Game_Variables::Var_t);
+	using ScalarFn = Game_Variables::Var_t (Game_Variables::*)(int, Game_Variables::Var_t);
+
+	auto check = [&](Game_Variables::Var_t lo, Game_Variables::Var_t hi, RangeFn range_fn, ScalarFn scalar_fn, bool non_negative, auto&& is_valid_operand) {
+		for (auto operand: operands) {
+			if (!is_valid_operand(operand)) {
+				continue;
+			}
+
+			Game_Variables range(lo, hi);
+			Game_Variables scalar(lo, hi);
+			range.SetWarning(0);
+			scalar.SetWarning(0);
+
+			for (int i = 1; i <= n; ++i) {
+				auto value = non_negative ? i * 12345 : operands[i % std::size(operands)] ^ (i % 3);
+				range.Set(i, value);
+				scalar.Set(i, value);
+			}
+
+			(range.*range_fn)(2, n - 1, operand);
+			for (int i = 2; i <= n - 1; ++i) {
+				(scalar.*scalar_fn)(i, operand);
+			}
+
+			for (int i = 1; i <= n; ++i) {
+				INFO("operand ", operand, " var ", i);
+				REQUIRE_EQ(range.Get(i), scalar.Get(i));
+			}
+		}
+	};
+
+	auto any = [](Game_Variables::Var_t) { return true; };
+	auto divisor = [](Game_Variables::Var_t d) { return d != -1; };
+	auto shift = [](Game_Variables::Var_t d) { return d >= 0 && d < 32; };
+
+	for (auto [lo, hi]: { std::make_pair(minval, maxval), std::make_pair(_min, _max) }) {
+		check(lo, hi, &Game_Variables::SetRange, &Game_Variables::Set, false, any);
+		check(lo, hi, &Game_Variables::AddRange, &Game_Variables::Add, false, any);
+		check(lo, hi, &Game_Variables::SubRange, &Game_Variables::Sub, false, any);
+		check(lo, hi, &Game_Variables::MultRange, &Game_Variables::Mult, false, any);
+		check(lo, hi, &Game_Variables::DivRange, &Game_Variables::Div, false, divisor);
+		check(lo, hi, &Game_Variables::ModRange, &Game_Variables::Mod, false, divisor);
+		check(lo, hi, &Game_Variables::BitOrRange, &Game_Variables::BitOr, false, any);
+		check(lo, hi, &Game_Variables::BitAndRange, &Game_Variables::BitAnd, false, any);
+		check(lo, hi, &Game_Variables::BitXorRange, &Game_Variables::BitXor, false, any);
+		check(lo, hi, &Game_Variables::BitShiftLeftRange, &Game_Variables::BitShiftLeft, true, shift);
+		check(lo, hi, &Game_Variables::BitShiftRightRange, &Game_Variables::BitShiftRight, false, shift);
+	}
+}
+
 TEST_CASE("Enumerate") {
 	auto s = make();
 
@@ -0,0 +1,42 @@
+#include "worker_pool.h"
+#include "doctest.h"
+#include <atomic>
+#include <future>
+#include <vector>
+
+TEST_SUITE_BEGIN("WorkerPool");
+
+TEST_CASE("Synchronous") {
+	WorkerPool pool(0);
+	REQUIRE_EQ(pool.GetNumThreads(), 0);
+
+	int value = 0;
+	pool.Submit([&]() { value = 1; });
+	REQUIRE_EQ(value, 1);
+}
+
+TEST_CASE("Threads") {
+	std::atomic<int> counter = 0;
+	std::vector<std::future<int>> results;
+	{
+		WorkerPool pool(3);
+		REQUIRE_EQ(pool.GetNumThreads(), 3);
+
+		for (int i = 0; i < 100; ++i) {
+			auto task = std::make_shared<std::packaged_task<int()>>([i, &counter]() {
+				++counter;
+				return i * 2;
+			});
+			results.push_back(task->get_future());
+			pool.Submit([task]() { (*task)(); });
+		}
+
+		REQUIRE_EQ(results[50].get(), 100);
+	}
+
+	// The destructor finishes the queue
+	REQUIRE_EQ(counter.load(), 100);
+	REQUIRE_EQ(results[99].get(), 198);
+}
+
+TEST_SUITE_END();